@@ -0,0 +1,81 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/maya/ALHalf.h"
+
+namespace AL {
+namespace maya {
+
+/// defined in ALHalfF16C.cpp, which is compiled with -mf16c
+const HalfConversionKernels* f16cHalfConversionKernels();
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+template<typename S, typename D, uint32_t N>
+void convert(const S* const input, D* const out)
+{
+  for(uint32_t i = 0; i < N; ++i)
+  {
+    out[i] = D(float(input[i]));
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+constexpr HalfConversionKernels g_scalarHalfConversionKernels =
+{
+  convert<GfHalf, float, 8>,
+  convert<GfHalf, float, 4>,
+  convert<GfHalf, double, 8>,
+  convert<GfHalf, double, 4>,
+  convert<float, GfHalf, 8>,
+  convert<float, GfHalf, 4>,
+  convert<double, GfHalf, 8>,
+  convert<double, GfHalf, 4>
+};
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+HalfConversionKernels g_halfConversionKernels = g_scalarHalfConversionKernels;
+
+//----------------------------------------------------------------------------------------------------------------------
+const HalfConversionKernels* halfConversionKernels(SimdLevel level)
+{
+  switch(level)
+  {
+  case SimdLevel::kScalar: return &g_scalarHalfConversionKernels;
+  case SimdLevel::kAVX2: return f16cHalfConversionKernels();
+  default: break;
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+SimdLevel bindHalfConversionKernels(SimdLevel maxLevel)
+{
+  const CpuFeatures& features = hostCpuFeatures();
+  const HalfConversionKernels* kernels = halfConversionKernels(SimdLevel::kAVX2);
+  if(maxLevel >= SimdLevel::kAVX2 && features.avx && features.f16c && kernels)
+  {
+    g_halfConversionKernels = *kernels;
+    return SimdLevel::kAVX2;
+  }
+  g_halfConversionKernels = g_scalarHalfConversionKernels;
+  return SimdLevel::kScalar;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // maya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -20,35 +20,71 @@
 ///         The Intel Ivy Bridge CPUs actually implemented float <-> conversions in hardware via the vcvtps2ph and
 ///         vcvtph2ps instructions (which convert 8 floats at a time with a latency of 4 or 5 cycles). This header file
 ///         provides some methods to convert between half/float and half/double using the F16C conversion intrinsics.
-///         To enable HW conversions, pass the compiler flag -mf16c to clang or gcc.
+///         If the whole plugin is compiled with -mf16c, the F16C conversions are inlined directly. Otherwise the
+///         8 and 4 wide conversions are dispatched through a table, which is bound to the F16C implementations at
+///         plugin load if the host CPU supports them (see bindHalfConversionKernels).
 //----------------------------------------------------------------------------------------------------------------------
 
 #pragma once
 #if __F16C__
 #include <immintrin.h>
 #endif
+#include "AL/maya/CpuFeatures.h"
 #include "pxr/base/gf/half.h"
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
 namespace AL {
 namespace maya {
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The table of the 8 and 4 wide conversions, through which the conversions are dispatched when the plugin
+///         has not been compiled with F16C support.
+//----------------------------------------------------------------------------------------------------------------------
+struct HalfConversionKernels
+{
+  void (*half2float_8f)(const GfHalf input[8], float out[8]);
+  void (*half2float_4f)(const GfHalf input[4], float out[4]);
+  void (*half2double_8f)(const GfHalf input[8], double out[8]);
+  void (*half2double_4f)(const GfHalf input[4], double out[4]);
+  void (*float2half_8f)(const float input[8], GfHalf out[8]);
+  void (*float2half_4f)(const float input[4], GfHalf out[4]);
+  void (*double2half_8f)(const double input[8], GfHalf out[8]);
+  void (*double2half_4f)(const double input[4], GfHalf out[4]);
+};
+
+/// the conversions currently in use. Defaults to the scalar implementations until bindHalfConversionKernels is called.
+extern HalfConversionKernels g_halfConversionKernels;
+
+/// \brief  returns the conversions compiled for the specified SIMD level
+/// \param  level the SIMD level. The F16C conversions are returned for SimdLevel::kAVX2.
+/// \return the conversions, or nullptr if none were compiled for that level
+const HalfConversionKernels* halfConversionKernels(SimdLevel level);
+
+/// \brief  binds the F16C conversions if the host CPU supports them, and maxLevel allows it. Otherwise the scalar
+///         conversions are bound.
+/// \param  maxLevel the widest SIMD level that may be bound
+/// \return the SIMD level of the conversions that were bound
+SimdLevel bindHalfConversionKernels(SimdLevel maxLevel = SimdLevel::kAVX2);
+
 #if __F16C__
 
 /// converts 8xhalf to 8xfloat
-inline void half2float_8f(const GfHalf input[8], float out[8])
+static inline void half2float_8f(const GfHalf input[8], float out[8])
 {
   const __m128i a = _mm_loadu_si128((const __m128i*)input);
   _mm256_storeu_ps(out, _mm256_cvtph_ps(a));
 }
 
 /// converts 4xhalf to 4xfloat
-inline void half2float_4f(const GfHalf input[4], float out[4])
+static inline void half2float_4f(const GfHalf input[4], float out[4])
 {
   const __m128i a = _mm_castpd_si128(_mm_load_sd((const double*)input));
   _mm_storeu_ps(out, _mm_cvtph_ps(a));
 }
 
 /// converts a half to a float
-inline float half2float_1f(const GfHalf h)
+static inline float half2float_1f(const GfHalf h)
 {
   const __m128i a = _mm_set1_epi32(uint32_t(h.bits()) << 16 | h.bits());
   const __m128 f = _mm_cvtph_ps(a);
@@ -58,7 +94,7 @@ inline float half2float_1f(const GfHalf h)
 }
 
 /// converts 8xhalf to 8xfloat
-inline void half2double_8f(const GfHalf input[8], double out[8])
+static inline void half2double_8f(const GfHalf input[8], double out[8])
 {
   const __m128i a = _mm_loadu_si128((const __m128i*)input);
   const __m256 f = _mm256_cvtph_ps(a);
@@ -69,14 +105,14 @@ inline void half2double_8f(const GfHalf input[8], double out[8])
 }
 
 /// converts 4xhalf to 4xfloat
-inline void half2double_4f(const GfHalf input[4], double out[4])
+static inline void half2double_4f(const GfHalf input[4], double out[4])
 {
   const __m128i a = _mm_castpd_si128(_mm_load_sd((const double*)input));
   _mm256_storeu_pd(out, _mm256_cvtps_pd(_mm_cvtph_ps(a)));
 }
 
 /// converts a half to a float
-inline double half2double_1f(const GfHalf h)
+static inline double half2double_1f(const GfHalf h)
 {
   const __m128i a = _mm_set1_epi32(uint32_t(h.bits()) << 16 | h.bits());
   const __m128 f = _mm_cvtph_ps(a);
@@ -86,21 +122,21 @@ inline double half2double_1f(const GfHalf h)
 }
 
 /// converts 8xfloat to 8xhalf
-inline void float2half_8f(const float input[8], GfHalf out[8])
+static inline void float2half_8f(const float input[8], GfHalf out[8])
 {
   const __m256 a = _mm256_loadu_ps(input);
   _mm_storeu_si128((__m128i*)out, _mm256_cvtps_ph(a, _MM_FROUND_CUR_DIRECTION));
 }
 
 /// converts 4xfloat to 4xhalf
-inline void float2half_4f(const float input[4], GfHalf out[4])
+static inline void float2half_4f(const float input[4], GfHalf out[4])
 {
   const __m128 a = _mm_loadu_ps(input);
   _mm_store_sd((double*)out, _mm_castsi128_pd(_mm_cvtps_ph(a, _MM_FROUND_CUR_DIRECTION)));
 }
 
 /// converts a float to a half
-inline GfHalf float2half_1f(const float f)
+static inline GfHalf float2half_1f(const float f)
 {
   const __m128 a = _mm_load_ss(&f);
   const __m128i b = _mm_cvtps_ph(a, _MM_FROUND_CUR_DIRECTION);
@@ -109,7 +145,7 @@ inline GfHalf float2half_1f(const float f)
 }
 
 /// converts 8xdouble to 8xhalf
-inline void double2half_8f(const double input[8], GfHalf out[8])
+static inline void double2half_8f(const double input[8], GfHalf out[8])
 {
   const __m256d alo = _mm256_loadu_pd(input);
   const __m256d ahi = _mm256_loadu_pd(input + 4);
@@ -121,14 +157,14 @@ inline void double2half_8f(const double input[8], GfHalf out[8])
 }
 
 /// converts 4xdouble to 4xhalf
-inline void double2half_4f(const double input[4], GfHalf out[4])
+static inline void double2half_4f(const double input[4], GfHalf out[4])
 {
   const __m128 a = _mm256_cvtpd_ps(_mm256_loadu_pd(input));
   _mm_store_sd((double*)out, _mm_castsi128_pd(_mm_cvtps_ph(a, _MM_FROUND_CUR_DIRECTION)));
 }
 
 /// converts a double to a half
-inline GfHalf double2half_1f(const double f)
+static inline GfHalf double2half_1f(const double f)
 {
   const __m128d d = _mm_load_sd(&f);
   const __m128 a = _mm_cvtpd_ps(d);
@@ -138,114 +174,36 @@ inline GfHalf double2half_1f(const double f)
 }
 
 #else
-/// converts 8xhalf to 8xfloat
-inline void half2float_8f(const GfHalf input[8], float out[8])
-{
-  out[0] = float(input[0]);
-  out[1] = float(input[1]);
-  out[2] = float(input[2]);
-  out[3] = float(input[3]);
-  out[4] = float(input[4]);
-  out[5] = float(input[5]);
-  out[6] = float(input[6]);
-  out[7] = float(input[7]);
-}
 
-/// converts 4xhalf to 4xfloat
-inline void half2float_4f(const GfHalf input[4], float out[4])
-{
-  out[0] = float(input[0]);
-  out[1] = float(input[1]);
-  out[2] = float(input[2]);
-  out[3] = float(input[3]);
-}
+static inline void half2float_8f(const GfHalf input[8], float out[8]) { g_halfConversionKernels.half2float_8f(input, out); }
+static inline void half2float_4f(const GfHalf input[4], float out[4]) { g_halfConversionKernels.half2float_4f(input, out); }
+static inline void half2double_8f(const GfHalf input[8], double out[8]) { g_halfConversionKernels.half2double_8f(input, out); }
+static inline void half2double_4f(const GfHalf input[4], double out[4]) { g_halfConversionKernels.half2double_4f(input, out); }
+static inline void float2half_8f(const float input[8], GfHalf out[8]) { g_halfConversionKernels.float2half_8f(input, out); }
+static inline void float2half_4f(const float input[4], GfHalf out[4]) { g_halfConversionKernels.float2half_4f(input, out); }
+static inline void double2half_8f(const double input[8], GfHalf out[8]) { g_halfConversionKernels.double2half_8f(input, out); }
+static inline void double2half_4f(const double input[4], GfHalf out[4]) { g_halfConversionKernels.double2half_4f(input, out); }
 
 /// convert half to float
-inline float half2float_1f(const GfHalf h)
+static inline float half2float_1f(const GfHalf h)
 {
   return float(h);
 }
 
-/// converts 8xhalf to 8xfloat
-inline void half2double_8f(const GfHalf input[8], double out[8])
-{
-  out[0] = double(float(input[0]));
-  out[1] = double(float(input[1]));
-  out[2] = double(float(input[2]));
-  out[3] = double(float(input[3]));
-  out[4] = double(float(input[4]));
-  out[5] = double(float(input[5]));
-  out[6] = double(float(input[6]));
-  out[7] = double(float(input[7]));
-}
-
-/// converts 4xhalf to 4xfloat
-inline void half2double_4f(const GfHalf input[4], double out[4])
-{
-  out[0] = double(float(input[0]));
-  out[1] = double(float(input[1]));
-  out[2] = double(float(input[2]));
-  out[3] = double(float(input[3]));
-}
-
-/// convert half to float
-inline double half2fdouble_1f(const GfHalf h)
+/// convert half to double
+static inline double half2double_1f(const GfHalf h)
 {
   return double(float(h));
 }
 
-/// converts 8xfloat to 8xhalf
-inline void float2half_8f(const float input[8], GfHalf out[8])
-{
-  out[0] = GfHalf(input[0]);
-  out[1] = GfHalf(input[1]);
-  out[2] = GfHalf(input[2]);
-  out[3] = GfHalf(input[3]);
-  out[4] = GfHalf(input[4]);
-  out[5] = GfHalf(input[5]);
-  out[6] = GfHalf(input[6]);
-  out[7] = GfHalf(input[7]);
-}
-
-/// converts 4xfloat to 4xhalf
-inline void float2half_4f(const float input[4], GfHalf out[4])
-{
-  out[0] = GfHalf(input[0]);
-  out[1] = GfHalf(input[1]);
-  out[2] = GfHalf(input[2]);
-  out[3] = GfHalf(input[3]);
-}
-
 /// converts a float to a half
-inline GfHalf float2half_1f(const float f)
+static inline GfHalf float2half_1f(const float f)
 {
   return GfHalf(f);
 }
 
-/// converts 8xdouble to 8xhalf
-inline void double2half_8f(const double input[8], GfHalf out[8])
-{
-  out[0] = GfHalf(float(input[0]));
-  out[1] = GfHalf(float(input[1]));
-  out[2] = GfHalf(float(input[2]));
-  out[3] = GfHalf(float(input[3]));
-  out[4] = GfHalf(float(input[4]));
-  out[5] = GfHalf(float(input[5]));
-  out[6] = GfHalf(float(input[6]));
-  out[7] = GfHalf(float(input[7]));
-}
-
-/// converts 4xdouble to 4xhalf
-inline void double2half_4f(const double input[4], GfHalf out[4])
-{
-  out[0] = GfHalf(float(input[0]));
-  out[1] = GfHalf(float(input[1]));
-  out[2] = GfHalf(float(input[2]));
-  out[3] = GfHalf(float(input[3]));
-}
-
 /// converts a double to a half
-inline GfHalf double2half_1f(const double f)
+static inline GfHalf double2half_1f(const double f)
 {
   return GfHalf(float(f));
 }
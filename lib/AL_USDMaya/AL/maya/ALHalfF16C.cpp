@@ -0,0 +1,53 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is compiled with -mavx -mf16c, and must only be called into once the host CPU has been checked for support.
+//
+#include "AL/maya/ALHalf.h"
+
+namespace AL {
+namespace maya {
+
+#if __F16C__
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+const HalfConversionKernels g_f16cHalfConversionKernels =
+{
+  half2float_8f,
+  half2float_4f,
+  half2double_8f,
+  half2double_4f,
+  float2half_8f,
+  float2half_4f,
+  double2half_8f,
+  double2half_4f
+};
+} // anon
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+const HalfConversionKernels* f16cHalfConversionKernels()
+{
+#if __F16C__
+  return &g_f16cHalfConversionKernels;
+#else
+  return nullptr;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // maya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
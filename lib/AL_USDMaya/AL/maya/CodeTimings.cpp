@@ -16,137 +16,472 @@
 #include "AL/maya/CodeTimings.h"
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <limits>
+#include <cassert>
+#include <fstream>
+#include <iomanip>
+#include <thread>
 
 namespace AL {
 namespace maya {
+namespace {
 //----------------------------------------------------------------------------------------------------------------------
-Profiler::ProfilerSectionStackNode Profiler::m_timeStack[MAX_TIMESTAMP_STACK_SIZE];
-int32_t Profiler::m_stackPos = 0;
-Profiler::ProfilerSectionPathLUT Profiler::m_map;
+/// \brief  returns the current time of the monotonic clock, in nanoseconds
+inline uint64_t timeNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 //----------------------------------------------------------------------------------------------------------------------
-inline bool Profiler::compareTimeStamps(const iter_t a, const iter_t b)
+/// \brief  The counters in a PathNode only ever have a single writer (the thread that owns it), so they can be updated
+///         without any read-modify-write atomics.
+inline void increment(std::atomic<uint64_t>& value, const uint64_t delta)
 {
-  if(a->second.tv_sec > b->second.tv_sec) return true;
-  if(a->second.tv_sec < b->second.tv_sec) return false;
-  return a->second.tv_nsec > b->second.tv_nsec;
+  value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
 }
 
-#define INDENT for(uint32_t i = 0; i < indent; ++i) os << "  ";
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A node in the section tree of a single thread. The node is only ever modified by the thread that owns it,
+///         however the report may read the counters (and walk the child list) from another thread.
+//----------------------------------------------------------------------------------------------------------------------
+struct Profiler::PathNode
+{
+  PathNode(const ProfilerSectionTag* tag, PathNode* parent)
+    : m_tag(tag), m_nextSibling(parent ? parent->m_firstChild.load(std::memory_order_relaxed) : nullptr)
+    {}
+
+  void reset()
+  {
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_self.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+  }
+
+  const ProfilerSectionTag* const m_tag; ///< the section this node represents
+  PathNode* const m_nextSibling; ///< the next child of the parent section
+  std::atomic<PathNode*> m_firstChild { nullptr }; ///< head of the list of child sections
+  std::atomic<uint64_t> m_count { 0 }; ///< number of times the section has been timed
+  std::atomic<uint64_t> m_total { 0 }; ///< total time spent in this section (nanoseconds)
+  std::atomic<uint64_t> m_self { 0 }; ///< time spent in this section, excluding child sections (nanoseconds)
+  std::atomic<uint64_t> m_min { std::numeric_limits<uint64_t>::max() }; ///< shortest time spent in the section
+  std::atomic<uint64_t> m_max { 0 }; ///< longest time spent in the section
+};
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::print(std::ostream& os, iter_t it, const ProfilerSectionPathLUT& lut, uint32_t indent, double total)
+/// \brief  A completed section, recorded while tracing.
+//----------------------------------------------------------------------------------------------------------------------
+struct Profiler::TraceEvent
 {
-  const ProfilerSectionPath& hp = it->first;
-  const ProfilerSectionTag& he = *hp.m_top;
+  const ProfilerSectionTag* m_tag;
+  uint64_t m_start;
+  uint64_t m_end;
+  const char* m_argumentName;
+  std::string m_argumentValue;
+};
 
-  double timeTaken = (it->second.tv_sec * 1000.0f + it->second.tv_nsec * 0.000001f);
-  double percentage = timeTaken / total;
-  percentage = int(10000.0 * percentage) * 0.01;
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The timing state for a single thread.
+//----------------------------------------------------------------------------------------------------------------------
+struct Profiler::ThreadState
+{
+  struct StackNode
+  {
+    PathNode* m_path;
+    uint64_t m_start;
+    uint64_t m_children;
+    const char* m_argumentName;
+    std::string m_argumentValue;
+  };
 
-  INDENT;
-  if(timeTaken > 20000.0)
+  ThreadState(const uint64_t generation, const uint32_t threadId)
+    : m_root(nullptr, nullptr), m_generation(generation), m_threadId(threadId)
+    { m_stack.reserve(32); }
+
+  PathNode* findOrAddChild(PathNode* parent, const ProfilerSectionTag* tag)
   {
-    os << "[" << percentage << "%](" << (timeTaken * 0.001) << "S) " << he.m_sectionName << std::endl;
+    for(PathNode* child = parent->m_firstChild.load(std::memory_order_relaxed); child; child = child->m_nextSibling)
+    {
+      if(child->m_tag == tag)
+        return child;
+    }
+    m_nodes.emplace_back(new PathNode(tag, parent));
+    PathNode* child = m_nodes.back().get();
+    parent->m_firstChild.store(child, std::memory_order_release);
+    return child;
   }
-  else
+
+  void reset()
   {
-    os << "[" << percentage << "%](" << timeTaken << "ms) " << he.m_sectionName << std::endl;
+    for(auto& node : m_nodes)
+      node->reset();
   }
 
-  std::vector<iter_t> sorted;
-  for(auto a = lut.begin(), e = lut.end(); a != e; ++a)
+  PathNode m_root; ///< sentinel, the children of which are the top level sections
+  std::vector<StackNode> m_stack; ///< the sections the thread is currently within
+  std::vector<std::unique_ptr<PathNode> > m_nodes; ///< storage for all nodes in the tree
+  std::atomic<uint64_t> m_generation; ///< the value of Profiler::m_generation when the timings were last cleared
+  const uint32_t m_threadId; ///< the id used for this thread in the trace
+  std::atomic<bool> m_recording { false }; ///< true while the thread may be appending to m_traceEvents
+  std::vector<TraceEvent> m_traceEvents; ///< the sections completed by this thread since the trace was started
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A node in the merged tree used to generate the report
+//----------------------------------------------------------------------------------------------------------------------
+struct Profiler::ReportNode
+{
+  const ProfilerSectionTag* m_tag = nullptr;
+  uint64_t m_count = 0;
+  uint64_t m_total = 0;
+  uint64_t m_self = 0;
+  uint64_t m_min = std::numeric_limits<uint64_t>::max();
+  uint64_t m_max = 0;
+  std::unordered_map<const ProfilerSectionTag*, std::unique_ptr<ReportNode> > m_children;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+std::mutex Profiler::m_lock;
+std::vector<Profiler::ThreadState*> Profiler::m_threads;
+std::atomic<uint64_t> Profiler::m_generation(0);
+std::atomic<bool> Profiler::m_tracing(false);
+uint64_t Profiler::m_traceStart = 0;
+
+//----------------------------------------------------------------------------------------------------------------------
+Profiler::ThreadState& Profiler::threadState()
+{
+  // The thread states are intentionally never deleted, so that timings gathered by worker threads that have since
+  // exited still show up in the report.
+  static thread_local ThreadState* state = nullptr;
+  if(!state)
   {
-    if(a->first.m_parent == &hp)
+    std::lock_guard<std::mutex> lock(m_lock);
+    state = new ThreadState(m_generation.load(std::memory_order_acquire), uint32_t(m_threads.size() + 1));
+    m_threads.push_back(state);
+  }
+  return *state;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::merge(ReportNode& dst, const PathNode& src)
+{
+  for(const PathNode* child = src.m_firstChild.load(std::memory_order_acquire); child; child = child->m_nextSibling)
+  {
+    std::unique_ptr<ReportNode>& node = dst.m_children[child->m_tag];
+    if(!node)
     {
-      sorted.push_back(a);
+      node.reset(new ReportNode);
+      node->m_tag = child->m_tag;
     }
+    node->m_count += child->m_count.load(std::memory_order_relaxed);
+    node->m_total += child->m_total.load(std::memory_order_relaxed);
+    node->m_self += child->m_self.load(std::memory_order_relaxed);
+    node->m_min = std::min(node->m_min, child->m_min.load(std::memory_order_relaxed));
+    node->m_max = std::max(node->m_max, child->m_max.load(std::memory_order_relaxed));
+    merge(*node, *child);
   }
-  std::sort(sorted.begin(), sorted.end(), compareTimeStamps);
+}
 
-  for(auto a = sorted.begin(), e = sorted.end(); a != e; ++a)
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+void printTime(std::ostream& os, const uint64_t nanoseconds)
+{
+  const double timeTaken = nanoseconds * 1e-6;
+  if(timeTaken > 20000.0)
   {
-    print(os, *a, lut, indent + 1, total);
+    os << (timeTaken * 0.001) << "S";
+  }
+  else
+  {
+    os << timeTaken << "ms";
+  }
+}
+}
+
+#define INDENT for(uint32_t i = 0; i < indent; ++i) os << "  ";
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::print(std::ostream& os, const ReportNode& node, uint32_t indent, double total)
+{
+  double percentage = total > 0 ? node.m_total / total : 0;
+  percentage = int(10000.0 * percentage) * 0.01;
+
+  INDENT;
+  os << "[" << percentage << "%](";
+  printTime(os, node.m_total);
+  os << ") " << node.m_tag->m_sectionName << " calls:" << node.m_count << " self:";
+  printTime(os, node.m_self);
+  if(node.m_count)
+  {
+    os << " min:";
+    printTime(os, node.m_min);
+    os << " mean:";
+    printTime(os, node.m_total / node.m_count);
+    os << " max:";
+    printTime(os, node.m_max);
+  }
+  os << std::endl;
+
+  std::vector<const ReportNode*> sorted;
+  sorted.reserve(node.m_children.size());
+  for(auto& child : node.m_children)
+  {
+    sorted.push_back(child.second.get());
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const ReportNode* a, const ReportNode* b) { return a->m_total > b->m_total; });
+
+  for(auto child : sorted)
+  {
+    print(os, *child, indent + 1, total);
   }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 void Profiler::printReport(std::ostream& os)
 {
-  double total = 0;
-  std::vector<iter_t> sorted;
-  for(auto a = m_map.begin(), e = m_map.end(); a != e; ++a)
+  std::lock_guard<std::mutex> lock(m_lock);
+
+  // merge the section trees of each thread. Threads that have not started a section since the timings were last
+  // cleared still hold stale values, so skip them.
+  const uint64_t generation = m_generation.load(std::memory_order_acquire);
+  ReportNode root;
+  for(auto thread : m_threads)
   {
-    if(!a->first.m_parent)
+    if(thread->m_generation.load(std::memory_order_acquire) == generation)
     {
-      total += (a->second.tv_sec * 1000.0f + a->second.tv_nsec * 0.000001f);
-      sorted.push_back(a);
+      merge(root, thread->m_root);
     }
   }
-  std::sort(sorted.begin(), sorted.end(), compareTimeStamps);
 
-  for(auto a = sorted.begin(), e = sorted.end(); a != e; ++a)
+  double total = 0;
+  std::vector<const ReportNode*> sorted;
+  sorted.reserve(root.m_children.size());
+  for(auto& child : root.m_children)
+  {
+    total += child.second->m_total;
+    sorted.push_back(child.second.get());
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const ReportNode* a, const ReportNode* b) { return a->m_total > b->m_total; });
+
+  for(auto child : sorted)
   {
-    print(os, *a, m_map, 0, total);
+    print(os, *child, 0, total);
   }
 
-  clearAll();
+  m_generation.fetch_add(1, std::memory_order_release);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::pushTime(const ProfilerSectionTag* entry)
+void Profiler::clearAll()
 {
-  assert(MAX_TIMESTAMP_STACK_SIZE > m_stackPos);
-  m_timeStack[m_stackPos].m_entry = entry;
-  while(clock_gettime(CLOCK_REALTIME_COARSE, &m_timeStack[m_stackPos].m_time) != 0) /* deliberately empty */;
+  std::lock_guard<std::mutex> lock(m_lock);
+  m_generation.fetch_add(1, std::memory_order_release);
+}
 
-  const timespec null_ts = {0, 0};
-  if(m_stackPos)
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::pushTime(const ProfilerSectionTag* entry)
+{
+  ThreadState& state = threadState();
+  PathNode* parent = &state.m_root;
+  if(state.m_stack.empty())
   {
-    auto parent = m_timeStack[m_stackPos - 1].m_path;
-    ProfilerSectionPath path(entry, &parent->first);
-    auto it = m_map.find(path);
-    if(it != m_map.end())
+    // the timings can only be safely cleared by this thread, and only when it isn't within a section.
+    const uint64_t generation = m_generation.load(std::memory_order_acquire);
+    if(generation != state.m_generation.load(std::memory_order_relaxed))
     {
-      m_timeStack[m_stackPos].m_path = it;
-    }
-    else
-    {
-      m_map.insert(std::make_pair(path, null_ts));
-      m_timeStack[m_stackPos].m_path = m_map.find(path);
+      state.reset();
+      state.m_generation.store(generation, std::memory_order_release);
     }
   }
   else
   {
-    ProfilerSectionPath path(entry, 0);
-    auto it = m_map.find(path);
-    if(it != m_map.end())
+    parent = state.m_stack.back().m_path;
+  }
+
+  PathNode* const path = state.findOrAddChild(parent, entry);
+  state.m_stack.push_back({ path, 0, 0, nullptr, std::string() });
+  state.m_stack.back().m_start = timeNow();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::popTime()
+{
+  const uint64_t endTime = timeNow();
+  ThreadState& state = threadState();
+  assert(!state.m_stack.empty());
+  if(state.m_stack.empty())
+    return;
+
+  ThreadState::StackNode top = std::move(state.m_stack.back());
+  state.m_stack.pop_back();
+
+  const uint64_t elapsed = endTime - top.m_start;
+  PathNode* const path = top.m_path;
+  increment(path->m_count, 1);
+  increment(path->m_total, elapsed);
+  increment(path->m_self, elapsed > top.m_children ? elapsed - top.m_children : 0);
+  if(elapsed < path->m_min.load(std::memory_order_relaxed))
+    path->m_min.store(elapsed, std::memory_order_relaxed);
+  if(elapsed > path->m_max.load(std::memory_order_relaxed))
+    path->m_max.store(elapsed, std::memory_order_relaxed);
+
+  if(!state.m_stack.empty())
+  {
+    state.m_stack.back().m_children += elapsed;
+  }
+
+  if(m_tracing.load(std::memory_order_relaxed))
+  {
+    // The events are buffered by this thread alone, and only read once the trace has been stopped. Flagging that the
+    // thread is recording before checking that the trace is still running means stopTracing cannot miss a thread
+    // that is about to append an event.
+    state.m_recording.store(true);
+    if(m_tracing.load())
     {
-      m_timeStack[m_stackPos].m_path = it;
+      state.m_traceEvents.push_back({ top.m_path->m_tag, top.m_start, endTime, top.m_argumentName, std::move(top.m_argumentValue) });
     }
-    else
+    state.m_recording.store(false, std::memory_order_release);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::setSectionArgument(const char* name, std::string value)
+{
+  ThreadState& state = threadState();
+  assert(!state.m_stack.empty());
+  if(state.m_stack.empty())
+    return;
+  state.m_stack.back().m_argumentName = name;
+  state.m_stack.back().m_argumentValue = std::move(value);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::stopTracing()
+{
+  m_tracing.store(false);
+  for(auto thread : m_threads)
+  {
+    while(thread->m_recording.load(std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::beginTrace()
+{
+  std::lock_guard<std::mutex> lock(m_lock);
+  stopTracing();
+  for(auto thread : m_threads)
+  {
+    thread->m_traceEvents.clear();
+  }
+  m_traceStart = timeNow();
+  m_tracing.store(true);
+}
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+void writeJsonString(std::ostream& os, const std::string& str)
+{
+  os << '"';
+  for(const char c : str)
+  {
+    switch(c)
     {
-      m_map.insert(std::make_pair(path, null_ts));
-      m_timeStack[m_stackPos].m_path = m_map.find(path);
+    case '"': os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if(static_cast<unsigned char>(c) < 0x20)
+      {
+        os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+      }
+      else
+      {
+        os << c;
+      }
+      break;
     }
   }
+  os << '"';
+}
+}
 
-  ++m_stackPos;
+//----------------------------------------------------------------------------------------------------------------------
+bool Profiler::writeTrace(std::ostream& os)
+{
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  os << std::fixed << std::setprecision(3);
+  bool first = true;
+  for(auto thread : m_threads)
+  {
+    std::vector<TraceEvent> events;
+    events.swap(thread->m_traceEvents);
+
+    for(const TraceEvent& event : events)
+    {
+      // skip sections that were started before the trace was
+      if(event.m_start < m_traceStart)
+        continue;
+
+      os << (first ? "\n" : ",\n");
+      first = false;
+      os << "{\"name\":";
+      writeJsonString(os, event.m_tag->m_sectionName);
+      os << ",\"cat\":\"AL_USDMaya\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->m_threadId
+         << ",\"ts\":" << ((event.m_start - m_traceStart) * 1e-3)
+         << ",\"dur\":" << ((event.m_end - event.m_start) * 1e-3);
+      if(event.m_argumentName)
+      {
+        os << ",\"args\":{";
+        writeJsonString(os, event.m_argumentName);
+        os << ":";
+        writeJsonString(os, event.m_argumentValue);
+        os << "}";
+      }
+      os << "}";
+    }
+  }
+  os << "\n]}\n";
+  return bool(os);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::popTime()
+bool Profiler::endTrace(const std::string& filePath)
 {
-  assert(m_stackPos > 0);
-  --m_stackPos;
-  timespec endtime;
-  while(clock_gettime(CLOCK_REALTIME_COARSE, &endtime) != 0) /* deliberately empty */;
-  // compute time difference
-  timespec diff = timeDiff(m_timeStack[m_stackPos].m_time, endtime);
-  m_timeStack[m_stackPos].m_path->second = timeAdd(diff, m_timeStack[m_stackPos].m_path->second);
+  std::lock_guard<std::mutex> lock(m_lock);
+  if(!m_tracing.load())
+  {
+    return false;
+  }
+
+  // once every thread has stopped recording, their buffered events can be merged into the file
+  stopTracing();
+  if(filePath.empty())
+  {
+    for(auto thread : m_threads)
+    {
+      thread->m_traceEvents.clear();
+    }
+    return true;
+  }
+
+  std::ofstream os(filePath.c_str());
+  if(!os)
+  {
+    return false;
+  }
+  return writeTrace(os);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-} // usdmaya
+} // maya
 } // AL
 //----------------------------------------------------------------------------------------------------------------------
@@ -14,22 +14,16 @@
 // limitations under the License.
 //
 #pragma once
-#include <unordered_map>
 #include <string>
 #include <ostream>
-#include <ctime>
-#include <cassert>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
 
 namespace AL {
 namespace maya {
 
-
-//----------------------------------------------------------------------------------------------------------------------
-/// \ingroup  profiler
-/// a constant that determines the maximum possible depth of the timing
-//----------------------------------------------------------------------------------------------------------------------
-const uint32_t MAX_TIMESTAMP_STACK_SIZE = 16;
-
 //----------------------------------------------------------------------------------------------------------------------
 /// \ingroup  profilerprofiler
 /// \brief  This class provides a static hash that should be unique for a line within a specific function.
@@ -76,81 +70,15 @@ private:
 
 //----------------------------------------------------------------------------------------------------------------------
 /// \ingroup  profiler
-/// \brief  This class represents a path made up of ProfilerSectionTag's. It is used so that we can distinguish between
-///         identical code sections, accessed from alternative paths, e.g.
-/// \code
-/// void func1() {
-///   AL_BEGIN_PROFILE_SECTION(func1);
-///   AL_END_PROFILE_SECTION();
-/// }
-/// void func2() {
-///   AL_BEGIN_PROFILE_SECTION(func2);
-///   func1();
-///   AL_END_PROFILE_SECTION();
-/// }
-/// void func3() {
-///   AL_BEGIN_PROFILE_SECTION(func3);
-///   func1();
-///   AL_END_PROFILE_SECTION();
-/// }
-/// \endcode
-/// In this case, we can access func1 via two paths: |func2|func1, and |func3|func1
-//----------------------------------------------------------------------------------------------------------------------
-class ProfilerSectionPath
-{
-  friend class Profiler;
-public:
-
-  /// \brief  ctor
-  /// \param  top the top node on the profiling stack
-  /// \param  parent the parent path
-  inline ProfilerSectionPath(const ProfilerSectionTag* const top, const ProfilerSectionPath* const parent = 0)
-    : m_top(top), m_parent(parent), m_hash(m_top->hash() ^ (m_parent ? m_parent->hash() : 0))
-    {}
-
-  /// \brief  equality operator
-  /// \param  rhs the right hand side of the comparison
-  /// \return true if the paths are the same
-  inline bool operator == (const ProfilerSectionPath& rhs) const
-    { return (m_hash == rhs.m_hash && m_top == rhs.m_top && m_parent == rhs.m_parent); }
-
-  /// \brief  return the hash of this class
-  /// \return the hash of this class
-  inline size_t hash() const
-    { return m_hash;}
-
-private:
-  const ProfilerSectionTag* const m_top;
-  const ProfilerSectionPath* const m_parent;
-  const size_t m_hash;
-};
-} // maya
-} // AL
-
-//----------------------------------------------------------------------------------------------------------------------
-#ifndef AL_GENERATING_DOCS
-namespace std {
-template<> struct hash<AL::maya::ProfilerSectionTag> {
-  inline size_t operator()(const AL::maya::ProfilerSectionTag& k) const {
-    return k.hash();
-  }
-};
-template<> struct hash<AL::maya::ProfilerSectionPath> {
-  inline size_t operator()(const AL::maya::ProfilerSectionPath& k) const {
-    return k.hash();
-  }
-};
-} // std
-#endif
-
-//----------------------------------------------------------------------------------------------------------------------
-namespace AL {
-namespace maya {
-//----------------------------------------------------------------------------------------------------------------------
-/// \ingroup  profiler
-/// \brief  This class implements a very simple incode profiler. This profiler is NOT thread safe. It is mainly used to
-///         get some basic stats on the where the bottlenecks are during a file import/export operation. A simple example
-///         of usage:
+/// \brief  This class implements a simple hierarchical incode profiler. It is mainly used to get some basic stats on
+///         where the bottlenecks are during a file import/export operation. Timings are distinguished by the path of
+///         sections that lead to them, so the same code section reached via two different callers is reported twice,
+///         e.g. in the example below func1 is reported as both |func2|func1 and |func3|func1.
+///
+///         Each thread records into its own section tree using a monotonic high resolution clock, and without taking
+///         any locks. The per-thread trees are merged (by section path) when the report is generated, which lists the
+///         call count, total time, self time (total minus time spent in child sections), and the min/mean/max time of
+///         each section. A simple example of usage:
 /// \code
 /// void func1() {
 ///   AL_BEGIN_PROFILE_SECTION(func1);
@@ -179,21 +107,53 @@ namespace maya {
 ///   AL::maya::Profiler::printReport(std::cout);
 /// }
 /// \endcode
+///
+///         In addition to the report, the profiler can record a trace of every section that is executed (with its
+///         start/end times and thread), which can be written out as a Chrome trace JSON file, and viewed in
+///         chrome://tracing or Perfetto. A section can attach an argument (such as a prim path) to its trace event.
+/// \code
+/// AL::maya::Profiler::beginTrace();
+/// for(auto prim : prims) {
+///   AL_BEGIN_PROFILE_SECTION(ImportPrim);
+///   AL_PROFILE_SECTION_ARGUMENT(primPath, prim.GetPath().GetString());
+///   importPrim(prim);
+///   AL_END_PROFILE_SECTION();
+/// }
+/// AL::maya::Profiler::endTrace("/tmp/import.json");
+/// \endcode
 //----------------------------------------------------------------------------------------------------------------------
 class Profiler
 {
 public:
 
-  /// \brief  call to output the report
+  /// \brief  call to output the report. The timings of all threads are merged into a single report, after which the
+  ///         timings are cleared.
   /// \param  os the stream to write the report to
   static void printReport(std::ostream& os);
 
-  /// \brief  call to clear internal timers
-  static inline void clearAll()
-    {
-      assert(m_stackPos == 0);
-      m_map.clear();
-    }
+  /// \brief  call to clear internal timers. Threads that are currently within a profile section will discard their
+  ///         timings when they next start a top level section.
+  static void clearAll();
+
+  /// \brief  starts recording a trace of all profile sections (discarding any previously recorded trace)
+  static void beginTrace();
+
+  /// \brief  stops recording the trace, and writes it to the specified file in the Chrome trace event format. Each
+  ///         thread buffers its own events while the trace is recorded, and the buffers are merged here.
+  /// \param  filePath the file to write the trace to. If empty, the recorded trace is discarded.
+  /// \return true if the trace was written (or discarded), false if no trace was being recorded, or the file could
+  ///         not be written. Nothing is written if no trace was being recorded.
+  static bool endTrace(const std::string& filePath);
+
+  /// \brief  returns true if a trace is currently being recorded
+  /// \return true if recording a trace
+  static inline bool isTracing()
+    { return m_tracing.load(std::memory_order_relaxed); }
+
+  /// \brief  do not call directly. Use the AL_PROFILE_SECTION_ARGUMENT macro
+  /// \param  name the name of the argument
+  /// \param  value the value of the argument
+  static void setSectionArgument(const char* name, std::string value);
 
   /// \brief  do not call directly. Use the AL_BEGIN_PROFILE_SECTION macro
   /// \param  entry a unique tag for this code section.
@@ -203,48 +163,23 @@ public:
   static void popTime();
 
 private:
-
-  typedef std::unordered_map<ProfilerSectionPath, timespec> ProfilerSectionPathLUT;
-  typedef ProfilerSectionPathLUT::const_iterator iter_t;
-  static inline bool compareTimeStamps(const iter_t, const iter_t);
-  static void print(std::ostream& os, iter_t, const ProfilerSectionPathLUT&, uint32_t, double);
-
-  struct ProfilerSectionStackNode
-  {
-    timespec m_time;
-    const ProfilerSectionTag* m_entry;
-    ProfilerSectionPathLUT::iterator m_path;
-  };
-
-  static inline timespec timeDiff(const timespec startTime, const timespec endTime)
-  {
-    if (endTime.tv_nsec < startTime.tv_nsec)
-    {
-      return (timespec) {
-          tv_sec: endTime.tv_sec - 1 - startTime.tv_sec,
-          tv_nsec: 1000000000 + endTime.tv_nsec - startTime.tv_nsec
-        };
-    }
-    return (timespec) {
-        tv_sec: endTime.tv_sec - startTime.tv_sec,
-        tv_nsec: endTime.tv_nsec - startTime.tv_nsec
-      };
-  }
-  static inline timespec timeAdd(timespec t1, timespec t2)
-  {
-      int32_t sec = t2.tv_sec + t1.tv_sec;
-      int32_t nsec = t2.tv_nsec + t1.tv_nsec;
-      if (nsec >= 1000000000)
-      {
-          nsec -= 1000000000;
-          sec++;
-      }
-      return (timespec){ tv_sec: sec, tv_nsec: nsec };
-  }
-
-  static ProfilerSectionStackNode m_timeStack[MAX_TIMESTAMP_STACK_SIZE];
-  static int32_t m_stackPos;
-  static ProfilerSectionPathLUT m_map;
+  struct PathNode;
+  struct ThreadState;
+  struct ReportNode;
+
+  struct TraceEvent;
+
+  static ThreadState& threadState();
+  static void stopTracing();
+  static bool writeTrace(std::ostream& os);
+  static void merge(ReportNode& dst, const PathNode& src);
+  static void print(std::ostream& os, const ReportNode& node, uint32_t indent, double total);
+
+  static std::mutex m_lock; ///< guards the list of threads, and report generation
+  static std::vector<ThreadState*> m_threads; ///< the timings for each thread that has used the profiler
+  static std::atomic<uint64_t> m_generation; ///< incremented each time the timings are cleared
+  static std::atomic<bool> m_tracing; ///< true if trace events are being recorded
+  static uint64_t m_traceStart; ///< the time at which the current trace was started
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -265,4 +200,11 @@ private:
 #define AL_END_PROFILE_SECTION() \
   { AL::maya::Profiler::popTime(); }
 
-
+/// \ingroup  profiler
+/// Use this macro within a timed section of code to attach an argument (e.g. a prim path) to the section's trace event.
+/// The value is only evaluated when a trace is being recorded.
+#define AL_PROFILE_SECTION_ARGUMENT(Name, Value) \
+  { \
+    if(AL::maya::Profiler::isTracing()) \
+      AL::maya::Profiler::setSectionArgument(#Name, Value); \
+  }
@@ -83,19 +83,6 @@ class ProfilerSectionTag;
 } // maya
 } // AL
 
-// If you need to modify this file for some reason, you'll notice that I'm using some SSE and AVX2 intrinsics in this file.
-// If you're not comfortable with SIMD intrinsics, I apologize. The following macro will disable the intrinsics and fallback
-// to bog standard C++.
-#if !defined(AL_MAYA_ENABLE_SIMD)
-# define AL_MAYA_ENABLE_SIMD 1
-#endif
-
-// If neither of these are defined, don't use SIMD at all.
-#if !defined(__SSE3__) && !defined(__AVX2__)
-# undef AL_MAYA_ENABLE_SIMD
-# define AL_MAYA_ENABLE_SIMD 0
-#endif
-
 /// \brief  Given the status, validates that the status is ok. If not, an error is logged using the specified error
 ///         message. If an error occurs, the status is returned.
 /// \ingroup   mayautils
@@ -241,6 +228,20 @@ class ProfilerSectionTag;
     return status; \
   }}
 
+/// a macro to register an MPxDeformerNode derived node with maya
+/// \ingroup   mayautils
+#define AL_REGISTER_DEFORMER_NODE(plugin, X){ \
+  MStatus status = plugin.registerNode( \
+      X ::kTypeName, \
+      X ::kTypeId, \
+      X ::creator, \
+      X ::initialise, \
+      MPxNode::kDeformerNode); \
+  if(!status) { \
+    status.perror("unable to register deformer node " #X); \
+    return status; \
+  }}
+
 /// a macro to register an MPxShape derived node with maya
 /// \ingroup   mayautils
 #define AL_REGISTER_SHAPE_NODE(plugin, X, UI, DRAW){ \
@@ -0,0 +1,128 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/maya/CpuFeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# define AL_MAYA_X86 1
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#else
+# define AL_MAYA_X86 0
+#endif
+
+namespace AL {
+namespace maya {
+
+namespace {
+#if AL_MAYA_X86
+//----------------------------------------------------------------------------------------------------------------------
+void cpuid(uint32_t leaf, uint32_t subLeaf, uint32_t regs[4])
+{
+#ifdef _MSC_VER
+  __cpuidex((int*)regs, int(leaf), int(subLeaf));
+#else
+  __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t xgetbv()
+{
+#ifdef _MSC_VER
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (uint64_t(edx) << 32) | eax;
+#endif
+}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+CpuFeatures queryCpuFeatures()
+{
+  CpuFeatures features;
+#if AL_MAYA_X86
+  uint32_t regs[4];
+  cpuid(0, 0, regs);
+  const uint32_t maxLeaf = regs[0];
+  if(maxLeaf < 1)
+    return features;
+
+  cpuid(1, 0, regs);
+  const uint32_t ecx1 = regs[2];
+  features.sse3 = (ecx1 & (1U << 0)) != 0;
+  features.sse41 = (ecx1 & (1U << 19)) != 0;
+
+  // the AVX family of extensions can only be used if the OS saves the XMM and YMM state on a context switch
+  const bool osxsave = (ecx1 & (1U << 27)) != 0;
+  const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+  const bool ymmState = (xcr0 & 0x6) == 0x6;
+  const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+  features.avx = ymmState && (ecx1 & (1U << 28)) != 0;
+  features.fma = features.avx && (ecx1 & (1U << 12)) != 0;
+  features.f16c = features.avx && (ecx1 & (1U << 29)) != 0;
+
+  if(maxLeaf >= 7)
+  {
+    cpuid(7, 0, regs);
+    const uint32_t ebx7 = regs[1];
+    features.avx2 = features.avx && (ebx7 & (1U << 5)) != 0;
+    features.avx512f = zmmState && (ebx7 & (1U << 16)) != 0;
+  }
+#endif
+  return features;
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+const CpuFeatures& hostCpuFeatures()
+{
+  static const CpuFeatures features = queryCpuFeatures();
+  return features;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+SimdLevel hostSimdLevel()
+{
+  const CpuFeatures& features = hostCpuFeatures();
+  if(features.avx2 && features.fma && features.f16c)
+    return SimdLevel::kAVX2;
+  if(features.sse3)
+    return SimdLevel::kSSE3;
+  return SimdLevel::kScalar;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const char* simdLevelName(SimdLevel level)
+{
+  switch(level)
+  {
+  case SimdLevel::kScalar: return "scalar";
+  case SimdLevel::kSSE3: return "SSE3";
+  case SimdLevel::kAVX2: return "AVX2";
+  }
+  return "unknown";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // maya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
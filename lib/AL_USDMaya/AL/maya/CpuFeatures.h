@@ -0,0 +1,66 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+#include <cstdint>
+
+namespace AL {
+namespace maya {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The instruction sets the SIMD kernels within the plugin are compiled for. The plugin itself is built
+///         against the SSE3 baseline; wider implementations are compiled into their own translation units, and are
+///         only bound at runtime once the host CPU has been checked for support. The levels are ordered, such that a
+///         level implies support for all of the levels beneath it.
+//----------------------------------------------------------------------------------------------------------------------
+enum class SimdLevel : uint32_t
+{
+  kScalar, ///< plain C++
+  kSSE3, ///< SSE up to and including SSE3
+  kAVX2 ///< AVX2, FMA3 and F16C (Haswell onwards)
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The instruction set extensions supported by the host CPU (and operating system, in the case of the AVX
+///         extensions, which require the OS to preserve the YMM registers)
+//----------------------------------------------------------------------------------------------------------------------
+struct CpuFeatures
+{
+  bool sse3 = false;
+  bool sse41 = false;
+  bool avx = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool f16c = false;
+  bool avx512f = false;
+};
+
+/// \brief  returns the features supported by the host CPU. The CPU is only queried on the first call.
+/// \return the host CPU features
+const CpuFeatures& hostCpuFeatures();
+
+/// \brief  returns the widest of the SIMD levels that the host CPU is able to run
+/// \return the widest supported SIMD level
+SimdLevel hostSimdLevel();
+
+/// \brief  returns the name of the SIMD level, e.g. "AVX2"
+/// \param  level the SIMD level
+/// \return the name of the level
+const char* simdLevelName(SimdLevel level);
+
+//----------------------------------------------------------------------------------------------------------------------
+} // maya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -57,6 +57,7 @@ class ProxyShapeImportPrimPathAsMaya;
 class ProxyShapePostLoadProcess;
 class ProxyShapePrintRefCountState;
 class ProxyShapeRemoveAllTransforms;
+class ProxyShapeStreamPayloads;
 class TransformationMatrixToggleTimeSource;
 }
 
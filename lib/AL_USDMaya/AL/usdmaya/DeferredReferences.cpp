@@ -0,0 +1,389 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/maya/Common.h"
+#include "AL/usdmaya/DeferredReferences.h"
+
+#include "maya/MDagPath.h"
+#include "maya/MEventMessage.h"
+#include "maya/MFileIO.h"
+#include "maya/MFnDagNode.h"
+#include "maya/MFnReference.h"
+#include "maya/MGlobal.h"
+#include "maya/MNodeMessage.h"
+#include "maya/MObjectHandle.h"
+#include "maya/MPlug.h"
+#include "maya/MSceneMessage.h"
+#include "maya/MSelectionList.h"
+
+#include "pxr/base/arch/fileSystem.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace AL {
+namespace usdmaya {
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The deferred references, most recently used first
+//----------------------------------------------------------------------------------------------------------------------
+struct ReferenceTracker
+{
+  struct Entry
+  {
+    MObjectHandle transform;
+    MObjectHandle reference;
+    MCallbackId visibilityChanged;
+    size_t size;
+    bool loaded;
+    bool loadQueued;
+  };
+  typedef std::list<Entry>::iterator iterator;
+
+  iterator find(const MObject& transform)
+  {
+    MObjectHandle handle(transform);
+    auto range = lookup.equal_range(handle.hashCode());
+    for(auto it = range.first; it != range.second; ++it)
+    {
+      if(it->second->transform == handle)
+        return it->second;
+    }
+    return entries.end();
+  }
+
+  void erase(iterator it)
+  {
+    auto range = lookup.equal_range(it->transform.hashCode());
+    for(auto lit = range.first; lit != range.second; ++lit)
+    {
+      if(lit->second == it)
+      {
+        lookup.erase(lit);
+        break;
+      }
+    }
+    MNodeMessage::removeCallback(it->visibilityChanged);
+    if(it->loaded)
+      loadedSize -= it->size;
+    entries.erase(it);
+  }
+
+  void touch(iterator it)
+    { entries.splice(entries.begin(), entries, it); }
+
+  std::list<Entry> entries;
+  std::unordered_multimap<uint32_t, iterator> lookup;
+  size_t loadedSize = 0;
+  size_t budget = 0;
+  bool enabled = false;
+  MCallbackId selectionChanged = 0;
+  MCallbackId referenceLoaded = 0;
+  MCallbackId referenceUnloaded = 0;
+  bool changingReferences = false; ///< true while the tracker itself loads or unloads a reference
+  bool trimQueued = false;
+};
+
+ReferenceTracker g_tracker;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Loading a reference from within a selection or attribute callback is not safe, so the load is queued up
+///         to run when Maya is next idle.
+//----------------------------------------------------------------------------------------------------------------------
+void queueLoad(ReferenceTracker::iterator it)
+{
+  if(it->loaded || it->loadQueued || !it->transform.isValid())
+    return;
+  MFnDagNode fn(it->transform.object());
+  it->loadQueued = true;
+  MGlobal::executeCommandOnIdle(MString("AL_usdmaya_DeferredReference -l \"") + fn.fullPathName() + "\"");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void onSelectionChanged(void*)
+{
+  if(g_tracker.entries.empty())
+    return;
+
+  MSelectionList sl;
+  MGlobal::getActiveSelectionList(sl);
+  MDagPath path;
+  for(uint32_t i = 0, n = sl.length(); i < n; ++i)
+  {
+    if(!sl.getDagPath(i, path))
+      continue;
+
+    // the selection may be a node somewhere beneath the prim transform
+    for(; path.length(); path.pop())
+    {
+      auto it = g_tracker.find(path.node());
+      if(it != g_tracker.entries.end())
+      {
+        g_tracker.touch(it);
+        queueLoad(it);
+        break;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void onVisibilityChanged(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug&, void*)
+{
+  if(!(msg & MNodeMessage::kAttributeSet) || plug.partialName() != "v" || !plug.asBool())
+    return;
+
+  auto it = g_tracker.find(plug.node());
+  if(it != g_tracker.entries.end())
+  {
+    g_tracker.touch(it);
+    queueLoad(it);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus unloadEntry(ReferenceTracker::Entry& entry)
+{
+  if(!entry.loaded)
+    return MS::kSuccess;
+
+  MStatus status = MS::kSuccess;
+  if(entry.reference.isValid())
+  {
+    g_tracker.changingReferences = true;
+    MFileIO::unloadReferenceByNode(entry.reference.object(), &status);
+    g_tracker.changingReferences = false;
+    AL_MAYA_CHECK_ERROR(status, "failed to unload deferred maya reference");
+  }
+  entry.loaded = false;
+  g_tracker.loadedSize -= entry.size;
+  return status;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  References may also be loaded or unloaded outside of the tracker (e.g. from the reference editor), so the
+///         loaded state of the entries is resynced from the reference nodes whenever a reference changes. References
+///         that have been loaded are treated as the most recently used, and unloading the references that no longer
+///         fit within the budget is queued up to run when Maya is next idle.
+//----------------------------------------------------------------------------------------------------------------------
+void onReferenceChanged(void*)
+{
+  if(g_tracker.changingReferences)
+    return;
+
+  std::vector<ReferenceTracker::iterator> newlyLoaded;
+  for(auto it = g_tracker.entries.begin(); it != g_tracker.entries.end(); ++it)
+  {
+    const bool loaded = it->reference.isValid() && MFnReference(it->reference.object()).isLoaded();
+    if(loaded == it->loaded)
+      continue;
+    it->loaded = loaded;
+    if(loaded)
+    {
+      g_tracker.loadedSize += it->size;
+      newlyLoaded.push_back(it);
+    }
+    else
+    {
+      g_tracker.loadedSize -= it->size;
+    }
+  }
+  for(auto it : newlyLoaded)
+  {
+    g_tracker.touch(it);
+  }
+
+  if(g_tracker.budget && g_tracker.loadedSize > g_tracker.budget && !g_tracker.trimQueued)
+  {
+    g_tracker.trimQueued = true;
+    MGlobal::executeCommandOnIdle("AL_usdmaya_DeferredReference -tb");
+  }
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::setEnabled(bool enabled)
+{
+  g_tracker.enabled = enabled;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool DeferredReferences::enabled()
+{
+  return g_tracker.enabled;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::setMemoryBudget(size_t budgetInBytes)
+{
+  g_tracker.budget = budgetInBytes;
+  trimToBudget();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::trimToBudget()
+{
+  g_tracker.trimQueued = false;
+  if(!g_tracker.budget)
+    return;
+
+  // never unload the most recently used reference, even if it alone exceeds the budget
+  auto it = g_tracker.entries.end();
+  while(g_tracker.loadedSize > g_tracker.budget && it != g_tracker.entries.begin())
+  {
+    --it;
+    if(it != g_tracker.entries.begin())
+      unloadEntry(*it);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t DeferredReferences::memoryBudget()
+{
+  return g_tracker.budget;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t DeferredReferences::loadedSize()
+{
+  return g_tracker.loadedSize;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::track(const MObject& transform, const MObject& reference)
+{
+  auto existing = g_tracker.find(transform);
+  if(existing != g_tracker.entries.end())
+    g_tracker.erase(existing);
+
+  if(!g_tracker.selectionChanged)
+  {
+    g_tracker.selectionChanged = MEventMessage::addEventCallback("SelectionChanged", onSelectionChanged);
+  }
+  if(!g_tracker.referenceLoaded)
+  {
+    g_tracker.referenceLoaded = MSceneMessage::addCallback(MSceneMessage::kAfterLoadReference, onReferenceChanged);
+    g_tracker.referenceUnloaded = MSceneMessage::addCallback(MSceneMessage::kAfterUnloadReference, onReferenceChanged);
+  }
+
+  MFnReference fnReference(reference);
+  const int64_t fileSize = ArchGetFileLength(fnReference.fileName(true, true, false).asChar());
+
+  MObject node = transform;
+  ReferenceTracker::Entry entry;
+  entry.transform = transform;
+  entry.reference = reference;
+  entry.visibilityChanged = MNodeMessage::addAttributeChangedCallback(node, onVisibilityChanged);
+  entry.size = fileSize > 0 ? size_t(fileSize) : 0;
+  entry.loaded = fnReference.isLoaded();
+  entry.loadQueued = false;
+  if(entry.loaded)
+    g_tracker.loadedSize += entry.size;
+
+  // newly tracked references go to the back, so that they do not displace ones the user has been working with
+  g_tracker.entries.push_back(entry);
+  g_tracker.lookup.emplace(entry.transform.hashCode(), std::prev(g_tracker.entries.end()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::untrack(const MObject& transform)
+{
+  auto it = g_tracker.find(transform);
+  if(it != g_tracker.entries.end())
+    g_tracker.erase(it);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool DeferredReferences::isTracked(const MObject& transform)
+{
+  return g_tracker.find(transform) != g_tracker.entries.end();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool DeferredReferences::isLoaded(const MObject& transform)
+{
+  auto it = g_tracker.find(transform);
+  return it != g_tracker.entries.end() && it->loaded;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus DeferredReferences::load(const MObject& transform)
+{
+  auto it = g_tracker.find(transform);
+  if(it == g_tracker.entries.end())
+    return MS::kNotFound;
+
+  it->loadQueued = false;
+  g_tracker.touch(it);
+  if(it->loaded)
+    return MS::kSuccess;
+
+  if(!it->reference.isValid())
+  {
+    g_tracker.erase(it);
+    return MS::kFailure;
+  }
+
+  MStatus status;
+  g_tracker.changingReferences = true;
+  MFileIO::loadReferenceByNode(it->reference.object(), &status);
+  g_tracker.changingReferences = false;
+  AL_MAYA_CHECK_ERROR(status, "failed to load deferred maya reference");
+  it->loaded = true;
+  g_tracker.loadedSize += it->size;
+  trimToBudget();
+  return MS::kSuccess;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus DeferredReferences::unload(const MObject& transform)
+{
+  auto it = g_tracker.find(transform);
+  if(it == g_tracker.entries.end())
+    return MS::kNotFound;
+  return unloadEntry(*it);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::clear()
+{
+  while(!g_tracker.entries.empty())
+  {
+    g_tracker.erase(g_tracker.entries.begin());
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DeferredReferences::removeCallbacks()
+{
+  clear();
+  if(g_tracker.selectionChanged)
+  {
+    MEventMessage::removeCallback(g_tracker.selectionChanged);
+    g_tracker.selectionChanged = 0;
+  }
+  if(g_tracker.referenceLoaded)
+  {
+    MSceneMessage::removeCallback(g_tracker.referenceLoaded);
+    MSceneMessage::removeCallback(g_tracker.referenceUnloaded);
+    g_tracker.referenceLoaded = 0;
+    g_tracker.referenceUnloaded = 0;
+  }
+}
+
+} // usdmaya
+} // AL
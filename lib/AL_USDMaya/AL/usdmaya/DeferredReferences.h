@@ -0,0 +1,98 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+#include "AL/usdmaya/Common.h"
+
+#include "maya/MObject.h"
+#include "maya/MStatus.h"
+
+#include <cstddef>
+
+namespace AL {
+namespace usdmaya {
+
+/// \brief  Keeps track of the Maya references created for ALMayaReference prims when deferred reference loading is
+///         enabled. In that mode the references are created unloaded, and a reference is only loaded when the
+///         transform of its prim (or a node beneath it) is selected, when that transform is made visible, or when it
+///         is requested through the AL_usdmaya_DeferredReference command. Whenever the estimated size of the loaded
+///         references exceeds the memory budget, the least recently used references are unloaded again.
+/// \ingroup usdmaya
+class DeferredReferences
+{
+public:
+
+  /// \brief  enables or disables deferred loading of the references created for ALMayaReference prims. This only
+  ///         affects references created after the call.
+  /// \param  enabled true to create references unloaded, false to load them as they are created
+  static void setEnabled(bool enabled);
+
+  /// \brief  returns true if deferred reference loading is enabled
+  static bool enabled();
+
+  /// \brief  sets the memory budget for the loaded deferred references. The size of each reference is estimated from
+  ///         the size of its file on disk. A budget of zero (the default) never unloads a reference.
+  /// \param  budgetInBytes the maximum size of the deferred references that may be loaded at once
+  static void setMemoryBudget(size_t budgetInBytes);
+
+  /// \brief  returns the memory budget for the loaded deferred references
+  /// \return the budget in bytes
+  static size_t memoryBudget();
+
+  /// \brief  returns the estimated size of the deferred references that are currently loaded. This includes the
+  ///         references that have been loaded or unloaded outside of this class (e.g. from the reference editor).
+  /// \return the size in bytes
+  static size_t loadedSize();
+
+  /// \brief  unloads the least recently used references until the loaded references fit within the memory budget
+  static void trimToBudget();
+
+  /// \brief  starts tracking an unloaded reference created for the prim transform specified
+  /// \param  transform the AL_usdmaya_Transform of the ALMayaReference prim
+  /// \param  reference the (unloaded) reference node
+  static void track(const MObject& transform, const MObject& reference);
+
+  /// \brief  stops tracking the reference of the transform specified (e.g. prior to the reference being removed)
+  /// \param  transform the AL_usdmaya_Transform of the ALMayaReference prim
+  static void untrack(const MObject& transform);
+
+  /// \brief  returns true if the transform specified has a deferred reference
+  /// \param  transform the AL_usdmaya_Transform of the ALMayaReference prim
+  static bool isTracked(const MObject& transform);
+
+  /// \brief  returns true if the deferred reference of the transform specified is loaded
+  /// \param  transform the AL_usdmaya_Transform of the ALMayaReference prim
+  static bool isLoaded(const MObject& transform);
+
+  /// \brief  loads the deferred reference of the transform specified, and then unloads the least recently used
+  ///         references until the loaded references fit within the memory budget.
+  /// \param  transform the AL_usdmaya_Transform of the ALMayaReference prim
+  /// \return MS::kSuccess if the reference was loaded, or was already loaded
+  static MStatus load(const MObject& transform);
+
+  /// \brief  unloads the deferred reference of the transform specified
+  /// \param  transform the AL_usdmaya_Transform of the ALMayaReference prim
+  /// \return MS::kSuccess if the reference was unloaded, or was not loaded
+  static MStatus unload(const MObject& transform);
+
+  /// \brief  stops tracking all of the deferred references. Called when a new scene is created or opened.
+  static void clear();
+
+  /// \brief  deletes the callbacks constructed to track the deferred references
+  static void removeCallbacks();
+};
+
+} // usdmaya
+} // AL
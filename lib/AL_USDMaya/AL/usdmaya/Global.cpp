@@ -13,8 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include "AL/maya/ALHalf.h"
+#include "AL/maya/CpuFeatures.h"
+#include "AL/usdmaya/DeferredReferences.h"
 #include "AL/usdmaya/Global.h"
 #include "AL/usdmaya/StageCache.h"
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
 #include "AL/usdmaya/nodes/Layer.h"
 #include "AL/usdmaya/nodes/ProxyShape.h"
 #include "AL/usdmaya/nodes/Transform.h"
@@ -26,6 +30,7 @@
 #include "maya/MFnDependencyNode.h"
 #include "maya/MItDependencyNodes.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace AL {
@@ -52,12 +57,14 @@ static void onFileNew(void*)
   // These should both clear the caches, however they don't actually do anything of the sort. Puzzled.
   UsdUtilsStageCache::Get().Clear();
   StageCache::Clear();
+  DeferredReferences::clear();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 static void preFileOpen(void*)
 {
   Trace("preFileOpen");
+  DeferredReferences::clear();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -155,6 +162,36 @@ void Global::onPluginLoad()
   m_postOpen = MSceneMessage::addCallback(MSceneMessage::kAfterOpen, postFileOpen);
 
   // For callback initialization for stage cache callback, it will be done via proxy node attribute change.
+
+  // bind the widest SIMD kernels the host CPU supports. The level can be capped (0 = scalar, 1 = SSE3, 2 = AVX2) when
+  // tracking down differences between the implementations.
+  maya::SimdLevel simdLevel = maya::SimdLevel::kAVX2;
+  if(MGlobal::optionVarExists("AL_usdmaya_maxSimdLevel"))
+  {
+    const int level = MGlobal::optionVarIntValue("AL_usdmaya_maxSimdLevel");
+    simdLevel = maya::SimdLevel(std::max(0, std::min(level, int(maya::SimdLevel::kAVX2))));
+  }
+  fileio::translators::bindMeshKernels(simdLevel);
+  maya::bindHalfConversionKernels(simdLevel);
+
+  // optionally keep the layers of the previous scene alive when switching scenes (budget specified in megabytes)
+  if(MGlobal::optionVarExists("AL_usdmaya_layerCacheBudget"))
+  {
+    const int budget = MGlobal::optionVarIntValue("AL_usdmaya_layerCacheBudget");
+    StageCache::setLayerCacheBudget(budget > 0 ? size_t(budget) << 20 : 0);
+  }
+
+  // optionally create the maya references of ALMayaReference prims unloaded, and load them on demand (budget
+  // specified in megabytes)
+  if(MGlobal::optionVarExists("AL_usdmaya_deferMayaReferences"))
+  {
+    DeferredReferences::setEnabled(MGlobal::optionVarIntValue("AL_usdmaya_deferMayaReferences") != 0);
+  }
+  if(MGlobal::optionVarExists("AL_usdmaya_deferredReferenceBudget"))
+  {
+    const int budget = MGlobal::optionVarIntValue("AL_usdmaya_deferredReferenceBudget");
+    DeferredReferences::setMemoryBudget(budget > 0 ? size_t(budget) << 20 : 0);
+  }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -166,6 +203,8 @@ void Global::onPluginUnload()
   MSceneMessage::removeCallback(m_preOpen);
   MSceneMessage::removeCallback(m_postOpen);
   StageCache::removeCallbacks();
+  StageCache::clearLayerCache();
+  DeferredReferences::removeCallbacks();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
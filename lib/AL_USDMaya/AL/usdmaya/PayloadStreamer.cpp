@@ -0,0 +1,258 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/PayloadStreamer.h"
+
+#include "pxr/usd/usdGeom/mesh.h"
+
+#include <algorithm>
+
+// printf debugging
+#if 0 || AL_ENABLE_TRACE
+# define Trace(X) std::cerr << X << std::endl;
+#else
+# define Trace(X)
+#endif
+
+namespace AL {
+namespace usdmaya {
+
+namespace {
+// a nominal cost for the prim itself (its prim index, properties, and so on)
+const size_t kPrimCost = 1024;
+
+// the size of the default value of an array attribute. The value is read as a VtValue, so that the array held by an
+// in memory layer is shared (VtArray is copy on write) rather than copied out into a typed array.
+size_t arrayValueSize(const UsdAttribute& attr, size_t elementSize)
+{
+  VtValue value;
+  if(!attr.Get(&value) || !value.IsArrayValued())
+    return 0;
+  return value.GetArraySize() * elementSize;
+}
+
+// nested payloads are loaded and unloaded along with the outermost payload that contains them
+bool hasPayloadAncestor(const UsdPrim& prim)
+{
+  for(UsdPrim parent = prim.GetParent(); parent; parent = parent.GetParent())
+  {
+    if(parent.HasPayload())
+      return true;
+  }
+  return false;
+}
+} // anon
+
+constexpr size_t PayloadStreamer::kDefaultPayloadCost;
+
+//----------------------------------------------------------------------------------------------------------------------
+PayloadStreamer::PayloadStreamer()
+  : m_estimator(estimateCost)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void PayloadStreamer::setStage(const UsdStageRefPtr& stage)
+{
+  m_stage = stage;
+  m_loaded.clear();
+  m_unloadedCosts.clear();
+  m_loadedCost = 0;
+  if(stage)
+  {
+    syncLoadSet(stage);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t PayloadStreamer::cost(const SdfPath& path) const
+{
+  auto it = m_loaded.find(path);
+  return it != m_loaded.end() ? it->second.cost : 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t PayloadStreamer::estimateCost(const UsdPrim& prim)
+{
+  size_t cost = 0;
+  std::vector<UsdPrim> stack(1, prim);
+  while(!stack.empty())
+  {
+    UsdPrim current = stack.back();
+    stack.pop_back();
+    cost += kPrimCost;
+
+    UsdGeomMesh mesh(current);
+    if(mesh)
+    {
+      cost += arrayValueSize(mesh.GetPointsAttr(), sizeof(GfVec3f));
+      cost += arrayValueSize(mesh.GetFaceVertexIndicesAttr(), sizeof(int));
+    }
+
+    for(auto it = current.GetChildren().begin(), end = current.GetChildren().end(); it != end; ++it)
+    {
+      stack.push_back(*it);
+    }
+  }
+  return cost;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void PayloadStreamer::syncLoadSet(const UsdStageRefPtr& stage)
+{
+  const SdfPathSet loadSet = stage->GetLoadSet();
+
+  // forget any payloads that have been unloaded by someone else
+  for(auto it = m_loaded.begin(); it != m_loaded.end(); )
+  {
+    if(!loadSet.count(it->first))
+    {
+      m_loadedCost -= it->second.cost;
+      m_unloadedCosts[it->first] = it->second.cost;
+      it = m_loaded.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  // and start tracking any that have been loaded by someone else. The load set also contains the nested payloads
+  // of a loaded payload, which are already part of its cost.
+  for(const SdfPath& path : loadSet)
+  {
+    if(m_loaded.count(path))
+      continue;
+    UsdPrim prim = stage->GetPrimAtPath(path);
+    if(!prim || !prim.HasPayload() || hasPayloadAncestor(prim))
+      continue;
+    Entry entry;
+    entry.cost = m_estimator(prim);
+    entry.lastUsed = m_tick;
+    m_loaded.emplace(path, entry);
+    m_unloadedCosts.erase(path);
+    m_loadedCost += entry.cost;
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool PayloadStreamer::update(const Priorities& priorities)
+{
+  UsdStageRefPtr stage = m_stage;
+  if(!stage)
+    return false;
+
+  // payloads loaded by someone else since the last round are stamped with the previous round, so they are the most
+  // recently used of the payloads that are not requested in this round
+  syncLoadSet(stage);
+  ++m_tick;
+
+  // highest priority first. Ties are broken by path, so that the results do not depend on the order of the input.
+  Priorities ordered(priorities);
+  std::sort(ordered.begin(), ordered.end(), [](const std::pair<SdfPath, double>& a, const std::pair<SdfPath, double>& b)
+  {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+
+  // until something has been loaded there is nothing to base a prediction on. Clamping to the budget ensures that
+  // the highest priority payload is always loaded, after which the prediction improves.
+  const size_t predictedCost = !m_loaded.empty() ? m_loadedCost / m_loaded.size() :
+                               m_budget ? std::min(kDefaultPayloadCost, m_budget) : kDefaultPayloadCost;
+
+  // choose the payloads to keep (or load) in priority order, skipping any that would not fit within the budget. A
+  // payload that has been loaded before is expected to cost what it did then, rather than the prediction (otherwise a
+  // payload unloaded for being too large would be loaded again by the following round).
+  SdfPathSet toLoad;
+  size_t wantedCost = 0;
+  size_t loadingCost = 0;
+  for(const auto& request : ordered)
+  {
+    const SdfPath& path = request.first;
+    auto loaded = m_loaded.find(path);
+    if(loaded != m_loaded.end())
+    {
+      if(loaded->second.lastUsed == m_tick)
+        continue;
+      if(m_budget && wantedCost + loaded->second.cost > m_budget)
+        continue;
+      wantedCost += loaded->second.cost;
+      loaded->second.lastUsed = m_tick;
+    }
+    else
+    {
+      if(toLoad.count(path))
+        continue;
+      UsdPrim prim = stage->GetPrimAtPath(path);
+      if(!prim || !prim.HasPayload() || hasPayloadAncestor(prim))
+        continue;
+      auto measured = m_unloadedCosts.find(path);
+      const size_t expectedCost = measured != m_unloadedCosts.end() ? measured->second : predictedCost;
+      if(m_budget && wantedCost + expectedCost > m_budget)
+        continue;
+      wantedCost += expectedCost;
+      loadingCost += expectedCost;
+      toLoad.insert(path);
+    }
+  }
+
+  // if everything would not fit, unload the payloads that were not chosen, least recently used first
+  SdfPathSet toUnload;
+  size_t projectedCost = m_loadedCost + loadingCost;
+  if(m_budget && projectedCost > m_budget)
+  {
+    std::vector<std::pair<uint64_t, SdfPath> > unused;
+    for(const auto& loaded : m_loaded)
+    {
+      if(loaded.second.lastUsed != m_tick)
+        unused.emplace_back(loaded.second.lastUsed, loaded.first);
+    }
+    std::sort(unused.begin(), unused.end());
+    for(auto it = unused.begin(); it != unused.end() && projectedCost > m_budget; ++it)
+    {
+      toUnload.insert(it->second);
+      projectedCost -= m_loaded[it->second].cost;
+    }
+  }
+
+  if(toLoad.empty() && toUnload.empty())
+    return false;
+
+  Trace("PayloadStreamer::update loading " << toLoad.size() << " unloading " << toUnload.size());
+  stage->LoadAndUnload(toLoad, toUnload);
+
+  for(const SdfPath& path : toUnload)
+  {
+    auto it = m_loaded.find(path);
+    m_loadedCost -= it->second.cost;
+    m_unloadedCosts[path] = it->second.cost;
+    m_loaded.erase(it);
+  }
+  for(const SdfPath& path : toLoad)
+  {
+    UsdPrim prim = stage->GetPrimAtPath(path);
+    if(!prim)
+      continue;
+    Entry entry;
+    entry.cost = m_estimator(prim);
+    entry.lastUsed = m_tick;
+    m_loaded.emplace(path, entry);
+    m_unloadedCosts.erase(path);
+    m_loadedCost += entry.cost;
+  }
+  return true;
+}
+
+} // usdmaya
+} // AL
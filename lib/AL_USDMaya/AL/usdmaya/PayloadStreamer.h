@@ -0,0 +1,126 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+#include "AL/usdmaya/Common.h"
+
+#include "pxr/pxr.h"
+#include "pxr/usd/sdf/path.h"
+#include "pxr/usd/usd/stage.h"
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace AL {
+namespace usdmaya {
+
+/// \brief  Streams the payloads of a stage in and out of memory, so that stages larger than the available memory can
+///         be worked with. Each round of streaming is given a priority for the payloads that should be loaded. The
+///         payloads are loaded in priority order until the memory budget is reached, and the least recently used
+///         payloads are unloaded to make room for them. All of the changes made in a round are applied with a single
+///         call to UsdStage::LoadAndUnload, so the stage is only recomposed once.
+///
+///         The memory used by a payload is estimated once it has been loaded, and remembered after it is unloaded.
+///         Until a payload has been loaded, its cost is predicted to be the average cost of the payloads that are
+///         already loaded.
+///
+///         Only the outermost payloads are streamed. Loading a payload also loads any payloads nested within it, so
+///         those are counted as part of the cost of the outermost payload, and are unloaded along with it.
+/// \ingroup usdmaya
+class PayloadStreamer
+{
+public:
+
+  /// a payload path, and the priority with which it should be loaded (higher values are loaded first)
+  typedef std::vector<std::pair<SdfPath, double> > Priorities;
+
+  /// the function used to estimate the memory used by a loaded payload
+  typedef std::function<size_t(const UsdPrim& payloadPrim)> CostEstimator;
+
+  /// the predicted cost of a payload, used when no payloads have been loaded yet
+  static constexpr size_t kDefaultPayloadCost = 16 * 1024 * 1024;
+
+  /// \brief  ctor
+  PayloadStreamer();
+
+  /// \brief  sets the stage to stream the payloads of. Any payloads that are already loaded are tracked from here on.
+  /// \param  stage the stage
+  void setStage(const UsdStageRefPtr& stage);
+
+  /// \brief  sets the memory budget for the loaded payloads
+  /// \param  budgetInBytes the maximum estimated size of the loaded payloads. Zero (the default) loads every payload
+  ///         that is given a priority, and never unloads any.
+  void setBudget(size_t budgetInBytes)
+    { m_budget = budgetInBytes; }
+
+  /// \brief  returns the memory budget for the loaded payloads
+  /// \return the budget in bytes
+  size_t budget() const
+    { return m_budget; }
+
+  /// \brief  replaces the function used to estimate the memory used by a loaded payload
+  /// \param  estimator the new cost estimator
+  void setCostEstimator(const CostEstimator& estimator)
+    { m_estimator = estimator; }
+
+  /// \brief  returns the estimated size of the payloads that are currently loaded
+  /// \return the size in bytes
+  size_t loadedCost() const
+    { return m_loadedCost; }
+
+  /// \brief  returns the estimated size of a loaded payload
+  /// \param  path the path of the payload prim
+  /// \return the size in bytes, or zero if the payload is not loaded
+  size_t cost(const SdfPath& path) const;
+
+  /// \brief  performs one round of streaming. The payloads given a priority are loaded in priority order, skipping any
+  ///         that would exceed the budget. If the loaded payloads then exceed the budget, the payloads that were not
+  ///         requested are unloaded, least recently requested first. Payloads that are not requested are otherwise
+  ///         left as they are.
+  /// \param  priorities the payloads that should be loaded. Paths that are not payload prims, or that are nested within
+  ///         another payload, are ignored.
+  /// \return true if any payloads were loaded or unloaded
+  bool update(const Priorities& priorities);
+
+  /// \brief  the default cost estimator. Sums a nominal cost per prim with the size of the default points and face
+  ///         vertex indices of any meshes beneath the payload prim (including those in nested payloads). Time samples
+  ///         are not counted, so the cost of animated data is underestimated.
+  /// \param  prim the payload prim
+  /// \return the estimated size in bytes
+  static size_t estimateCost(const UsdPrim& prim);
+
+private:
+  struct Entry
+  {
+    size_t cost;
+    uint64_t lastUsed;
+  };
+  void syncLoadSet(const UsdStageRefPtr& stage);
+  std::unordered_map<SdfPath, Entry, SdfPath::Hash> m_loaded;
+  std::unordered_map<SdfPath, size_t, SdfPath::Hash> m_unloadedCosts; ///< the estimated cost of payloads since unloaded
+  UsdStagePtr m_stage;
+  CostEstimator m_estimator;
+  size_t m_budget = 0;
+  size_t m_loadedCost = 0;
+  uint64_t m_tick = 0;
+};
+
+} // usdmaya
+} // AL
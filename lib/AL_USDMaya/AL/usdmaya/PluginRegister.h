@@ -22,6 +22,8 @@
 #include "AL/usdmaya/StageData.h"
 #include "AL/usdmaya/DrivenTransformsData.h"
 #include "AL/usdmaya/cmds/LayerCommands.h"
+#include "AL/usdmaya/cmds/MayaReferenceCommands.h"
+#include "AL/usdmaya/cmds/ProfilerCommands.h"
 #include "AL/usdmaya/cmds/ProxyShapeCommands.h"
 #include "AL/usdmaya/cmds/UnloadPrim.h"
 #include "AL/usdmaya/fileio/Export.h"
@@ -29,6 +31,7 @@
 #include "AL/usdmaya/fileio/Import.h"
 #include "AL/usdmaya/fileio/ImportTranslator.h"
 #include "AL/usdmaya/nodes/Layer.h"
+#include "AL/usdmaya/nodes/MeshAnimDeformer.h"
 #include "AL/usdmaya/nodes/ProxyDrawOverride.h"
 #include "AL/usdmaya/nodes/ProxyShape.h"
 #include "AL/usdmaya/nodes/ProxyShapeUI.h"
@@ -77,6 +80,7 @@ MStatus registerPlugin(AFnPlugin& plugin)
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeImportAllTransforms);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeRemoveAllTransforms);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeResync);
+  AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeStreamPayloads);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeImportPrimPathAsMaya);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapePrintRefCountState);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ChangeVariant);
@@ -84,6 +88,8 @@ MStatus registerPlugin(AFnPlugin& plugin)
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeSelect);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapePostSelect);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::InternalProxyShapeSelect);
+  AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProfilerTrace);
+  AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::DeferredReference);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::fileio::ImportCommand);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::fileio::ExportCommand);
   AL_REGISTER_TRANSLATOR(plugin, AL::usdmaya::fileio::ImportTranslator);
@@ -93,6 +99,7 @@ MStatus registerPlugin(AFnPlugin& plugin)
   AL_REGISTER_TRANSFORM_NODE(plugin, AL::usdmaya::nodes::Transform, AL::usdmaya::nodes::TransformationMatrix);
   AL_REGISTER_DEPEND_NODE(plugin, AL::usdmaya::nodes::Layer);
   AL_REGISTER_DEPEND_NODE(plugin, AL::usdmaya::nodes::HostDrivenTransforms);
+  AL_REGISTER_DEFORMER_NODE(plugin, AL::usdmaya::nodes::MeshAnimDeformer);
 
   // generate the menu GUI + option boxes
   AL::usdmaya::cmds::constructLayerCommandGuis();
@@ -116,6 +123,8 @@ MStatus unregisterPlugin(AFnPlugin& plugin)
 {
   MStatus status;
   AL_UNREGISTER_COMMAND(plugin, AL::maya::CommandGuiListGen);
+  AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::DeferredReference);
+  AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProfilerTrace);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::InternalProxyShapeSelect);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapePostSelect);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeSelect);
@@ -132,6 +141,7 @@ MStatus unregisterPlugin(AFnPlugin& plugin)
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeImportAllTransforms);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeRemoveAllTransforms);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeResync);
+  AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeStreamPayloads);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapeImportPrimPathAsMaya);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapePrintRefCountState);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::fileio::ImportCommand);
@@ -139,10 +149,12 @@ MStatus unregisterPlugin(AFnPlugin& plugin)
   AL_UNREGISTER_TRANSLATOR(plugin, AL::usdmaya::fileio::ImportTranslator);
   AL_UNREGISTER_TRANSLATOR(plugin, AL::usdmaya::fileio::ExportTranslator);
   AL_UNREGISTER_DRAW_OVERRIDE(plugin, AL::usdmaya::nodes::ProxyDrawOverride);
+  AL::usdmaya::nodes::ProxyDrawOverride::removeCallbacks();
   AL_UNREGISTER_NODE(plugin, AL::usdmaya::nodes::ProxyShape);
   AL_UNREGISTER_NODE(plugin, AL::usdmaya::nodes::Transform);
   AL_UNREGISTER_NODE(plugin, AL::usdmaya::nodes::Layer);
   AL_UNREGISTER_NODE(plugin, AL::usdmaya::nodes::HostDrivenTransforms);
+  AL_UNREGISTER_NODE(plugin, AL::usdmaya::nodes::MeshAnimDeformer);
   AL_UNREGISTER_DATA(plugin, AL::usdmaya::DrivenTransformsData);
   AL_UNREGISTER_DATA(plugin, AL::usdmaya::StageData);
 
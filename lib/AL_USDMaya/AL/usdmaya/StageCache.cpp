@@ -19,19 +19,125 @@
 
 #include "maya/MGlobal.h"
 
+#include "pxr/base/arch/fileSystem.h"
 #include "pxr/usd/usd/stage.h"
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 namespace AL {
 namespace usdmaya {
 
 MCallbackId StageCache::beforeNewCallbackId = 0;
 MCallbackId StageCache::beforeLoadCallbackId = 0;
 
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A least recently used cache of the layers that were used by the stages of previous scenes
+//----------------------------------------------------------------------------------------------------------------------
+struct LayerCache
+{
+  struct Entry
+  {
+    SdfLayerRefPtr layer;
+    double modificationTime;
+    size_t size;
+  };
+  typedef std::list<Entry> EntryList;
+
+  /// \brief  adds the layer to the front of the cache (or moves it there if it is already cached). The layer is
+  ///         reloaded first if its file has been modified since it was read, so that the recorded modification time
+  ///         matches the contents of the retained layer.
+  void retain(const SdfLayerRefPtr& layer)
+  {
+    if(layer->IsAnonymous() || layer->IsDirty())
+    {
+      return;
+    }
+    const std::string& path = layer->GetRealPath();
+    double modificationTime = 0;
+    if(path.empty() || !ArchGetModificationTime(path.c_str(), &modificationTime))
+    {
+      return;
+    }
+
+    // the time is read before reloading, so that an edit made during the reload is treated as a modification by trim
+    if(!layer->Reload())
+    {
+      return;
+    }
+
+    auto it = lookup.find(layer->GetIdentifier());
+    if(it != lookup.end())
+    {
+      size -= it->second->size;
+      entries.erase(it->second);
+      lookup.erase(it);
+    }
+
+    const int64_t fileSize = ArchGetFileLength(path.c_str());
+    Entry entry = { layer, modificationTime, fileSize > 0 ? size_t(fileSize) : 0 };
+    entries.push_front(entry);
+    lookup.emplace(layer->GetIdentifier(), entries.begin());
+    size += entry.size;
+  }
+
+  /// \brief  releases any layer that has been modified since it was retained, then releases the least recently used
+  ///         layers until the cache fits within the budget
+  void trim()
+  {
+    for(auto it = entries.begin(); it != entries.end(); )
+    {
+      double modificationTime = 0;
+      if(it->layer->IsDirty() ||
+         !ArchGetModificationTime(it->layer->GetRealPath().c_str(), &modificationTime) ||
+         modificationTime != it->modificationTime)
+      {
+        TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("StageCache: releasing modified layer %s\n", it->layer->GetIdentifier().c_str());
+        it = release(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    while(size > budget && !entries.empty())
+    {
+      TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("StageCache: evicting layer %s\n", entries.back().layer->GetIdentifier().c_str());
+      release(std::prev(entries.end()));
+    }
+  }
+
+  EntryList::iterator release(EntryList::iterator it)
+  {
+    size -= it->size;
+    lookup.erase(it->layer->GetIdentifier());
+    return entries.erase(it);
+  }
+
+  void clear()
+  {
+    lookup.clear();
+    entries.clear();
+    size = 0;
+  }
+
+  EntryList entries; ///< the retained layers, most recently used first
+  std::unordered_map<std::string, EntryList::iterator> lookup; ///< layer identifier to entry
+  size_t size = 0; ///< the estimated size of all retained layers
+  size_t budget = 0; ///< the maximum size of the retained layers
+};
+
+LayerCache g_layerCache;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 static void onMayaSceneUpdateCallback(void* clientData)
 {
   TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("Clean the usdMaya cache on maya scene update.\n");
-  StageCache::Clear();
+  StageCache::onSceneChange();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -57,6 +163,65 @@ void StageCache::Clear()
   StageCache::Get(false).Clear();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void StageCache::onSceneChange()
+{
+  // the layers are retained once the stages have been released, so that reloading a modified layer does not
+  // recompose a stage that is about to be destroyed
+  std::vector<SdfLayerRefPtr> usedLayers;
+  if(g_layerCache.budget)
+  {
+    for(bool forcePopulate : { false, true })
+    {
+      for(const UsdStageRefPtr& stage : StageCache::Get(forcePopulate).GetAllStages())
+      {
+        for(const SdfLayerHandle& layer : stage->GetUsedLayers())
+        {
+          usedLayers.push_back(layer);
+        }
+      }
+    }
+  }
+  Clear();
+  for(const SdfLayerRefPtr& layer : usedLayers)
+  {
+    g_layerCache.retain(layer);
+  }
+  g_layerCache.trim();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void StageCache::refreshLayerCache()
+{
+  g_layerCache.trim();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void StageCache::setLayerCacheBudget(size_t budgetInBytes)
+{
+  g_layerCache.budget = budgetInBytes;
+  g_layerCache.trim();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t StageCache::layerCacheBudget()
+{
+  return g_layerCache.budget;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t StageCache::layerCacheSize()
+{
+  return g_layerCache.size;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void StageCache::clearLayerCache()
+{
+  g_layerCache.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
 void StageCache::removeCallbacks()
 {
   if (beforeNewCallbackId)
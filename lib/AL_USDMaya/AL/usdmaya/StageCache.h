@@ -23,7 +23,9 @@ PXR_NAMESPACE_USING_DIRECTIVE
 namespace AL {
 namespace usdmaya {
 
-/// \brief  Maintains a cache of all active stages within maya
+/// \brief  Maintains a cache of all active stages within maya. The stages are released whenever a new scene is created
+///         or opened. Optionally, the layers used by those stages can be kept alive (up to a memory budget) across
+///         the scene change, so that a following scene that uses the same layers does not need to parse them again.
 /// \ingroup usdmaya
 class StageCache
 {
@@ -40,6 +42,34 @@ public:
   /// \brief  Clear the cache
   static void Clear();
 
+  /// \brief  Sets the memory budget of the layer cache. When a new scene is created or opened, the layers used by the
+  ///         cached stages are retained in a least recently used cache, which is trimmed to this budget. The size of
+  ///         each layer is estimated from the size of its file on disk. A layer is released (so that it will be
+  ///         re-read when next opened) if its file has been modified since it was retained, or if it has unsaved
+  ///         edits. Layers whose files were modified while they were in use are reloaded when they are retained.
+  ///         A budget of zero (the default) disables the layer cache.
+  /// \param  budgetInBytes the maximum size of the layers retained across scene changes
+  static void setLayerCacheBudget(size_t budgetInBytes);
+
+  /// \brief  returns the memory budget of the layer cache
+  /// \return the budget in bytes
+  static size_t layerCacheBudget();
+
+  /// \brief  returns the estimated size of the layers currently held in the layer cache
+  /// \return the size in bytes
+  static size_t layerCacheSize();
+
+  /// \brief  releases all of the layers held in the layer cache
+  static void clearLayerCache();
+
+  /// \brief  releases any retained layer whose file has been modified since it was retained, so that it is read again
+  ///         rather than reused. This should be called before opening a stage.
+  static void refreshLayerCache();
+
+  /// \brief  moves the layers used by the cached stages into the layer cache, and then clears the stage cache.
+  ///         This is called before a new scene is created or opened.
+  static void onSceneChange();
+
   /// \brief  deletes the callbacks constructed to manage the stage cache
   static void removeCallbacks();
 private:
@@ -85,6 +85,22 @@ void matrixToSRT(GfMatrix4d& value, double S[3], MEulerRotation& R, double T[3])
   R = MMatrix(matrix);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+MString mayaPathForUsdPrim(const UsdPrim& usdPrim, const MObject& mayaObject, const MDagPath* const usdMayaShapeNode)
+{
+  MFnDagNode mayaNode(mayaObject);
+  MDagPath mayaDagPath;
+  mayaNode.getPath(mayaDagPath);
+  if(mayaDagPath.length() == 0 && usdMayaShapeNode)
+  {
+    // Prepend the mayaPathPrefix
+    std::string mayaElementPath = usdMayaShapeNode->fullPathName().asChar() + usdPrim.GetPath().GetString();
+    std::replace(mayaElementPath.begin(), mayaElementPath.end(), '/','|');
+    return convert(mayaElementPath);
+  }
+  return mayaDagPath.fullPathName();
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 MString mapUsdPrimToMayaNode(const UsdPrim& usdPrim, const MObject& mayaObject, const MDagPath* const usdMayaShapeNode)
 {
@@ -103,27 +119,17 @@ MString mapUsdPrimToMayaNode(const UsdPrim& usdPrim, const MObject& mayaObject,
   auto sessionLayer = stage->GetSessionLayer();
   stage->SetEditTarget(sessionLayer);
 
-  MFnDagNode mayaNode(mayaObject);
-  MDagPath mayaDagPath;
-  mayaNode.getPath(mayaDagPath);
-  std::string mayaElementPath = convert(mayaDagPath.fullPathName());
-
-  if(mayaDagPath.length() == 0 && usdMayaShapeNode)
-  {
-    // Prepend the mayaPathPrefix
-    mayaElementPath = usdMayaShapeNode->fullPathName().asChar() + usdPrim.GetPath().GetString();
-    std::replace(mayaElementPath.begin(), mayaElementPath.end(), '/','|');
-  }
+  MString mayaElementPath = mayaPathForUsdPrim(usdPrim, mayaObject, usdMayaShapeNode);
 
-  VtValue mayaPathValue(mayaElementPath);
+  VtValue mayaPathValue(convert(mayaElementPath));
   usdPrim.SetCustomDataByKey(mayaPathAttributeName, mayaPathValue);
 
-  Trace( " Capturing the path for prim: '" << usdPrim.GetName() << "' mayaObject '" << mayaElementPath << "'" );
+  Trace( " Capturing the path for prim: '" << usdPrim.GetName() << "' mayaObject '" << mayaElementPath.asChar() << "'" );
 
   //restore the edit target
   stage->SetEditTarget(previousTarget);
 
-  return convert(mayaElementPath);
+  return mayaElementPath;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
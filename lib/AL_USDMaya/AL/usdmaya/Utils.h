@@ -33,7 +33,22 @@ namespace AL {
 namespace usdmaya {
 
 //----------------------------------------------------------------------------------------------------------------------
-/// \brief  Captures the mapping of UsdPrim -> Maya Object and stores it into the session layer.
+/// \brief  Returns the maya path of the node created for the UsdPrim.
+///         usdMayaShapeNode is an optional argument, if it is passed and the passed in mayaObject's path couldnt be determined,
+///         then the corresponding maya path is determined using this AL::usdmaya::nodes::ProxyShape and the usdPrim path.
+///         It is to get around the delayed creation of nodes using a Modifier.
+/// \param  usdPrim the prim the mayaObject was created for
+/// \param  mayaObject the maya node
+/// \param  proxyShapeNode pointer to the daga path for the proxy shape
+/// \return returns the path name
+/// \ingroup usdmaya
+//----------------------------------------------------------------------------------------------------------------------
+MString mayaPathForUsdPrim(const UsdPrim& usdPrim, const MObject& mayaObject, const MDagPath* const proxyShapeNode = nullptr);
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Captures the mapping of UsdPrim -> Maya Object and stores it into the session layer as MayaPath
+///         customData. Each call is an edit of the session layer; nodes created by a ProxyShape are instead recorded
+///         in its in-memory prim to node index, and only written to the session layer when the scene is saved.
 ///         usdMayaShapeNode is an optional argument, if it is passed and the passed in mayaObject's path couldnt be determined,
 ///         then the corresponding maya path is determined using this AL::usdmaya::nodes::ProxyShape and the usdPrim path.
 ///         It is to get around the delayed creation of nodes using a Modifier.
@@ -465,6 +465,7 @@ MStatus LayerCreateLayer::undoIt()
   MDGModifier mod;
   mod.deleteNode(m_layerNode);
   mod.doIt();
+  m_shape->invalidateLayerGraph();
 
   // lots more to do here!
   return MS::kSuccess;
@@ -511,6 +512,7 @@ MStatus LayerCreateLayer::redoIt()
 
   m_newLayer->init(m_shape, handle);
   m_parentLayer->addChildLayer(m_newLayer);
+  m_shape->invalidateLayerGraph();
 
   std::stringstream ss("LayerCreateLayer:", std::ios_base::app | std::ios_base::out);
   MGlobal::displayInfo(ss.str().c_str());
@@ -659,6 +661,7 @@ MStatus LayerCreateSubLayer::redoIt()
   m_rootLayer->Save();
   m_newLayer->init(m_shape, handle);
   m_parentLayer->addSubLayer(m_newLayer);
+  m_shape->invalidateLayerGraph();
   fn.setName(nodes::Layer::toMayaNodeName(handle->GetDisplayName()));
   return MS::kSuccess;
 }
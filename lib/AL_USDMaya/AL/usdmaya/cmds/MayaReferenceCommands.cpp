@@ -0,0 +1,188 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/DeferredReferences.h"
+#include "AL/usdmaya/cmds/MayaReferenceCommands.h"
+
+#include "maya/MArgDatabase.h"
+#include "maya/MArgList.h"
+#include "maya/MGlobal.h"
+#include "maya/MIntArray.h"
+#include "maya/MSelectionList.h"
+#include "maya/MSyntax.h"
+
+namespace AL {
+namespace usdmaya {
+namespace cmds {
+
+AL_MAYA_DEFINE_COMMAND(DeferredReference, AL_usdmaya);
+
+//----------------------------------------------------------------------------------------------------------------------
+MSyntax DeferredReference::createSyntax()
+{
+  MSyntax syntax;
+  syntax.addFlag("-h", "-help", MSyntax::kNoArg);
+  syntax.addFlag("-l", "-load", MSyntax::kNoArg);
+  syntax.addFlag("-u", "-unload", MSyntax::kNoArg);
+  syntax.addFlag("-il", "-isLoaded", MSyntax::kNoArg);
+  syntax.addFlag("-en", "-enable", MSyntax::kBoolean);
+  syntax.addFlag("-ie", "-isEnabled", MSyntax::kNoArg);
+  syntax.addFlag("-b", "-budget", MSyntax::kLong);
+  syntax.addFlag("-gb", "-getBudget", MSyntax::kNoArg);
+  syntax.addFlag("-gs", "-getLoadedSize", MSyntax::kNoArg);
+  syntax.addFlag("-tb", "-trimToBudget", MSyntax::kNoArg);
+  syntax.setObjectType(MSyntax::kSelectionList, 0);
+  syntax.useSelectionAsDefault(true);
+  return syntax;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool DeferredReference::isUndoable() const
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus DeferredReference::doIt(const MArgList& args)
+{
+  MStatus status;
+  MArgDatabase database(syntax(), args, &status);
+  AL_MAYA_CHECK_ERROR(status, "AL_usdmaya_DeferredReference: failed to match arguments");
+  AL_MAYA_COMMAND_HELP(database, g_helpText);
+
+  if(database.isFlagSet("-en"))
+  {
+    bool enable = false;
+    AL_MAYA_CHECK_ERROR(database.getFlagArgument("-en", 0, enable), "AL_usdmaya_DeferredReference: unable to fetch \"enable\" argument");
+    DeferredReferences::setEnabled(enable);
+    return MS::kSuccess;
+  }
+  if(database.isFlagSet("-ie"))
+  {
+    setResult(DeferredReferences::enabled());
+    return MS::kSuccess;
+  }
+  if(database.isFlagSet("-b"))
+  {
+    int budget = 0;
+    AL_MAYA_CHECK_ERROR(database.getFlagArgument("-b", 0, budget), "AL_usdmaya_DeferredReference: unable to fetch \"budget\" argument");
+    DeferredReferences::setMemoryBudget(budget > 0 ? size_t(budget) << 20 : 0);
+    return MS::kSuccess;
+  }
+  if(database.isFlagSet("-gb"))
+  {
+    setResult(int(DeferredReferences::memoryBudget() >> 20));
+    return MS::kSuccess;
+  }
+  if(database.isFlagSet("-gs"))
+  {
+    setResult(int(DeferredReferences::loadedSize() >> 20));
+    return MS::kSuccess;
+  }
+  if(database.isFlagSet("-tb"))
+  {
+    DeferredReferences::trimToBudget();
+    return MS::kSuccess;
+  }
+
+  MSelectionList sl;
+  database.getObjects(sl);
+  const bool load = database.isFlagSet("-l");
+  const bool unload = database.isFlagSet("-u");
+  MIntArray loaded;
+  MObject node;
+  for(uint32_t i = 0, n = sl.length(); i < n; ++i)
+  {
+    if(!sl.getDependNode(i, node))
+      continue;
+
+    if(!DeferredReferences::isTracked(node))
+    {
+      if(load || unload)
+      {
+        MString name;
+        sl.getSelectionStrings(i, name);
+        MGlobal::displayWarning(MString("AL_usdmaya_DeferredReference: no deferred reference found for: ") + name);
+      }
+      loaded.append(0);
+      continue;
+    }
+
+    if(load)
+    {
+      DeferredReferences::load(node);
+    }
+    else
+    if(unload)
+    {
+      DeferredReferences::unload(node);
+    }
+    loaded.append(DeferredReferences::isLoaded(node));
+  }
+
+  if(database.isFlagSet("-il"))
+  {
+    setResult(loaded);
+  }
+  return MS::kSuccess;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Documentation strings.
+//----------------------------------------------------------------------------------------------------------------------
+const char* const DeferredReference::g_helpText = R"(
+AL_usdmaya_DeferredReference Overview:
+
+  When deferred reference loading is enabled, the maya references of ALMayaReference prims are created unloaded when
+  a stage is opened. A reference is then loaded when the transform of its prim (or anything beneath it) is selected,
+  when that transform is made visible, or when it is requested with this command. If a memory budget has been set,
+  the least recently used references are unloaded whenever the loaded references exceed it. The size of each
+  reference is estimated from the size of its file on disk.
+
+  To enable deferred reference loading (this only affects stages opened afterwards):
+
+    AL_usdmaya_DeferredReference -en true;
+
+  The optionVars "AL_usdmaya_deferMayaReferences" and "AL_usdmaya_deferredReferenceBudget" (in megabytes) are read
+  when the plugin is loaded.
+
+  To load or unload the references of the prim transforms specified (or of the selected transforms):
+
+    AL_usdmaya_DeferredReference -l "|rigs|rig_01" "|rigs|rig_02";
+    AL_usdmaya_DeferredReference -u "|rigs|rig_01";
+
+  To query which of the specified prim transforms have their reference loaded:
+
+    AL_usdmaya_DeferredReference -il "|rigs|rig_01" "|rigs|rig_02";
+
+  To set the memory budget to 4GB (0 will never unload a reference), and to query the budget and the size of the
+  loaded references in megabytes:
+
+    AL_usdmaya_DeferredReference -b 4096;
+    AL_usdmaya_DeferredReference -gb;
+    AL_usdmaya_DeferredReference -gs;
+
+  References loaded or unloaded by other means (e.g. the reference editor) are included in the loaded size. If they
+  take the loaded references over the budget, the least recently used references are unloaded once Maya is idle. To
+  unload them immediately:
+
+    AL_usdmaya_DeferredReference -tb;
+)";
+
+//----------------------------------------------------------------------------------------------------------------------
+} // cmds
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
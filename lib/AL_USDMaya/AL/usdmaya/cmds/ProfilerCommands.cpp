@@ -0,0 +1,124 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/maya/CodeTimings.h"
+#include "AL/usdmaya/Utils.h"
+#include "AL/usdmaya/cmds/ProfilerCommands.h"
+
+#include "maya/MArgDatabase.h"
+#include "maya/MArgList.h"
+#include "maya/MGlobal.h"
+#include "maya/MSyntax.h"
+
+namespace AL {
+namespace usdmaya {
+namespace cmds {
+
+AL_MAYA_DEFINE_COMMAND(ProfilerTrace, AL_usdmaya);
+
+//----------------------------------------------------------------------------------------------------------------------
+MSyntax ProfilerTrace::createSyntax()
+{
+  MSyntax syntax;
+  syntax.addFlag("-h", "-help", MSyntax::kNoArg);
+  syntax.addFlag("-b", "-begin", MSyntax::kNoArg);
+  syntax.addFlag("-e", "-end", MSyntax::kString);
+  syntax.addFlag("-c", "-cancel", MSyntax::kNoArg);
+  syntax.addFlag("-it", "-isTracing", MSyntax::kNoArg);
+  return syntax;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ProfilerTrace::isUndoable() const
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus ProfilerTrace::doIt(const MArgList& args)
+{
+  MStatus status;
+  MArgDatabase database(syntax(), args, &status);
+  AL_MAYA_CHECK_ERROR(status, "AL_usdmaya_ProfilerTrace: failed to match arguments");
+  AL_MAYA_COMMAND_HELP(database, g_helpText);
+
+  if(database.isFlagSet("-b"))
+  {
+    maya::Profiler::beginTrace();
+  }
+  else
+  if(database.isFlagSet("-e"))
+  {
+    MString filePath;
+    AL_MAYA_CHECK_ERROR(database.getFlagArgument("-e", 0, filePath), "AL_usdmaya_ProfilerTrace: unable to fetch \"end\" argument");
+    if(!maya::Profiler::isTracing())
+    {
+      MGlobal::displayWarning("AL_usdmaya_ProfilerTrace: no trace is being recorded, nothing was written");
+      return MS::kSuccess;
+    }
+    if(!maya::Profiler::endTrace(convert(filePath)))
+    {
+      MGlobal::displayError(MString("AL_usdmaya_ProfilerTrace: unable to write trace to file: ") + filePath);
+      return MS::kFailure;
+    }
+  }
+  else
+  if(database.isFlagSet("-c"))
+  {
+    maya::Profiler::endTrace(std::string());
+  }
+  else
+  if(database.isFlagSet("-it"))
+  {
+    setResult(maya::Profiler::isTracing());
+  }
+  return MS::kSuccess;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Documentation strings.
+//----------------------------------------------------------------------------------------------------------------------
+const char* const ProfilerTrace::g_helpText = R"(
+AL_usdmaya_ProfilerTrace Overview:
+
+  This command records a trace of the profiled sections of code within AL_USDMaya (e.g. stage loading, variant
+  switching, import and export), and writes it out as a Chrome trace JSON file. The file can be viewed in a timeline
+  viewer such as chrome://tracing or https://ui.perfetto.dev. Each event records the thread it ran on and, where
+  available, the prim path or translator type it was processing.
+
+  To start recording a trace:
+
+    AL_usdmaya_ProfilerTrace -b;
+
+  To stop recording, and write the trace to a file:
+
+    AL_usdmaya_ProfilerTrace -e "/tmp/variantSwitch.json";
+
+  If no trace is being recorded, a warning is displayed and no file is written.
+
+  To stop recording, and discard the trace:
+
+    AL_usdmaya_ProfilerTrace -c;
+
+  To query whether a trace is being recorded:
+
+    AL_usdmaya_ProfilerTrace -it;
+)";
+
+//----------------------------------------------------------------------------------------------------------------------
+} // cmds
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
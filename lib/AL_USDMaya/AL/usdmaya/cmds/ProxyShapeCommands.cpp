@@ -27,6 +27,7 @@
 #include "maya/MStatus.h"
 #include "maya/MStringArray.h"
 #include "maya/MSyntax.h"
+#include "maya/MUuid.h"
 #include "maya/MDagPath.h"
 #include "maya/MArgList.h"
 
@@ -542,6 +543,68 @@ MStatus ProxyShapeFindLoadable::doIt(const MArgList& args)
   return MS::kSuccess;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------------------------
+AL_MAYA_DEFINE_COMMAND(ProxyShapeStreamPayloads, AL_usdmaya);
+
+//----------------------------------------------------------------------------------------------------------------------
+MSyntax ProxyShapeStreamPayloads::createSyntax()
+{
+  MSyntax syntax = setUpCommonSyntax();
+  syntax.addFlag("-u", "-uuid", MSyntax::kString);
+  return syntax;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ProxyShapeStreamPayloads::isUndoable() const
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus ProxyShapeStreamPayloads::doIt(const MArgList& args)
+{
+  Trace("ProxyShapeStreamPayloads::doIt");
+  try
+  {
+    MArgDatabase db = makeDatabase(args);
+    AL_MAYA_COMMAND_HELP(db, g_helpText);
+
+    // rounds queued by the proxy shape identify it by UUID, as it may have been renamed before the round runs
+    if(db.isFlagSet("-u"))
+    {
+      MString uuid;
+      db.getFlagArgument("-u", 0, uuid);
+      MSelectionList sl;
+      sl.add(MUuid(uuid));
+      bool changed = false;
+      MFnDependencyNode fn;
+      for(uint32_t i = 0; i < sl.length(); ++i)
+      {
+        MObject node;
+        if(sl.getDependNode(i, node) && fn.setObject(node) && fn.typeId() == nodes::ProxyShape::kTypeId)
+        {
+          changed = ((nodes::ProxyShape*)fn.userNode())->streamPayloadRound() || changed;
+        }
+      }
+      setResult(changed);
+      return MS::kSuccess;
+    }
+
+    nodes::ProxyShape* shape = getShapeNode(db);
+    if(!shape)
+    {
+      throw MS::kFailure;
+    }
+    setResult(shape->streamPayloadRound());
+  }
+  catch(const MStatus& status)
+  {
+    return status;
+  }
+  return MS::kSuccess;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
 AL_MAYA_DEFINE_COMMAND(ProxyShapeImportAllTransforms, AL_usdmaya);
@@ -1368,6 +1431,36 @@ AL_usdmaya_ProxyShapeFindLoadable Overview:
   day it might return a result, so I'll leave it here for now.
 )";
 
+//----------------------------------------------------------------------------------------------------------------------
+const char* const ProxyShapeStreamPayloads::g_helpText = R"(
+AL_usdmaya_ProxyShapeStreamPayloads Overview:
+
+  Performs one round of payload streaming on a proxy shape that has its streamPayloads attribute enabled. Every
+  payload under the proxy's primPath is given a priority, and the payloads are then loaded (highest priority first)
+  and unloaded (least recently used first) so that their estimated size fits within the streamingBudget attribute
+  (in MB). All of the loads and unloads are applied to the stage in one go.
+
+  The payloads are prioritised as follows:
+
+    1. Payloads under one of the prim paths in the streamingPriorityPaths attribute (a comma separated list)
+    2. Payloads that contain, or are contained by, a selected prim
+    3. Payloads nearest to the camera of the active viewport
+
+  A round is queued automatically whenever the stage is opened, the streaming attributes change, the selection
+  changes, or the camera of the active view has moved further than the streamingCameraDistance attribute since the
+  last round. A further round is queued after any round that changed something, until the loaded payloads settle. The
+  command can also be called directly to stream the payloads immediately:
+
+    AL_usdmaya_ProxyShapeStreamPayloads "ProxyShape1";
+
+  The proxy shape may also be specified by its UUID with the -uuid/-u flag (this is how queued rounds find it).
+
+  Returns true if any payloads were loaded or unloaded. Only the outermost payloads are streamed: loading a payload
+  also loads the payloads nested within it, which are counted as part of its size, and unloaded along with it.
+  Streaming is disabled when the stage is shared with another proxy shape (through the stage cache). The size of each
+  payload is estimated from the default mesh points and face vertex indices, so time sampled data is not counted.
+)";
+
 //----------------------------------------------------------------------------------------------------------------------
 const char* const ProxyShapeImportAllTransforms::g_helpText = R"(
 AL_usdmaya_ProxyShapeImportAllTransforms Overview:
@@ -103,6 +103,21 @@ private:
   MStatus doIt(const MArgList& args) override;
 };
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  ProxyShapeStreamPayloads
+///         Performs a round of payload streaming on a proxy shape (see ProxyShape::streamPayloadRound)
+/// \ingroup commands
+//----------------------------------------------------------------------------------------------------------------------
+class ProxyShapeStreamPayloads
+  : public ProxyShapeCommandBase
+{
+public:
+  AL_MAYA_DECLARE_COMMAND();
+private:
+  bool isUndoable() const override;
+  MStatus doIt(const MArgList& args) override;
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  ProxyShapeImportAllTransforms
 ///         From a proxy shape, this will import all usdPrims in the stage as AL_usdmaya_Transform nodes.
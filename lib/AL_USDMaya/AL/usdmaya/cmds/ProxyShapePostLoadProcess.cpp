@@ -42,7 +42,9 @@
 #include "maya/MString.h"
 #include "maya/MSyntax.h"
 
+#include <pxr/base/tf/hash.h>
 #include <pxr/base/tf/type.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/base/vt/dictionary.h>
 #include <pxr/usd/kind/registry.h>
 #include <pxr/usd/usd/modelAPI.h>
@@ -50,6 +52,8 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // printf debugging
 #if 0 || AL_ENABLE_TRACE
@@ -76,37 +80,90 @@ typedef std::map<SdfLayerHandle, LayerSet, CompareLayerHandle > LayerMap;
 typedef std::map<SdfLayerHandle, MObject, CompareLayerHandle > LayerToObjectMap;
 
 //----------------------------------------------------------------------------------------------------------------------
-SdfLayerHandle findLayer(const SdfLayerHandleVector& layers, const std::string& name)
+/// \brief  An index over the layers used by a stage, that maps each of the names a layer may be referred to by
+///         (display name, identifier, or resolved path) to the layer, along with the external references of each layer.
+//----------------------------------------------------------------------------------------------------------------------
+class LayerIndex
 {
-  for(auto it = layers.begin(); it != layers.end(); ++it)
+public:
+
+  /// \brief  builds the index. The external references of the layers are gathered in parallel.
+  /// \param  layers the layers to index
+  LayerIndex(const SdfLayerHandleVector& layers)
+    : m_references(layers.size())
   {
-    if(name == (*it)->GetDisplayName() ||
-       name == (*it)->GetIdentifier())
+    m_names.reserve(layers.size() * 3);
+    m_layers.reserve(layers.size());
+    for(size_t i = 0; i < layers.size(); ++i)
     {
-      return *it;
+      const SdfLayerHandle& layer = layers[i];
+      if(!layer)
+        continue;
+
+      // if two layers share a name, the first one wins
+      m_names.emplace(layer->GetDisplayName(), layer);
+      m_names.emplace(layer->GetIdentifier(), layer);
+      if(!layer->GetRealPath().empty())
+      {
+        m_names.emplace(layer->GetRealPath(), layer);
+      }
+      m_layers.emplace(layer, i);
     }
+
+    WorkParallelForN(layers.size(), [&layers, this](size_t begin, size_t end)
+    {
+      for(size_t i = begin; i != end; ++i)
+      {
+        if(layers[i])
+        {
+          m_references[i] = layers[i]->GetExternalReferences();
+        }
+      }
+    });
   }
-  return SdfLayerHandle();
-}
+
+  /// \brief  returns the layer referred to by the name, or an invalid handle if the layer is not in the index
+  /// \param  name the display name, identifier, or resolved path of the layer
+  /// \return the layer
+  SdfLayerHandle findLayer(const std::string& name) const
+  {
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second : SdfLayerHandle();
+  }
+
+  /// \brief  returns the external references of the layer
+  /// \param  layer the layer
+  /// \return the external references of the layer
+  std::set<std::string> externalReferences(const SdfLayerHandle& layer) const
+  {
+    auto it = m_layers.find(layer);
+    return it != m_layers.end() ? m_references[it->second] : layer->GetExternalReferences();
+  }
+
+private:
+  std::unordered_map<std::string, SdfLayerHandle> m_names;
+  std::unordered_map<SdfLayerHandle, size_t, TfHash> m_layers;
+  std::vector<std::set<std::string> > m_references;
+};
 
 //----------------------------------------------------------------------------------------------------------------------
-void buildTree(const SdfLayerHandle& layer, LayerMap& layerMap, const SdfLayerHandleVector& layers)
+void buildTree(const SdfLayerHandle& layer, LayerMap& layerMap, const LayerIndex& index)
 {
   auto iter = layerMap.find(layer);
   if(iter == layerMap.end())
   {
     LayerSet kids;
-    std::set<std::string> refs = layer->GetExternalReferences();
+    std::set<std::string> refs = index.externalReferences(layer);
 
 
     for(auto it = refs.begin(); it != refs.end(); ++it)
     {
-      SdfLayerHandle childHandle = findLayer(layers, *it);
+      SdfLayerHandle childHandle = index.findLayer(*it);
 
       if(childHandle)
       {
         kids.insert(childHandle);
-        buildTree(childHandle, layerMap, layers);
+        buildTree(childHandle, layerMap, index);
       }
     }
     layerMap.insert(std::make_pair(layer, kids));
@@ -297,7 +354,7 @@ void constructLayers(MObject proxyNode, nodes::ProxyShape* shape, UsdStageRefPtr
     return;
 
   LayerMap layerMap;
-  SdfLayerHandleVector layers = stage->GetUsedLayers();
+  const LayerIndex index(stage->GetUsedLayers());
   SdfLayerHandle previous;
   SdfLayerHandle first;
   SdfLayerHandleVector layerStack = stage->GetLayerStack(true);
@@ -324,7 +381,7 @@ void constructLayers(MObject proxyNode, nodes::ProxyShape* shape, UsdStageRefPtr
       }
 
       // now build the tree from this layer
-      buildTree(handle, layerMap, layers);
+      buildTree(handle, layerMap, index);
       previous = handle;
     }
   }
@@ -419,6 +476,60 @@ void ProxyShapePostLoadProcess::createSchemaPrims(
     fileio::translators::TranslatorContextPtr context = schemaNodeDB->context();
     fileio::translators::TranslatorManufacture& translatorManufacture = schemaNodeDB->translatorManufacture();
 
+    // prims whose translator supports batched import are gathered per type, and imported in one pass. This changes the
+    // order in which unrelated prims are imported (batched prims are imported after the prims that follow them), but
+    // the batches are flushed before any descendant of a batched prim is processed, so a prim is never imported or
+    // updated before its ancestors.
+    struct ImportBatch
+    {
+      fileio::translators::TranslatorRefPtr translator;
+      std::vector<UsdPrim> prims;
+      std::vector<MObject> parents;
+    };
+    std::vector<ImportBatch> batches;
+    std::unordered_map<TfToken, size_t, TfToken::HashFunctor> batchIndices;
+    SdfPathSet batchedPaths;
+
+    auto flushBatches = [&]()
+    {
+      for(ImportBatch& batch : batches)
+      {
+        AL_BEGIN_PROFILE_SECTION(SchemaPrimsBatch);
+        AL_PROFILE_SECTION_ARGUMENT(primCount, std::to_string(batch.prims.size()));
+        std::vector<bool> imported;
+        fileio::importSchemaPrims(batch.prims, batch.parents, imported, context, batch.translator);
+        for(size_t i = 0, n = batch.prims.size(); i < n; ++i)
+        {
+          const UsdPrim& prim = batch.prims[i];
+          if(imported[i])
+          {
+            schemaNodeDB->addEntry(prim.GetPath(), batch.parents[i]);
+          }
+          else
+          {
+            std::cerr << "Error: unable to load schema prim node: '" << prim.GetName().GetString() << "' that has type: '" << prim.GetTypeName() << "'" << std::endl;
+          }
+        }
+        schemaNodeDB->unlock();
+        AL_END_PROFILE_SECTION();
+      }
+      batches.clear();
+      batchIndices.clear();
+      batchedPaths.clear();
+    };
+
+    auto hasBatchedAncestor = [&batchedPaths](const SdfPath& path)
+    {
+      if(batchedPaths.empty())
+        return false;
+      for(SdfPath parent = path.GetParentPath(); !parent.IsEmpty(); parent = parent.GetParentPath())
+      {
+        if(batchedPaths.count(parent))
+          return true;
+      }
+      return false;
+    };
+
     auto it = objsToCreate.begin();
     const auto end = objsToCreate.end();
     for(; it != end; ++it)
@@ -428,9 +539,29 @@ void ProxyShapePostLoadProcess::createSchemaPrims(
       fileio::translators::TranslatorRefPtr translator = translatorManufacture.get(prim.GetTypeName());
       Trace("Translator-createSchemaPrims: hasEntry(" << prim.GetPath().GetText() << ", "
             << prim.GetTypeName() << ")=" << schemaNodeDB->hasEntry(prim.GetPath(), prim.GetTypeName()));
+      if(hasBatchedAncestor(prim.GetPath()))
+      {
+        flushBatches();
+      }
       if(!schemaNodeDB->hasEntry(prim.GetPath(), prim.GetTypeName()))
       {
+        if(translator && translator->supportsBatchImport())
+        {
+          auto inserted = batchIndices.emplace(prim.GetTypeName(), batches.size());
+          if(inserted.second)
+          {
+            batches.emplace_back();
+            batches.back().translator = translator;
+          }
+          ImportBatch& batch = batches[inserted.first->second];
+          batch.prims.push_back(prim);
+          batch.parents.push_back(object);
+          batchedPaths.insert(prim.GetPath());
+          continue;
+        }
+
         AL_BEGIN_PROFILE_SECTION(SchemaPrims);
+        AL_PROFILE_SECTION_ARGUMENT(primPath, prim.GetPath().GetString());
         if(fileio::importSchemaPrim(prim, object, 0, context, translator))
         {
           schemaNodeDB->addEntry(prim.GetPath(), object);
@@ -453,6 +584,8 @@ void ProxyShapePostLoadProcess::createSchemaPrims(
         }
       }
     }
+
+    flushBatches();
   }
   AL_END_PROFILE_SECTION();
 }
@@ -481,6 +614,7 @@ void ProxyShapePostLoadProcess::connectSchemaPrims(
     {
       Trace("Translator-PostImport: postImport prim: " << prim.GetPath().GetText());
       AL_BEGIN_PROFILE_SECTION(TranslatorBasePostImport);
+      AL_PROFILE_SECTION_ARGUMENT(translator, prim.GetTypeName().GetString());
       torBase->postImport(prim);
       AL_END_PROFILE_SECTION();
     }
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include "AL/usdmaya/AttributeType.h"
 #include "AL/usdmaya/fileio/ExportParams.h"
 #include "AL/usdmaya/fileio/AnimationTranslator.h"
 #include "AL/usdmaya/fileio/translators/DgNodeTranslator.h"
@@ -25,20 +26,187 @@
 #include "maya/MGlobal.h"
 #include "maya/MFnMesh.h"
 #include "maya/MAnimUtil.h"
+#include "maya/MPlugArray.h"
+#include "maya/MSelectionList.h"
+
+#include "pxr/base/gf/math.h"
+#include "pxr/base/gf/matrix2d.h"
+#include "pxr/base/gf/matrix3d.h"
+#include "pxr/base/gf/matrix4d.h"
+#include "pxr/base/gf/vec2d.h"
+#include "pxr/base/gf/vec2f.h"
+#include "pxr/base/gf/vec3d.h"
+#include "pxr/base/gf/vec3f.h"
+#include "pxr/base/gf/vec4d.h"
+#include "pxr/base/gf/vec4f.h"
+#include "pxr/usd/sdf/attributeSpec.h"
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/sdf/primSpec.h"
+#include "pxr/usd/usd/editTarget.h"
+
+#include <algorithm>
 
 namespace AL {
 namespace usdmaya {
 namespace fileio {
 
 //----------------------------------------------------------------------------------------------------------------------
-bool AnimationTranslator::isAnimated(MPlug attr, const bool assumeExpressionIsAnimated)
+UpstreamAnimationCache::State UpstreamAnimationCache::find(const MObject& node, const Query query, const bool upstream) const
+{
+  const MObjectHandle handle(node);
+  auto range = m_nodes.equal_range(handle.hashCode());
+  for(auto it = range.first; it != range.second; ++it)
+  {
+    if(it->second.node == handle)
+    {
+      return upstream ? it->second.upstream[query] : it->second.self[query];
+    }
+  }
+  return kUnknown;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void UpstreamAnimationCache::set(const MObject& node, const Query query, const bool upstream, const State state)
+{
+  const MObjectHandle handle(node);
+  const uint32_t hashCode = handle.hashCode();
+  auto range = m_nodes.equal_range(hashCode);
+  auto it = range.first;
+  for(; it != range.second; ++it)
+  {
+    if(it->second.node == handle)
+      break;
+  }
+  if(it == range.second)
+  {
+    Entry entry;
+    entry.node = handle;
+    std::fill(entry.self, entry.self + kNumQueries, kUnknown);
+    std::fill(entry.upstream, entry.upstream + kNumQueries, kUnknown);
+    it = m_nodes.emplace(hashCode, entry);
+  }
+  (upstream ? it->second.upstream : it->second.self)[query] = state;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns true if the node itself is a source of animation for the specified query
+//----------------------------------------------------------------------------------------------------------------------
+bool isAnimationSource(const MObject& node, const UpstreamAnimationCache::Query query, UpstreamAnimationCache* cache)
+{
+  if(cache)
+  {
+    const UpstreamAnimationCache::State state = cache->find(node, query, false);
+    if(state != UpstreamAnimationCache::kUnknown)
+      return state == UpstreamAnimationCache::kAnimated;
+  }
+
+  bool animated = false;
+  if(query != UpstreamAnimationCache::kTransform && node.hasFn(MFn::kTime))
+  {
+    animated = true;
+  }
+  else
+  if(query == UpstreamAnimationCache::kTimeOrExpression && node.hasFn(MFn::kExpression))
+  {
+    animated = true;
+  }
+  else
+  if((node.hasFn(MFn::kTransform) || node.hasFn(MFn::kPluginTransformNode)) && MAnimUtil::isAnimated(node, true))
+  {
+    animated = true;
+  }
+
+  if(cache)
+    cache->set(node, query, false, animated ? UpstreamAnimationCache::kAnimated : UpstreamAnimationCache::kStatic);
+  return animated;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  walks upstream from the node (inclusive) looking for a source of animation. When a cache is provided, any
+///         node already known to be static is pruned from the walk, and when the walk finds no animation, every node
+///         visited is recorded as static (since everything upstream of those nodes was also visited).
+//----------------------------------------------------------------------------------------------------------------------
+bool isUpstreamAnimated(const MObject& node, const UpstreamAnimationCache::Query query, UpstreamAnimationCache* cache)
+{
+  if(cache)
+  {
+    const UpstreamAnimationCache::State state = cache->find(node, query, true);
+    if(state != UpstreamAnimationCache::kUnknown)
+      return state == UpstreamAnimationCache::kAnimated;
+  }
+
+  MStatus status;
+  MObject root(node);
+  MItDependencyGraph iter(
+    root,
+    MFn::kInvalid,
+    MItDependencyGraph::kUpstream,
+    MItDependencyGraph::kDepthFirst,
+    MItDependencyGraph::kNodeLevel,
+    &status);
+
+  if (!status)
+  {
+    MGlobal::displayError("Unable to create DG iterator");
+    return false;
+  }
+
+  bool animated = false;
+  std::vector<MObject> visited;
+  for(; !iter.isDone(); iter.next())
+  {
+    MObject currNode = iter.currentItem();
+    if(cache && currNode != node)
+    {
+      const UpstreamAnimationCache::State state = cache->find(currNode, query, true);
+      if(state == UpstreamAnimationCache::kStatic)
+      {
+        iter.prune();
+        continue;
+      }
+      if(state == UpstreamAnimationCache::kAnimated)
+      {
+        animated = true;
+        break;
+      }
+    }
+    if(isAnimationSource(currNode, query, cache))
+    {
+      animated = true;
+      break;
+    }
+    if(cache)
+      visited.push_back(currNode);
+  }
+
+  if(cache)
+  {
+    if(animated)
+    {
+      cache->set(node, query, true, UpstreamAnimationCache::kAnimated);
+    }
+    else
+    {
+      for(const MObject& visitedNode : visited)
+        cache->set(visitedNode, query, true, UpstreamAnimationCache::kStatic);
+    }
+  }
+  return animated;
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+bool AnimationTranslator::isAnimated(MPlug attr, const bool assumeExpressionIsAnimated, UpstreamAnimationCache* cache)
 {
   if(attr.isArray())
   {
     const uint32_t numElements = attr.numElements();
     for(uint32_t i = 0; i < numElements; ++i)
     {
-      if(isAnimated(attr.elementByLogicalIndex(i), assumeExpressionIsAnimated))
+      if(isAnimated(attr.elementByLogicalIndex(i), assumeExpressionIsAnimated, cache))
       {
         return true;
       }
@@ -51,7 +219,7 @@ bool AnimationTranslator::isAnimated(MPlug attr, const bool assumeExpressionIsAn
     const uint32_t numChildren = attr.numChildren();
     for(uint32_t i = 0; i < numChildren; ++i)
     {
-      if(isAnimated(attr.child(i), assumeExpressionIsAnimated))
+      if(isAnimated(attr.child(i), assumeExpressionIsAnimated, cache))
       {
         return true;
       }
@@ -59,13 +227,13 @@ bool AnimationTranslator::isAnimated(MPlug attr, const bool assumeExpressionIsAn
   }
 
   // is no connections exist, it cannot be animated
+  MPlugArray plugs;
   if(!attr.isConnected())
   {
     return false;
   }
   else
   {
-    MPlugArray plugs;
     if(!attr.connectedTo(plugs, true, false))
     {
       return false;
@@ -100,34 +268,15 @@ bool AnimationTranslator::isAnimated(MPlug attr, const bool assumeExpressionIsAn
   }
 
   // if we get here, recurse through the upstream connections looking for a time or expression node
-  MStatus status;
-  MItDependencyGraph iter(
-    attr,
-    MFn::kInvalid,
-    MItDependencyGraph::kUpstream,
-    MItDependencyGraph::kDepthFirst,
-    MItDependencyGraph::kNodeLevel,
-    &status);
-
-  if (!status)
+  const UpstreamAnimationCache::Query query = assumeExpressionIsAnimated ?
+      UpstreamAnimationCache::kTimeOrExpression : UpstreamAnimationCache::kTime;
+  if(isAnimationSource(attr.node(), query, cache))
   {
-    MGlobal::displayError("Unable to create DG iterator");
-    return false;
+    return true;
   }
-
-  for(; !iter.isDone(); iter.next())
+  for(uint32_t i = 0, n = plugs.length(); i < n; ++i)
   {
-    MObject currNode = iter.thisPlug().node();
-    if(currNode.hasFn(MFn::kTime))
-    {
-      return true;
-    }
-    if(assumeExpressionIsAnimated && currNode.hasFn(MFn::kExpression))
-    {
-      return true;
-    }
-    if ((currNode.hasFn(MFn::kTransform) || currNode.hasFn(MFn::kPluginTransformNode)) &&
-        MAnimUtil::isAnimated(currNode, true))
+    if(isUpstreamAnimated(plugs[i].node(), query, cache))
     {
       return true;
     }
@@ -136,37 +285,168 @@ bool AnimationTranslator::isAnimated(MPlug attr, const bool assumeExpressionIsAn
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-bool AnimationTranslator::isAnimatedMesh(const MDagPath& mesh)
+bool AnimationTranslator::isAnimatedMesh(const MDagPath& mesh, UpstreamAnimationCache* cache)
 {
   if (MAnimUtil::isAnimated(mesh, true))
   {
     return true;
   }
-  MStatus status;
-  MObject node = mesh.node();
-  MItDependencyGraph iter(
-    node,
-    MFn::kInvalid,
-    MItDependencyGraph::kUpstream,
-    MItDependencyGraph::kDepthFirst,
-    MItDependencyGraph::kNodeLevel,
-    &status);
-  if (!status)
+  return isUpstreamAnimated(mesh.node(), UpstreamAnimationCache::kTransform, cache);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  an animated plug whose components are either static, or driven directly by an anim curve on time, and which
+///         can therefore be sampled by evaluating the curves rather than by changing the current time.
+//----------------------------------------------------------------------------------------------------------------------
+struct CurveSampledPlug
+{
+  MObject curves[3]; ///< the curve driving each component, or a null object if the component is static
+  double values[3]; ///< the value of each static component
+  uint32_t numComponents;
+  UsdDataType type;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the scene time node (time1), which drives anim curves with the current time
+//----------------------------------------------------------------------------------------------------------------------
+MObject getSceneTimeNode()
+{
+  MSelectionList sl;
+  MObject node;
+  if(!sl.add("time1") || !sl.getDependNode(0, node) || !node.hasFn(MFn::kTime))
+    return MObject::kNullObj;
+  return node;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  determines whether the plug is static, or driven directly by an animation curve that is driven by time
+/// \param  plug the plug to test
+/// \param  timeNode the scene time node
+/// \param  curve returns the curve driving the plug, or a null object if the plug is static
+/// \return true if the plug is static or driven directly by a curve, false if it has a more complex upstream graph
+//----------------------------------------------------------------------------------------------------------------------
+bool getDrivingCurve(const MPlug& plug, const MObject& timeNode, MObject& curve)
+{
+  curve = MObject::kNullObj;
+  MPlugArray sources;
+  if(!plug.connectedTo(sources, true, false) || !sources.length())
+    return true;
+  if(sources.length() != 1)
+    return false;
+
+  MObject node = sources[0].node();
+  switch(node.apiType())
   {
-    MGlobal::displayError("Unable to create DG iterator");
+  case MFn::kAnimCurveTimeToAngular:
+  case MFn::kAnimCurveTimeToDistance:
+  case MFn::kAnimCurveTimeToUnitless:
+    break;
+  default:
     return false;
   }
-  for (; !iter.isDone(); iter.next())
+
+  // the curve input must either be unconnected (in which case the curve is driven by the current time), or connected
+  // directly to the scene time node. Any other time node may be offset or scaled from the current time.
+  MPlug input = MFnDependencyNode(node).findPlug("input", true);
+  MPlugArray inputs;
+  if(input.connectedTo(inputs, true, false) && inputs.length() && (timeNode.isNull() || inputs[0].node() != timeNode))
+    return false;
+
+  curve = node;
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  determines whether the animated plug can be sampled directly from its animation curves
+/// \param  plug the animated plug
+/// \param  attribute the USD attribute the plug is exported to
+/// \param  timeNode the scene time node
+/// \param  result returns the curves and static values of each component
+/// \return true if the plug can be sampled from its curves
+//----------------------------------------------------------------------------------------------------------------------
+bool getCurveSampledPlug(const MPlug& plug, const UsdAttribute& attribute, const MObject& timeNode, CurveSampledPlug& result)
+{
+  result.type = getAttributeType(attribute);
+  switch(result.type)
+  {
+  case UsdDataType::kFloat:
+  case UsdDataType::kDouble:
+    if(plug.isArray() || plug.isCompound())
+      return false;
+    result.numComponents = 1;
+    break;
+
+  case UsdDataType::kVec3f:
+  case UsdDataType::kVec3d:
+    if(plug.isArray() || !plug.isCompound() || plug.numChildren() != 3)
+      return false;
+    result.numComponents = 3;
+    break;
+
+  default:
+    return false;
+  }
+
+  bool hasCurve = false;
+  for(uint32_t i = 0; i < result.numComponents; ++i)
+  {
+    MPlug component = result.numComponents == 1 ? plug : plug.child(i);
+    if(component.isArray() || component.isCompound())
+      return false;
+    if(!getDrivingCurve(component, timeNode, result.curves[i]))
+      return false;
+    if(result.curves[i].isNull())
+      result.values[i] = component.asDouble();
+    else
+      hasCurve = true;
+  }
+  return hasCurve;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  samples the plug over the exported frame range by evaluating its animation curves
+/// \param  plug the plug to sample
+/// \param  attribute the USD attribute to write the samples into
+/// \param  scale a scale to apply to convert units
+/// \param  params the export options
+/// \param  filter the sample filter for the attribute
+//----------------------------------------------------------------------------------------------------------------------
+void sampleCurves(const CurveSampledPlug& plug, const UsdAttribute& attribute, const float scale,
+                  const ExporterParams& params, SampleFilter& filter)
+{
+  MFnAnimCurve fnCurves[3];
+  for(uint32_t i = 0; i < plug.numComponents; ++i)
   {
-    MObject currNode = iter.thisPlug().node();
-    if ((currNode.hasFn(MFn::kTransform) || currNode.hasFn(MFn::kPluginTransformNode))
-        && MAnimUtil::isAnimated(currNode, true))
+    if(!plug.curves[i].isNull())
+      fnCurves[i].setObject(plug.curves[i]);
+  }
+
+  VtValue sample;
+  double values[3];
+  for(double t = params.m_minFrame, e = params.m_maxFrame + 1e-3f; t < e; t += 1.0)
+  {
+    const MTime time(t);
+    for(uint32_t i = 0; i < plug.numComponents; ++i)
     {
-      return true;
+      values[i] = plug.curves[i].isNull() ? plug.values[i] : fnCurves[i].evaluate(time);
     }
+
+    // match the precision of the values read from the plugs by DgNodeTranslator::getAttributeValue
+    switch(plug.type)
+    {
+    case UsdDataType::kFloat: sample = float(values[0]) * scale; break;
+    case UsdDataType::kDouble: sample = values[0] * scale; break;
+    case UsdDataType::kVec3f: sample = GfVec3f(values[0], values[1], values[2]) * scale; break;
+    case UsdDataType::kVec3d: sample = GfVec3d(values[0], values[1], values[2]) * scale; break;
+    default: return;
+    }
+    filter.addSample(attribute, sample, t);
   }
-  return false;
 }
+} // anon
 
 //----------------------------------------------------------------------------------------------------------------------
 void AnimationTranslator::exportAnimation(const ExporterParams& params)
@@ -184,36 +464,284 @@ void AnimationTranslator::exportAnimation(const ExporterParams& params)
      (startTransformAttrib != endTransformAttrib) ||
      (startMesh != endMesh))
   {
-    for(double t = params.m_minFrame, e = params.m_maxFrame + 1e-3f; t < e; t += 1.0)
+    const SampleFilter prototype(params.m_filterSample, params.m_filterTolerance);
+    std::vector<SampleFilter> attribFilters(m_animatedPlugs.size(), prototype);
+    std::vector<SampleFilter> attribScaledFilters(m_scaledAnimatedPlugs.size(), prototype);
+    std::vector<SampleFilter> transformAttribFilters(m_animatedTransformPlugs.size(), prototype);
+    std::vector<SampleFilter> meshFilters(m_animatedMeshes.size(), prototype);
+
+    // Plugs driven directly by anim curves are sampled by evaluating the curves, which avoids re-evaluating the scene
+    // for each frame. Only the remaining plugs (and the meshes) require the current time to be changed.
+    std::vector<bool> attribFromCurves(m_animatedPlugs.size(), false);
+    std::vector<bool> attribScaledFromCurves(m_scaledAnimatedPlugs.size(), false);
+    bool requiresTimeChange = (startTransformAttrib != endTransformAttrib) || (startMesh != endMesh);
+    {
+      SdfChangeBlock changeBlock;
+      CurveSampledPlug curvePlug;
+      const MObject timeNode = getSceneTimeNode();
+      for(size_t i = 0, n = m_animatedPlugs.size(); i < n; ++i)
+      {
+        const PlugAttrPair& plugAttr = m_animatedPlugs[i];
+        attribFromCurves[i] = getCurveSampledPlug(plugAttr.first, plugAttr.second, timeNode, curvePlug);
+        if(attribFromCurves[i])
+          sampleCurves(curvePlug, plugAttr.second, 1.0f, params, attribFilters[i]);
+        else
+          requiresTimeChange = true;
+      }
+      for(size_t i = 0, n = m_scaledAnimatedPlugs.size(); i < n; ++i)
+      {
+        const PlugAttrScaledPair& plugAttr = m_scaledAnimatedPlugs[i];
+        attribScaledFromCurves[i] = getCurveSampledPlug(plugAttr.first.first, plugAttr.first.second, timeNode, curvePlug);
+        if(attribScaledFromCurves[i])
+          sampleCurves(curvePlug, plugAttr.first.second, plugAttr.second, params, attribScaledFilters[i]);
+        else
+          requiresTimeChange = true;
+      }
+    }
+
+    VtValue sample;
+    VtArray<GfVec3f> points;
+    for(double t = params.m_minFrame, e = params.m_maxFrame + 1e-3f; requiresTimeChange && t < e; t += 1.0)
     {
       MAnimControl::setCurrentTime(t);
-      UsdTimeCode timeCode(t);
-      for(auto it = startAttrib; it != endAttrib; ++it)
+
+      // batch up all of the layer edits for this frame into a single change notification
+      SdfChangeBlock changeBlock;
+      auto filter = attribFilters.begin();
+      auto fromCurves = attribFromCurves.begin();
+      for(auto it = startAttrib; it != endAttrib; ++it, ++filter, ++fromCurves)
       {
+        if(*fromCurves)
+          continue;
         /// \todo This feels wrong. Split the DgNodeTranslator class into 3 ...
         ///         maya::Dg
         ///         usdmaya::Dg
         ///         usdmaya::fileio::translator::Dg
-        translators::DgNodeTranslator::copyAttributeValue(it->first, it->second, timeCode);
+        sample = VtValue();
+        if(translators::DgNodeTranslator::getAttributeValue(it->first, it->second, sample))
+          filter->addSample(it->second, sample, t);
       }
-      for(auto it = startAttribScaled; it != endAttribScaled; ++it)
+      filter = attribScaledFilters.begin();
+      fromCurves = attribScaledFromCurves.begin();
+      for(auto it = startAttribScaled; it != endAttribScaled; ++it, ++filter, ++fromCurves)
       {
+        if(*fromCurves)
+          continue;
         /// \todo This feels wrong. Split the DgNodeTranslator class into 3 ...
         ///         maya::Dg
         ///         usdmaya::Dg
         ///         usdmaya::fileio::translator::Dg
-        translators::DgNodeTranslator::copyAttributeValue(it->first.first, it->first.second, it->second, timeCode);
+        sample = VtValue();
+        if(translators::DgNodeTranslator::getAttributeValue(it->first.first, it->first.second, it->second, sample))
+          filter->addSample(it->first.second, sample, t);
+      }
+      filter = transformAttribFilters.begin();
+      for (auto it = startTransformAttrib; it != endTransformAttrib; ++it, ++filter)
+      {
+        sample = VtValue();
+        if(translators::TransformTranslator::getAttributeValue(it->first, it->second, sample))
+          filter->addSample(it->second, sample, t);
       }
-      for (auto it = startTransformAttrib; it != endTransformAttrib; ++it)
+      filter = meshFilters.begin();
+      for(auto it = startMesh; it != endMesh; ++it, ++filter)
       {
-        translators::TransformTranslator::copyAttributeValue(it->first, it->second, timeCode);
+        if(translators::MeshTranslator::getVertexData(MFnMesh(it->first), points))
+        {
+          sample = points;
+          filter->addSample(it->second, sample, t);
+        }
       }
-      for(auto it = startMesh; it != endMesh; ++it)
+    }
+
+    sample = VtValue();
+    points = VtArray<GfVec3f>();
+
+    SdfChangeBlock changeBlock;
+    auto filter = attribFilters.begin();
+    for(auto it = startAttrib; it != endAttrib; ++it, ++filter)
+      filter->finish(it->second);
+    filter = attribScaledFilters.begin();
+    for(auto it = startAttribScaled; it != endAttribScaled; ++it, ++filter)
+      filter->finish(it->first.second);
+    filter = transformAttribFilters.begin();
+    for(auto it = startTransformAttrib; it != endTransformAttrib; ++it, ++filter)
+      filter->finish(it->second);
+    filter = meshFilters.begin();
+    for(auto it = startMesh; it != endMesh; ++it, ++filter)
+      filter->finish(it->second);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static inline bool isCloseValue(const VtValue& a, const VtValue& b, const double tolerance)
+{
+  return GfIsClose(a.UncheckedGet<T>(), b.UncheckedGet<T>(), tolerance);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+static inline bool isCloseArray(const VtValue& a, const VtValue& b, const double tolerance)
+{
+  const VtArray<T>& arrayA = a.UncheckedGet<VtArray<T> >();
+  const VtArray<T>& arrayB = b.UncheckedGet<VtArray<T> >();
+  const size_t n = arrayA.size();
+  if(n != arrayB.size())
+    return false;
+  const T* const dataA = arrayA.cdata();
+  const T* const dataB = arrayB.cdata();
+  if(dataA == dataB)
+    return true;
+  for(size_t i = 0; i < n; ++i)
+  {
+    if(!GfIsClose(dataA[i], dataB[i], tolerance))
+      return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool SampleFilter::isEqual(const VtValue& a, const VtValue& b, const double tolerance)
+{
+  if(tolerance <= 0.0 || a.GetType() != b.GetType())
+    return a == b;
+
+  if(a.IsHolding<float>()) return isCloseValue<float>(a, b, tolerance);
+  if(a.IsHolding<double>()) return isCloseValue<double>(a, b, tolerance);
+  if(a.IsHolding<GfVec2f>()) return isCloseValue<GfVec2f>(a, b, tolerance);
+  if(a.IsHolding<GfVec3f>()) return isCloseValue<GfVec3f>(a, b, tolerance);
+  if(a.IsHolding<GfVec4f>()) return isCloseValue<GfVec4f>(a, b, tolerance);
+  if(a.IsHolding<GfVec2d>()) return isCloseValue<GfVec2d>(a, b, tolerance);
+  if(a.IsHolding<GfVec3d>()) return isCloseValue<GfVec3d>(a, b, tolerance);
+  if(a.IsHolding<GfVec4d>()) return isCloseValue<GfVec4d>(a, b, tolerance);
+  if(a.IsHolding<GfMatrix2d>()) return isCloseValue<GfMatrix2d>(a, b, tolerance);
+  if(a.IsHolding<GfMatrix3d>()) return isCloseValue<GfMatrix3d>(a, b, tolerance);
+  if(a.IsHolding<GfMatrix4d>()) return isCloseValue<GfMatrix4d>(a, b, tolerance);
+  if(a.IsHolding<VtArray<float> >()) return isCloseArray<float>(a, b, tolerance);
+  if(a.IsHolding<VtArray<double> >()) return isCloseArray<double>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfVec2f> >()) return isCloseArray<GfVec2f>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfVec3f> >()) return isCloseArray<GfVec3f>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfVec4f> >()) return isCloseArray<GfVec4f>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfVec2d> >()) return isCloseArray<GfVec2d>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfVec3d> >()) return isCloseArray<GfVec3d>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfVec4d> >()) return isCloseArray<GfVec4d>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfMatrix2d> >()) return isCloseArray<GfMatrix2d>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfMatrix3d> >()) return isCloseArray<GfMatrix3d>(a, b, tolerance);
+  if(a.IsHolding<VtArray<GfMatrix4d> >()) return isCloseArray<GfMatrix4d>(a, b, tolerance);
+
+  // integer, boolean, token and string types are always compared exactly
+  return a == b;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void SampleFilter::write(const UsdAttribute& attribute, const VtValue& value, const UsdTimeCode time)
+{
+  // The samples are written within SdfChangeBlocks, so they must not go through UsdAttribute::Set (the stage may need
+  // to recompose in the middle of the block). The first time we write, locate the attribute spec in the edit target,
+  // authoring it through the Sdf API if the attribute has only been defined in another layer.
+  if(!m_resolved)
+  {
+    m_resolved = true;
+    const UsdEditTarget target = attribute.GetStage()->GetEditTarget();
+    const SdfLayerHandle layer = target.GetLayer();
+    const SdfPath specPath = target.MapToSpecPath(attribute.GetPath());
+    SdfAttributeSpecHandle spec = layer->GetAttributeAtPath(specPath);
+    if(!spec)
+    {
+      SdfPrimSpecHandle primSpec = SdfCreatePrimInLayer(layer, specPath.GetPrimPath());
+      if(primSpec)
       {
-        translators::MeshTranslator::copyVertexData(MFnMesh(it->first), it->second, timeCode);
+        spec = SdfAttributeSpec::New(primSpec, attribute.GetName(), attribute.GetTypeName(),
+                                     attribute.GetVariability(), attribute.IsCustom());
       }
     }
+    if(!spec)
+    {
+      MGlobal::displayError(MString("SampleFilter: unable to author the attribute \"") +
+                            attribute.GetPath().GetText() + "\"");
+      return;
+    }
+    m_layer = layer;
+    m_specPath = specPath;
+    m_valueType = spec->GetTypeName().GetType();
+  }
+
+  if(!m_layer)
+    return;
+
+  // the sampled data may not match the type of the attribute (e.g. a double plug exported to a float attribute), in
+  // which case the value is cast in the same way UsdAttribute::Set would do.
+  VtValue castValue;
+  const VtValue* toWrite = &value;
+  if(value.GetType() != m_valueType)
+  {
+    castValue = VtValue::CastToTypeid(value, m_valueType.GetTypeid());
+    if(castValue.IsEmpty())
+    {
+      MGlobal::displayError(MString("SampleFilter: unable to convert the value of \"") +
+                            attribute.GetPath().GetText() + "\" to " + m_valueType.GetTypeName().c_str());
+      return;
+    }
+    toWrite = &castValue;
+  }
+
+  if(time.IsDefault())
+    m_layer->SetField(m_specPath, SdfFieldKeys->Default, *toWrite);
+  else
+    m_layer->SetTimeSample(m_specPath, time.GetValue(), *toWrite);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void SampleFilter::addSample(const UsdAttribute& attribute, const VtValue& sample, const double time)
+{
+  if(!m_enabled)
+  {
+    write(attribute, sample, UsdTimeCode(time));
+    return;
+  }
+
+  // the first sample starts the first run of values, but nothing is written until we know the value changes.
+  if(m_runValue.IsEmpty())
+  {
+    m_runValue = sample;
+    m_runStart = m_runEnd = time;
+    return;
+  }
+
+  // extend the current run of values
+  if(isEqual(m_runValue, sample, m_tolerance))
+  {
+    m_runEnd = time;
+    return;
+  }
+
+  // The value has changed. Make sure the start of the run is written (only the first run needs this, the start of
+  // each subsequent run is written as soon as the change is detected), and close the run with a sample on its last
+  // frame so that interpolation across the constant section remains correct.
+  if(!m_varying)
+  {
+    write(attribute, m_runValue, UsdTimeCode(m_runStart));
+    m_varying = true;
+  }
+  if(m_runEnd != m_runStart)
+  {
+    write(attribute, m_runValue, UsdTimeCode(m_runEnd));
+  }
+  write(attribute, sample, UsdTimeCode(time));
+  m_runValue = sample;
+  m_runStart = m_runEnd = time;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void SampleFilter::finish(const UsdAttribute& attribute)
+{
+  // if the value never changed, collapse it into the default value
+  if(m_enabled && !m_varying && !m_runValue.IsEmpty())
+  {
+    write(attribute, m_runValue, UsdTimeCode::Default());
   }
+  m_runValue = VtValue();
+  m_varying = false;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -18,10 +18,14 @@
 
 #include "maya/MPlug.h"
 #include "maya/MDagPath.h"
+#include "maya/MObjectHandle.h"
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
 #include "pxr/pxr.h"
+#include "pxr/base/tf/type.h"
+#include "pxr/usd/sdf/layer.h"
 #include "pxr/usd/usd/stage.h"
 
 PXR_NAMESPACE_USING_DIRECTIVE
@@ -37,6 +41,114 @@ typedef std::vector<MeshAttrPair> MeshAttrVector;
 typedef std::pair<PlugAttrPair, float> PlugAttrScaledPair;
 typedef std::vector<PlugAttrScaledPair> PlugAttrScaledVector;
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Removes redundant time samples from an animated attribute while the animation is being sampled. Only the
+///         value of the current run of identical samples is retained, so the first and last sample of each constant
+///         run are the only ones written to the layer. If the value never changes over the exported frame range, it
+///         is written as the default value instead, and no time samples are authored at all.
+///         Samples are authored directly on the attribute spec in the edit target layer (which is created if needed),
+///         which avoids the per-sample overhead of the composed UsdStage API, and allows the caller to batch the
+///         writes within an SdfChangeBlock.
+/// \ingroup   fileio
+//----------------------------------------------------------------------------------------------------------------------
+class SampleFilter
+{
+public:
+
+  /// \brief  ctor
+  /// \param  enabled if false, every sample is written to the attribute as is
+  /// \param  tolerance the tolerance used when comparing floating point values. If zero, values must match exactly.
+  SampleFilter(const bool enabled = true, const double tolerance = 0.0)
+    : m_tolerance(tolerance), m_enabled(enabled) {}
+
+  /// \brief  process the next sample for the attribute
+  /// \param  attribute the attribute to write the sample to
+  /// \param  sample the value of the attribute at the specified time
+  /// \param  time the time of the sample. Samples must be provided in increasing time order.
+  void addSample(const UsdAttribute& attribute, const VtValue& sample, double time);
+
+  /// \brief  flushes any pending data once all samples have been provided
+  /// \param  attribute the attribute to write the remaining data to
+  void finish(const UsdAttribute& attribute);
+
+  /// \brief  compares two sampled values
+  /// \param  a the first value
+  /// \param  b the second value
+  /// \param  tolerance the tolerance to use when comparing float, double, vector and matrix values (and arrays of)
+  /// \return true if the values are considered equal
+  static bool isEqual(const VtValue& a, const VtValue& b, double tolerance);
+
+private:
+  void write(const UsdAttribute& attribute, const VtValue& value, UsdTimeCode time);
+
+  VtValue m_runValue;
+  SdfLayerHandle m_layer;
+  SdfPath m_specPath;
+  TfType m_valueType;
+  double m_runStart = 0;
+  double m_runEnd = 0;
+  double m_tolerance;
+  bool m_enabled;
+  bool m_varying = false;
+  bool m_resolved = false;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Memoises the results of the upstream DG walks made by AnimationTranslator::isAnimated and
+///         AnimationTranslator::isAnimatedMesh. Networks shared by many of the exported plugs (e.g. the global control
+///         of a rig) are then only traversed once per export, rather than once per plug.
+/// \ingroup   fileio
+//----------------------------------------------------------------------------------------------------------------------
+class UpstreamAnimationCache
+{
+public:
+
+  /// \brief  the questions that can be asked of a node
+  enum Query
+  {
+    kTimeOrExpression, ///< is the node a time node, an expression, or an animated transform
+    kTime, ///< is the node a time node, or an animated transform
+    kTransform, ///< is the node an animated transform
+    kNumQueries
+  };
+
+  /// \brief  the memoised answer to a query
+  enum State : uint8_t
+  {
+    kUnknown, ///< the query has not been made
+    kStatic, ///< the answer was false
+    kAnimated ///< the answer was true
+  };
+
+  /// \brief  returns the memoised answer to the query for the node
+  /// \param  node the node to query
+  /// \param  query the query to make
+  /// \param  upstream if true, the answer for the node and everything upstream of it is returned. If false, the answer
+  ///         for the node alone is returned.
+  /// \return the memoised answer, or kUnknown
+  State find(const MObject& node, Query query, bool upstream) const;
+
+  /// \brief  memoises the answer to a query for the node
+  /// \param  node the node
+  /// \param  query the query that was made
+  /// \param  upstream true if the answer covers everything upstream of the node, false if it is for the node alone
+  /// \param  state the answer
+  void set(const MObject& node, Query query, bool upstream, State state);
+
+  /// \brief  discards all memoised results
+  void clear()
+    { m_nodes.clear(); }
+
+private:
+  struct Entry
+  {
+    MObjectHandle node;
+    State self[kNumQueries];
+    State upstream[kNumQueries];
+  };
+  std::unordered_multimap<uint32_t, Entry> m_nodes;
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  A utility class to help with exporting animated plugs from maya
 /// \ingroup   fileio
@@ -48,21 +160,39 @@ struct AnimationTranslator
   /// \param  attr the attribute handle
   /// \param  assumeExpressionIsAnimated if we encounter an expression, assume that the attribute is animated (true) or
   ///         static (false).
+  /// \param  cache if specified, the results of the upstream DG walks are shared with all other queries using the cache
   /// \return true if the attribute was found to be animated
-  static bool isAnimated(const MObject& node, const MObject& attr, const bool assumeExpressionIsAnimated = true)
-    { return isAnimated(MPlug(node, attr), assumeExpressionIsAnimated); }
+  static bool isAnimated(const MObject& node, const MObject& attr, const bool assumeExpressionIsAnimated = true,
+                         UpstreamAnimationCache* cache = 0)
+    { return isAnimated(MPlug(node, attr), assumeExpressionIsAnimated, cache); }
 
   /// \brief  returns true if the attribute is animated
   /// \param  attr the attribute to test
   /// \param  assumeExpressionIsAnimated if we encounter an expression, assume that the attribute is animated (true) or
   ///         static (false).
+  /// \param  cache if specified, the results of the upstream DG walks are shared with all other queries using the cache
   /// \return true if the attribute was found to be animated
-  static bool isAnimated(MPlug attr, bool assumeExpressionIsAnimated = true);
+  static bool isAnimated(MPlug attr, bool assumeExpressionIsAnimated = true, UpstreamAnimationCache* cache = 0);
 
   /// \brief  returns true if the mesh is animated
   /// \param  mesh the mesh to test
+  /// \param  cache if specified, the results of the upstream DG walks are shared with all other queries using the cache
+  /// \return true if the mesh was found to be animated
+  static bool isAnimatedMesh(const MDagPath& mesh, UpstreamAnimationCache* cache = 0);
+
+  /// \brief  returns true if the attribute is animated. The upstream DG walks are memoised for the rest of the export.
+  /// \param  plug the attribute to test
+  /// \param  assumeExpressionIsAnimated if we encounter an expression, assume that the attribute is animated (true) or
+  ///         static (false).
+  /// \return true if the attribute was found to be animated
+  inline bool isPlugAnimated(const MPlug& plug, const bool assumeExpressionIsAnimated)
+    { return isAnimated(plug, assumeExpressionIsAnimated, &m_upstreamCache); }
+
+  /// \brief  returns true if the mesh is animated. The upstream DG walks are memoised for the rest of the export.
+  /// \param  mesh the mesh to test
   /// \return true if the mesh was found to be animated
-  static bool isAnimatedMesh(const MDagPath& mesh);
+  inline bool isMeshAnimated(const MDagPath& mesh)
+    { return isAnimatedMesh(mesh, &m_upstreamCache); }
 
   /// \brief  add a plug to the animation translator (if the plug is animated)
   /// \param  plug the maya attribute to test
@@ -71,7 +201,7 @@ struct AnimationTranslator
   ///         static (false).
   inline void addPlug(const MPlug& plug, const UsdAttribute& attribute, const bool assumeExpressionIsAnimated)
   {
-    if(isAnimated(plug, assumeExpressionIsAnimated))
+    if(isPlugAnimated(plug, assumeExpressionIsAnimated))
       m_animatedPlugs.emplace_back(std::make_pair(plug, attribute));
   }
 
@@ -83,7 +213,7 @@ struct AnimationTranslator
   ///         static (false).
   inline void addPlug(const MPlug& plug, const UsdAttribute& attribute, const float scale, const bool assumeExpressionIsAnimated)
   {
-    if(isAnimated(plug, assumeExpressionIsAnimated))
+    if(isPlugAnimated(plug, assumeExpressionIsAnimated))
       m_scaledAnimatedPlugs.emplace_back(std::make_pair(std::make_pair(plug, attribute), scale));
   }
 
@@ -95,7 +225,7 @@ struct AnimationTranslator
   ///         static (false).
   inline void addTransformPlug(const MPlug& plug, const UsdAttribute& attribute, const bool assumeExpressionIsAnimated)
   {
-    if (isAnimated(plug, assumeExpressionIsAnimated))
+    if (isPlugAnimated(plug, assumeExpressionIsAnimated))
       m_animatedTransformPlugs.emplace_back(plug, attribute);
   }
 
@@ -110,7 +240,8 @@ struct AnimationTranslator
     m_animatedMeshes.emplace_back(path, attribute);
   }
 
-  /// \brief  After the scene has been exported, call this method to export the animation data on various attributes
+  /// \brief  After the scene has been exported, call this method to export the animation data on various attributes.
+  ///         If params.m_filterSample is set, duplicate samples are discarded as they are generated.
   /// \param  params the export options
   void exportAnimation(const ExporterParams& params);
 
@@ -119,6 +250,7 @@ private:
   PlugAttrScaledVector m_scaledAnimatedPlugs;
   PlugAttrVector m_animatedTransformPlugs;
   MeshAttrVector m_animatedMeshes;
+  UpstreamAnimationCache m_upstreamCache;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
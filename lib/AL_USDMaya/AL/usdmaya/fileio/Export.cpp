@@ -190,58 +190,17 @@ struct Export::Impl
     }
   }
 
-  void filterSample()
-  {
-    std::vector<double> timeSamples;
-    std::vector<double> dupSamples;
-    for (auto prim : m_stage->Traverse())
-    {
-      std::vector<UsdAttribute> attributes = prim.GetAuthoredAttributes();
-      for (auto attr : attributes)
-      {
-        timeSamples.clear();
-        dupSamples.clear();
-        attr.GetTimeSamples(&timeSamples);
-        VtValue prevSampleBlob;
-        for (auto sample : timeSamples)
-        {
-          VtValue currSampleBlob;
-          attr.Get(&currSampleBlob, sample);
-          if (prevSampleBlob == currSampleBlob)
-          {
-            dupSamples.emplace_back(sample);
-          }
-          else
-          {
-            prevSampleBlob = currSampleBlob;
-            // only clear samples between constant segment
-            if (dupSamples.size() > 1)
-            {
-              dupSamples.pop_back();
-              for (auto dup : dupSamples)
-              {
-                attr.ClearAtTime(dup);
-              }
-            }
-            dupSamples.clear();
-          }
-        }
-        for (auto dup : dupSamples)
-        {
-          attr.ClearAtTime(dup);
-        }
-      }
-    }
-  }
-
-  void doExport(const char* const filename, bool toFilter = false)
+  void doExport(const char* const filename)
   {
     setDefaultPrimIfOnlyOneRoot();
-    if (toFilter)
+
+    // All of the data has been authored on the anonymous root layer of the in-memory stage, so there is no need to
+    // compose and flatten the stage (which UsdStage::Export would do). Write the layer straight out to disk, in the
+    // file format determined by the file extension (e.g. usdc crate files).
+    if(!m_stage->GetRootLayer()->Export(filename))
     {
-      filterSample();
+      MGlobal::displayError(MString("ALUSDExport: failed to write file: ") + filename);
     }
-    m_stage->Export(filename, false);
     m_nodeMap.clear();
   }
 
@@ -258,7 +217,8 @@ private:
 Export::Export(const ExporterParams& params)
   : m_params(params), m_impl(new Export::Impl)
 {
-  if(m_impl->setStage(UsdStage::CreateNew(m_params.m_fileName.asChar())))
+  // author everything into an anonymous in-memory layer, which is only written to disk once the export completes.
+  if(m_impl->setStage(UsdStage::CreateInMemory()))
   {
     doExport();
     m_impl->closeStage();
@@ -519,7 +479,7 @@ void Export::doExport()
     MGlobal::viewFrame(oldCurTime);
   }
 
-  m_impl->doExport(m_params.m_fileName.asChar(), m_params.m_filterSample);
+  m_impl->doExport(m_params.m_fileName.asChar());
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -593,6 +553,10 @@ MStatus ExportCommand::doIt(const MArgList& args)
   {
     AL_MAYA_CHECK_ERROR(argData.getFlagArgument("fs", 0, m_params.m_filterSample), "ALUSDExport: Unable to fetch \"filter sample\" argument");
   }
+  if (argData.isFlagSet("ft", &status))
+  {
+    AL_MAYA_CHECK_ERROR(argData.getFlagArgument("ft", 0, m_params.m_filterTolerance), "ALUSDExport: Unable to fetch \"filter tolerance\" argument");
+  }
 
   if(m_params.m_animation)
   {
@@ -675,6 +639,8 @@ MSyntax ExportCommand::createSyntax()
   AL_MAYA_CHECK_ERROR2(status, errorString);
   status = syntax.addFlag("-fs", "-filterSample", MSyntax::kBoolean);
   AL_MAYA_CHECK_ERROR2(status, errorString);
+  status = syntax.addFlag("-ft", "-filterTolerance", MSyntax::kDouble);
+  AL_MAYA_CHECK_ERROR2(status, errorString);
   syntax.enableQuery(false);
   syntax.enableEdit(false);
 
@@ -701,8 +667,13 @@ ExportCommand Overview:
   Nurbs curves can be exported by passing the corresponding parameters:
     1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -nc
   
-  The exporter can remove samples that contain the same data for adjacent samples
-    1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -fs
+  The exporter can remove samples that contain the same data for adjacent samples. Attributes whose value never
+  changes over the frame range are written as a default value. Samples are filtered as they are generated, so
+  duplicates are never written to the layer.
+    1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -fs 1
+
+  Floating point values (and vectors/matrices of) can be treated as duplicates when within a given tolerance:
+    1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -fs 1 -ft 0.0001
 )";
 
 //----------------------------------------------------------------------------------------------------------------------
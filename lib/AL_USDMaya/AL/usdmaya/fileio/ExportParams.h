@@ -40,6 +40,7 @@ struct ExporterParams
   MString m_fileName; ///< the filename of the file we will be exporting
   double m_minFrame=0.0; ///< the start frame for the animation export
   double m_maxFrame=1.0; ///< the end frame of the animation export
+  double m_filterTolerance = 0.0; ///< when filtering samples, floating point values within this tolerance are treated as duplicates
   bool m_selected = false; ///< are we exporting selected objects (true) or all objects (false)
   bool m_meshes = true; ///< if true, export meshes
   bool m_nurbsCurves = true; ///< if true export nurbs curves
@@ -65,6 +65,7 @@ MStatus ExportTranslator::writer(const MFileObject& file, const maya::OptionsPar
     params.m_animTranslator = new AnimationTranslator;
   }
   params.m_filterSample = options.getBool(kFilterSample);
+  params.m_filterTolerance = options.getFloat(kFilterTolerance);
   if(params.m_selected)
   {
     MGlobal::getActiveSelectionList(params.m_nodes);
@@ -49,6 +49,7 @@ AL_MAYA_TRANSLATOR_BEGIN(ExportTranslator, "AL usdmaya export", false, true, "*.
   static constexpr const char* const kFrameMin = "Frame Min"; ///< specify min time frame option name
   static constexpr const char* const kFrameMax = "Frame Max"; ///< specify max time frame option name
   static constexpr const char* const kFilterSample = "Filter Sample"; /// < export filter sample option name
+  static constexpr const char* const kFilterTolerance = "Filter Tolerance"; /// < tolerance used when filtering samples option name
 
   /// \brief  provide a method to specify the export options
   /// \param  options a set of options that are constructed and later used for option parsing
@@ -68,6 +69,7 @@ AL_MAYA_TRANSLATOR_BEGIN(ExportTranslator, "AL usdmaya export", false, true, "*.
     if(!options.addFloat(kFrameMin, defaultValues.m_minFrame)) return MS::kFailure;
     if(!options.addFloat(kFrameMax, defaultValues.m_maxFrame)) return MS::kFailure;
     if(!options.addBool(kFilterSample, defaultValues.m_filterSample)) return MS::kFailure;
+    if(!options.addFloat(kFilterTolerance, defaultValues.m_filterTolerance)) return MS::kFailure;
     return MS::kSuccess;
   }
 
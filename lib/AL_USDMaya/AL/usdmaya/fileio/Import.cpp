@@ -93,6 +93,7 @@ void Import::doImport()
   else
   {
     AL_BEGIN_PROFILE_SECTION(OpenStage);
+    AL_PROFILE_SECTION_ARGUMENT(file, m_params.m_fileName.asChar());
     stage = UsdStage::Open(m_params.m_fileName.asChar(), m_params.m_stageUnloaded ? UsdStage::LoadNone : UsdStage::LoadAll);
     AL_END_PROFILE_SECTION();
   }
@@ -146,6 +147,7 @@ void Import::doImport()
         if(prim.GetTypeName() == "Mesh")
         {
           AL_BEGIN_PROFILE_SECTION(ImportingMesh);
+          AL_PROFILE_SECTION_ARGUMENT(primPath, prim.GetPath().GetString());
           MObject obj = createParentTransform(prim, it);
           if(m_params.m_meshes)
           {
@@ -159,6 +161,7 @@ void Import::doImport()
         if(prim.GetTypeName() == "NurbsCurves")
         {
           AL_BEGIN_PROFILE_SECTION(ImportingNurbsCurves);
+          AL_PROFILE_SECTION_ARGUMENT(primPath, prim.GetPath().GetString());
           MObject obj = createParentTransform(prim, it);
           if(m_params.m_nurbsCurves)
           {
@@ -172,6 +175,7 @@ void Import::doImport()
         if(utils.isSchemaPrim(prim))
         {
           AL_BEGIN_PROFILE_SECTION(ImportingSchemaPrim);
+          AL_PROFILE_SECTION_ARGUMENT(primPath, prim.GetPath().GetString());
           MObject obj = createParentTransform(prim, it);
           MObject created;
           if(!importSchemaPrim(prim, obj, &created))
@@ -183,6 +187,7 @@ void Import::doImport()
         else
         {
           AL_BEGIN_PROFILE_SECTION(ImportingTransform);
+          AL_PROFILE_SECTION_ARGUMENT(primPath, prim.GetPath().GetString());
           MObject obj = createParentTransform(prim, it);
           it.append(obj);
           AL_END_PROFILE_SECTION();
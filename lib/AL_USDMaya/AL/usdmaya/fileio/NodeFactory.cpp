@@ -98,14 +98,6 @@ MObject NodeFactory::createNode(const UsdPrim& from, const char* const nodeType,
     if(obj.hasFn(MFn::kShape))
     {
       nodeName += "Shape";
-
-      // Write in the shapes parent transform node's path instead of the shape.
-      // This was done because we want the xform to be selected when chosen through the outliner instead of the shape.
-      mapUsdPrimToMayaNode(from, parent);
-    }
-    else
-    {
-      mapUsdPrimToMayaNode(from, obj);
     }
     newNodeName = fn.setName(nodeName);
 
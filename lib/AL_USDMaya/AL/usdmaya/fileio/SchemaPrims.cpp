@@ -120,6 +120,37 @@ bool importSchemaPrim(  const UsdPrim& prim,
   return true;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void importSchemaPrims(
+    const std::vector<UsdPrim>& prims,
+    std::vector<MObject>& parents,
+    std::vector<bool>& imported,
+    translators::TranslatorContextPtr context,
+    const translators::TranslatorRefPtr torBase)
+{
+  imported.assign(prims.size(), false);
+  if(!torBase)
+  {
+    Trace("Failed to find a translator for a batch of " << prims.size() << " prims");
+    return;
+  }
+
+  Trace("Translator-Import: import batch of " << prims.size() << " prims");
+  std::vector<MStatus> results;
+  torBase->importBatch(prims, parents, results);
+  for(size_t i = 0, n = prims.size(); i < n; ++i)
+  {
+    if(i >= results.size() || results[i] != MS::kSuccess)
+    {
+      std::cerr << "Failed to import schema prim \"" << prims[i].GetPath().GetText() << "\"\n";
+      continue;
+    }
+    if(context)
+      context->registerItem(prims[i], parents[i]);
+    imported[i] = true;
+  }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 SchemaPrimsUtils::SchemaPrimsUtils(fileio::translators::TranslatorManufacture& manufacture)
   : m_manufacture(manufacture)
@@ -23,6 +23,7 @@
 
 #include <unordered_set>
 #include <string>
+#include <vector>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
@@ -51,6 +52,22 @@ bool importSchemaPrim(
     translators::TranslatorContextPtr context = TfNullPtr,
     const translators::TranslatorRefPtr translator = TfNullPtr);
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  a method called to import a batch of schema prims that share the same translator into maya in one pass
+/// \param  usdPrims the usd prims to be imported into Maya
+/// \param  parents the parent transform for each prim
+/// \param  imported returns true for each prim that was imported successfully
+/// \param  context a custom context to use when importing the prims
+/// \param  translator the custom translator to use to import the prims
+/// \ingroup   fileio
+//----------------------------------------------------------------------------------------------------------------------
+void importSchemaPrims(
+    const std::vector<UsdPrim>& usdPrims,
+    std::vector<MObject>& parents,
+    std::vector<bool>& imported,
+    translators::TranslatorContextPtr context,
+    const translators::TranslatorRefPtr translator);
+
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  utility function to determine whether the prim specified is of the given type
 /// \param  prim the prim to query
@@ -17,11 +17,16 @@
 #include "AL/usdmaya/fileio/ExportParams.h"
 #include "AL/usdmaya/fileio/translators/CameraTranslator.h"
 
+#include "maya/MDoubleArray.h"
+#include "maya/MFnAnimCurve.h"
 #include "maya/MFnDagNode.h"
 #include "maya/MNodeClass.h"
 #include "maya/MGlobal.h"
+#include "maya/MTimeArray.h"
 #include <algorithm>
+#include <vector>
 
+#include "pxr/usd/usd/attributeQuery.h"
 #include "pxr/usd/usdGeom/camera.h"
 #include "pxr/usd/usdGeom/tokens.h"
 
@@ -36,6 +41,19 @@ namespace AL {
 namespace usdmaya {
 namespace fileio {
 namespace translators {
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// a keyable camera attribute, and the USD attribute it is imported from
+struct CameraChannel
+{
+  MObject attribute;
+  UsdAttribute usdAttr;
+  double scale;
+  bool isDistance;
+};
+} // anon
+
 //----------------------------------------------------------------------------------------------------------------------
 MObject CameraTranslator::m_orthographic;
 MObject CameraTranslator::m_horizontalFilmAperture;
@@ -96,46 +114,6 @@ MStatus CameraTranslator::copyAttributes(const UsdPrim& from, MObject to, const
   bool isOrthographic = (projection == UsdGeomTokens->orthographic);
   AL_MAYA_CHECK_ERROR(setBool(to, m_orthographic, isOrthographic), errorString);
 
-  // Horizontal film aperture
-  if (not setFloatAttrAnim(to, m_horizontalFilmAperture, usdCamera.GetHorizontalApertureAttr(), mm_to_inches))
-  {
-      float horizontalAperture;
-      usdCamera.GetHorizontalApertureAttr().Get(&horizontalAperture);
-      AL_MAYA_CHECK_ERROR(setDouble(to, m_horizontalFilmAperture, mm_to_inches * horizontalAperture), errorString);
-  }
-
-  // Vertical film aperture
-  if (not setFloatAttrAnim(to, m_verticalFilmAperture, usdCamera.GetVerticalApertureAttr(), mm_to_inches))
-  {
-      float verticalAperture;
-      usdCamera.GetVerticalApertureAttr().Get(&verticalAperture);
-      AL_MAYA_CHECK_ERROR(setDouble(to, m_verticalFilmAperture, mm_to_inches * verticalAperture), errorString);
-  }
-
-  // Horizontal film aperture offset
-  if (not setFloatAttrAnim(to, m_horizontalFilmApertureOffset, usdCamera.GetHorizontalApertureOffsetAttr(), mm_to_inches))
-  {
-      float horizontalApertureOffset;
-      usdCamera.GetHorizontalApertureOffsetAttr().Get(&horizontalApertureOffset);
-      AL_MAYA_CHECK_ERROR(setDouble(to, m_horizontalFilmApertureOffset, mm_to_inches * horizontalApertureOffset), errorString);
-  }
-
-  // Vertical film aperture offset
-  if (not setFloatAttrAnim(to, m_verticalFilmApertureOffset, usdCamera.GetVerticalApertureOffsetAttr(), mm_to_inches))
-  {
-      float verticalApertureOffset;
-      usdCamera.GetVerticalApertureOffsetAttr().Get(&verticalApertureOffset);
-      AL_MAYA_CHECK_ERROR(setDouble(to, m_verticalFilmApertureOffset, mm_to_inches * verticalApertureOffset), errorString);
-  }
-
-  // Focal length
-  if (not setFloatAttrAnim(to, m_focalLength, usdCamera.GetFocalLengthAttr()))
-  {
-      float focalLength;
-      usdCamera.GetFocalLengthAttr().Get(&focalLength);
-      AL_MAYA_CHECK_ERROR(setDouble(to, m_focalLength, focalLength), errorString);
-  }
-
   // Near/far clip planes
   // N.B. Animated clip plane values not supported
   GfVec2f clippingRange;
@@ -143,27 +121,64 @@ MStatus CameraTranslator::copyAttributes(const UsdPrim& from, MObject to, const
   AL_MAYA_CHECK_ERROR(setDistance(to, m_nearDistance, MDistance(clippingRange[0], MDistance::kCentimeters)), errorString);
   AL_MAYA_CHECK_ERROR(setDistance(to, m_farDistance, MDistance(clippingRange[1], MDistance::kCentimeters)), errorString);
 
-  // F-Stop
-  if (not setFloatAttrAnim(to, m_fstop, usdCamera.GetFStopAttr()))
+  // Each schema attribute is resolved once, and then read through a single attribute query. The lens channels of a
+  // camera are usually keyed on the same frames, so the maya key times are only rebuilt when the sample times of a
+  // channel differ from those of the previous animated channel.
+  // TODO: What unit for the focus distance?
+  const CameraChannel channels[] =
   {
-    float fstop;
-    usdCamera.GetFStopAttr().Get(&fstop);
-    AL_MAYA_CHECK_ERROR(setDouble(to, m_fstop, fstop), errorString);
-  }
+    { m_horizontalFilmAperture, usdCamera.GetHorizontalApertureAttr(), mm_to_inches, false },
+    { m_verticalFilmAperture, usdCamera.GetVerticalApertureAttr(), mm_to_inches, false },
+    { m_horizontalFilmApertureOffset, usdCamera.GetHorizontalApertureOffsetAttr(), mm_to_inches, false },
+    { m_verticalFilmApertureOffset, usdCamera.GetVerticalApertureOffsetAttr(), mm_to_inches, false },
+    { m_focalLength, usdCamera.GetFocalLengthAttr(), 1.0, false },
+    { m_fstop, usdCamera.GetFStopAttr(), 1.0, false },
+    { m_focusDistance, usdCamera.GetFocusDistanceAttr(), 1.0, true },
+  };
 
-  // Focus distance
-  if (usdCamera.GetFocusDistanceAttr().GetNumTimeSamples())
+  std::vector<double> keyTimes;
+  MTimeArray mayaKeyTimes;
+  std::vector<double> sampleTimes;
+  for(const CameraChannel& channel : channels)
   {
-    // TODO: What unit here?
-    MDistance one(1.0, MDistance::kCentimeters);
-    double conversionFactor = one.as(MDistance::kCentimeters);
-    setFloatAttrAnim(to, m_focusDistance, usdCamera.GetFocusDistanceAttr(), conversionFactor);
-  }
-  else
-  {
-    float focusDistance;
-    usdCamera.GetFocusDistanceAttr().Get(&focusDistance);
-    AL_MAYA_CHECK_ERROR(setDistance(to, m_focusDistance, MDistance(focusDistance, MDistance::kCentimeters)), errorString);
+    const UsdAttributeQuery query(channel.usdAttr);
+    float value = 0;
+    if(!query.GetTimeSamples(&sampleTimes) || sampleTimes.empty())
+    {
+      query.Get(&value);
+      if(channel.isDistance)
+      {
+        AL_MAYA_CHECK_ERROR(setDistance(to, channel.attribute, MDistance(value * channel.scale, MDistance::kCentimeters)), errorString);
+      }
+      else
+      {
+        AL_MAYA_CHECK_ERROR(setDouble(to, channel.attribute, value * channel.scale), errorString);
+      }
+      continue;
+    }
+
+    if(sampleTimes != keyTimes)
+    {
+      keyTimes.swap(sampleTimes);
+      mayaKeyTimes.setLength(keyTimes.size());
+      for(uint32_t i = 0, n = keyTimes.size(); i < n; ++i)
+      {
+        mayaKeyTimes[i] = MTime(keyTimes[i], MTime::kFilm);
+      }
+    }
+
+    MDoubleArray keyValues(mayaKeyTimes.length());
+    for(uint32_t i = 0, n = keyTimes.size(); i < n; ++i)
+    {
+      query.Get(&value, keyTimes[i]);
+      keyValues[i] = value * channel.scale;
+    }
+
+    MStatus status;
+    MFnAnimCurve fnCurve;
+    fnCurve.create(MPlug(to, channel.attribute), NULL, &status);
+    AL_MAYA_CHECK_ERROR(status, errorString);
+    AL_MAYA_CHECK_ERROR(addKeys(fnCurve, mayaKeyTimes, keyValues), errorString);
   }
 
   return MS::kSuccess;
@@ -202,27 +217,35 @@ MStatus CameraTranslator::copyAttributes(const MObject& from, UsdPrim& prim, con
   AL_MAYA_CHECK_ERROR(getDistance(from, m_focusDistance, focusDistance), errorString);
   AL_MAYA_CHECK_ERROR(getDouble(from, m_lensSqueezeRatio, squeezeRatio), errorString);
 
+  const UsdAttribute horizontalApertureAttr = usdCamera.GetHorizontalApertureAttr();
+  const UsdAttribute verticalApertureAttr = usdCamera.GetVerticalApertureAttr();
+  const UsdAttribute horizontalApertureOffsetAttr = usdCamera.GetHorizontalApertureOffsetAttr();
+  const UsdAttribute verticalApertureOffsetAttr = usdCamera.GetVerticalApertureOffsetAttr();
+  const UsdAttribute focalLengthAttr = usdCamera.GetFocalLengthAttr();
+  const UsdAttribute fstopAttr = usdCamera.GetFStopAttr();
+  const UsdAttribute focusDistanceAttr = usdCamera.GetFocusDistanceAttr();
+
   usdCamera.GetProjectionAttr().Set(isOrthographic ? UsdGeomTokens->orthographic : UsdGeomTokens->perspective);
-  usdCamera.GetHorizontalApertureAttr().Set(float(horizontalAperture * squeezeRatio * inches_to_mm));
-  usdCamera.GetVerticalApertureAttr().Set(float(verticalAperture * squeezeRatio * inches_to_mm));
-  usdCamera.GetHorizontalApertureOffsetAttr().Set(float(horizontalApertureOffset * squeezeRatio * inches_to_mm));
-  usdCamera.GetVerticalApertureOffsetAttr().Set(float(verticalApertureOffset * squeezeRatio * inches_to_mm));
-  usdCamera.GetFocalLengthAttr().Set(float(focalLength));
+  horizontalApertureAttr.Set(float(horizontalAperture * squeezeRatio * inches_to_mm));
+  verticalApertureAttr.Set(float(verticalAperture * squeezeRatio * inches_to_mm));
+  horizontalApertureOffsetAttr.Set(float(horizontalApertureOffset * squeezeRatio * inches_to_mm));
+  verticalApertureOffsetAttr.Set(float(verticalApertureOffset * squeezeRatio * inches_to_mm));
+  focalLengthAttr.Set(float(focalLength));
   usdCamera.GetClippingRangeAttr().Set(GfVec2f(nearDistance.as(MDistance::kCentimeters), farDistance.as(MDistance::kCentimeters)));
-  usdCamera.GetFStopAttr().Set(float(fstop));
-  usdCamera.GetFocusDistanceAttr().Set(float(focusDistance.as(MDistance::kCentimeters)));
+  fstopAttr.Set(float(fstop));
+  focusDistanceAttr.Set(float(focusDistance.as(MDistance::kCentimeters)));
 
   AnimationTranslator* animTranslator = params.m_animTranslator;
   if(animTranslator)
   {
     //
-    animTranslator->addPlug(MPlug(from, m_horizontalFilmAperture), usdCamera.GetHorizontalApertureAttr(), squeezeRatio * inches_to_mm, true);
-    animTranslator->addPlug(MPlug(from, m_verticalFilmAperture), usdCamera.GetVerticalApertureAttr(), squeezeRatio * inches_to_mm, true);
-    animTranslator->addPlug(MPlug(from, m_horizontalFilmApertureOffset), usdCamera.GetHorizontalApertureOffsetAttr(), squeezeRatio * inches_to_mm, true);
-    animTranslator->addPlug(MPlug(from, m_verticalFilmApertureOffset), usdCamera.GetVerticalApertureOffsetAttr(), squeezeRatio * inches_to_mm, true);
-    animTranslator->addPlug(MPlug(from, m_focalLength), usdCamera.GetFocalLengthAttr(), true);
-    animTranslator->addPlug(MPlug(from, m_fstop), usdCamera.GetFStopAttr(), true);
-    animTranslator->addPlug(MPlug(from, m_focusDistance), usdCamera.GetFocusDistanceAttr(), true);
+    animTranslator->addPlug(MPlug(from, m_horizontalFilmAperture), horizontalApertureAttr, squeezeRatio * inches_to_mm, true);
+    animTranslator->addPlug(MPlug(from, m_verticalFilmAperture), verticalApertureAttr, squeezeRatio * inches_to_mm, true);
+    animTranslator->addPlug(MPlug(from, m_horizontalFilmApertureOffset), horizontalApertureOffsetAttr, squeezeRatio * inches_to_mm, true);
+    animTranslator->addPlug(MPlug(from, m_verticalFilmApertureOffset), verticalApertureOffsetAttr, squeezeRatio * inches_to_mm, true);
+    animTranslator->addPlug(MPlug(from, m_focalLength), focalLengthAttr, true);
+    animTranslator->addPlug(MPlug(from, m_fstop), fstopAttr, true);
+    animTranslator->addPlug(MPlug(from, m_focusDistance), focusDistanceAttr, true);
   }
   return MS::kSuccess;
 }
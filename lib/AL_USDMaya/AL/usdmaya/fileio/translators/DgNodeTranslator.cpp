@@ -24,6 +24,7 @@
 #include "maya/MGlobal.h"
 #include "maya/MPlug.h"
 #include "maya/MFnDependencyNode.h"
+#include "maya/MTypeId.h"
 #include "maya/MMatrixArray.h"
 #include "maya/MFnMatrixData.h"
 #include "maya/MFnMatrixArrayData.h"
@@ -33,8 +34,27 @@
 #include "maya/MFnMatrixAttribute.h"
 #include "maya/MFnTypedAttribute.h"
 #include "maya/MFnCompoundAttribute.h"
-
+#include "maya/MFnDoubleArrayData.h"
+#include "maya/MFnIntArrayData.h"
+#include "maya/MFnPointArrayData.h"
+#include "maya/MFnStringArrayData.h"
+#include "maya/MFnVectorArrayData.h"
+#include "maya/MDoubleArray.h"
+#include "maya/MIntArray.h"
+#include "maya/MPointArray.h"
+#include "maya/MStringArray.h"
+#include "maya/MTimeArray.h"
+#include "maya/MVectorArray.h"
+
+#include "pxr/usd/sdf/attributeSpec.h"
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/sdf/primSpec.h"
+#include "pxr/usd/usd/editTarget.h"
+#include "pxr/usd/usd/stage.h"
+
+#include <cstring>
 #include <unordered_map>
+#include <vector>
 
 namespace AL {
 namespace usdmaya {
@@ -83,6 +103,29 @@ MStatus DgNodeTranslator::copyAttributes(const MObject& from, UsdPrim& to, const
   return MS::kSuccess;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+MStatus DgNodeTranslator::addKeys(MFnAnimCurve& fnCurve, MTimeArray& times, MDoubleArray& values)
+{
+  if(!times.length())
+    return MS::kSuccess;
+
+  switch(fnCurve.animCurveType())
+  {
+    case MFnAnimCurve::kAnimCurveTL:
+    case MFnAnimCurve::kAnimCurveTA:
+    case MFnAnimCurve::kAnimCurveTU:
+    {
+      return fnCurve.addKeys(&times, &values, MFnAnimCurve::kTangentGlobal, MFnAnimCurve::kTangentGlobal);
+    }
+    default:
+    {
+      std::cout << "[DgNodeTranslator::addKeys] Unexpected anim curve type: " << fnCurve.animCurveType() << std::endl;
+      break;
+    }
+  }
+  return MS::kSuccess;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 MStatus DgNodeTranslator::setAngleAnim(const MObject node, const MObject attr, const UsdGeomXformOp op)
 {
@@ -94,37 +137,19 @@ MStatus DgNodeTranslator::setAngleAnim(const MObject node, const MObject attr, c
   fnCurve.create(plug, NULL, &status);
   AL_MAYA_CHECK_ERROR(status, errorString);
 
-  std::vector<double> times;
-  op.GetTimeSamples(&times);
+  MTimeArray times;
+  std::vector<float> values;
+  readTimeSamples(op.GetAttr(), times, values);
 
   const float conversionFactor = 0.0174533f;
 
-  float value = 0;
-  for(auto const& timeValue: times)
+  MDoubleArray keys(times.length());
+  for(uint32_t i = 0, n = times.length(); i < n; ++i)
   {
-    const bool retValue = op.GetAs<float>(&value, timeValue);
-    if (!retValue) continue;
-
-    MTime tm(timeValue, MTime::kFilm);
-
-    switch (fnCurve.animCurveType())
-    {
-      case MFnAnimCurve::kAnimCurveTL:
-      case MFnAnimCurve::kAnimCurveTA:
-      case MFnAnimCurve::kAnimCurveTU:
-      {
-        fnCurve.addKey(tm, value * conversionFactor, MFnAnimCurve::kTangentGlobal, MFnAnimCurve::kTangentGlobal, NULL, &status);
-        AL_MAYA_CHECK_ERROR(status, errorString);
-        break;
-      }
-      default:
-      {
-        std::cout << "[DgNodeTranslator::setAngleAnim] Unexpected anim curve type: " << fnCurve.animCurveType() << std::endl;
-        break;
-      }
-    }
+    keys[i] = values[i] * conversionFactor;
   }
 
+  AL_MAYA_CHECK_ERROR(addKeys(fnCurve, times, keys), errorString);
   return MS::kSuccess;
 }
 
@@ -145,35 +170,17 @@ MStatus DgNodeTranslator::setFloatAttrAnim(const MObject node, const MObject att
   fnCurve.create(plug, NULL, &status);
   AL_MAYA_CHECK_ERROR(status, errorString);
 
-  std::vector<double> times;
-  usdAttr.GetTimeSamples(&times);
+  MTimeArray times;
+  std::vector<float> values;
+  readTimeSamples(usdAttr, times, values);
 
-  float value;
-  for(auto const& timeValue: times)
+  MDoubleArray keys(times.length());
+  for(uint32_t i = 0, n = times.length(); i < n; ++i)
   {
-    const bool retValue = usdAttr.Get(&value, timeValue);
-    if(!retValue) continue;
-
-    MTime tm(timeValue, MTime::kFilm);
-
-    switch(fnCurve.animCurveType())
-    {
-      case MFnAnimCurve::kAnimCurveTL:
-      case MFnAnimCurve::kAnimCurveTA:
-      case MFnAnimCurve::kAnimCurveTU:
-      {
-        fnCurve.addKey(tm, value * conversionFactor, MFnAnimCurve::kTangentGlobal, MFnAnimCurve::kTangentGlobal, NULL, &status);
-        AL_MAYA_CHECK_ERROR(status, errorString);
-        break;
-      }
-      default:
-      {
-        std::cout << "[DgNodeTranslator::setAnimValue] OTHER ANIM CURVE TYPE! = " << fnCurve.animCurveType() << std::endl;
-        break;
-      }
-    }
+    keys[i] = values[i] * conversionFactor;
   }
 
+  AL_MAYA_CHECK_ERROR(addKeys(fnCurve, times, keys), errorString);
   return MS::kSuccess;
 }
 
@@ -451,9 +458,149 @@ MStatus DgNodeTranslator::setMayaValue(MObject node, MObject attr, const UsdAttr
   return setSingleMayaValue(node, attr, usdAttr, dataType);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  sets an array value from USD onto a typed array data attribute (e.g. MFnData::kDoubleArray) by building the
+///         maya array in a single copy, rather than setting one multi element at a time.
+/// \param  plug the typed attribute plug to set
+/// \param  usdAttr the USD attribute to read the array from
+/// \param  type the USD data type of the attribute
+/// \param  status the returned status
+/// \return true if the attribute was handled, false if the element by element path should be used instead
+//----------------------------------------------------------------------------------------------------------------------
+bool setTypedArrayData(MPlug plug, const UsdAttribute& usdAttr, const UsdDataType type, MStatus& status)
+{
+  MFnTypedAttribute fnAttr(plug.attribute());
+  MObject data;
+  switch(fnAttr.attrType())
+  {
+  case MFnData::kDoubleArray:
+    {
+      MDoubleArray array;
+      if(type == UsdDataType::kDouble)
+      {
+        VtArray<double> value;
+        usdAttr.Get(&value);
+        array = MDoubleArray(value.cdata(), value.size());
+      }
+      else
+      if(type == UsdDataType::kFloat)
+      {
+        VtArray<float> value;
+        usdAttr.Get(&value);
+        array = MDoubleArray(value.cdata(), value.size());
+      }
+      else
+        return false;
+      MFnDoubleArrayData fnData;
+      data = fnData.create(array, &status);
+    }
+    break;
+
+  case MFnData::kIntArray:
+    {
+      if(type != UsdDataType::kInt && type != UsdDataType::kUInt)
+        return false;
+      VtArray<int32_t> value;
+      if(type == UsdDataType::kInt)
+      {
+        usdAttr.Get(&value);
+      }
+      else
+      {
+        VtArray<uint32_t> uvalue;
+        usdAttr.Get(&uvalue);
+        value.assign((const int32_t*)uvalue.cdata(), (const int32_t*)uvalue.cdata() + uvalue.size());
+      }
+      MIntArray array(value.cdata(), value.size());
+      MFnIntArrayData fnData;
+      data = fnData.create(array, &status);
+    }
+    break;
+
+  case MFnData::kVectorArray:
+  case MFnData::kPointArray:
+    {
+      if(type != UsdDataType::kVec3d)
+        return false;
+      VtArray<GfVec3d> value;
+      usdAttr.Get(&value);
+      if(fnAttr.attrType() == MFnData::kVectorArray)
+      {
+        MVectorArray array((const double(*)[3])value.cdata(), value.size());
+        MFnVectorArrayData fnData;
+        data = fnData.create(array, &status);
+      }
+      else
+      {
+        MPointArray array;
+        array.setLength(value.size());
+        for(uint32_t i = 0, n = value.size(); i < n; ++i)
+        {
+          array[i] = MPoint(value[i][0], value[i][1], value[i][2]);
+        }
+        MFnPointArrayData fnData;
+        data = fnData.create(array, &status);
+      }
+    }
+    break;
+
+  case MFnData::kStringArray:
+    {
+      if(type != UsdDataType::kString)
+        return false;
+      VtArray<std::string> value;
+      usdAttr.Get(&value);
+      MStringArray array(value.size(), MString());
+      for(uint32_t i = 0, n = value.size(); i < n; ++i)
+      {
+        array[i] = MString(value[i].c_str(), value[i].size());
+      }
+      MFnStringArrayData fnData;
+      data = fnData.create(array, &status);
+    }
+    break;
+
+  case MFnData::kMatrixArray:
+    {
+      if(type != UsdDataType::kMatrix4d)
+        return false;
+      VtArray<GfMatrix4d> value;
+      usdAttr.Get(&value);
+      MMatrixArray array;
+      array.setLength(value.size());
+      if(value.size())
+        std::memcpy(&array[0], value.cdata(), sizeof(GfMatrix4d) * value.size());
+      MFnMatrixArrayData fnData;
+      data = fnData.create(array, &status);
+    }
+    break;
+
+  default:
+    return false;
+  }
+  if(status)
+  {
+    status = plug.setValue(data);
+  }
+  return true;
+}
+} // anon
+
 //----------------------------------------------------------------------------------------------------------------------
 MStatus DgNodeTranslator::setArrayMayaValue(MObject node, MObject attr, const UsdAttribute& usdAttr, const UsdDataType type)
 {
+  if(attr.apiType() == MFn::kTypedAttribute)
+  {
+    MStatus status;
+    if(setTypedArrayData(MPlug(node, attr), usdAttr, type, status))
+    {
+      AL_MAYA_CHECK_ERROR(status, "DgNodeTranslator::setArrayMayaValue - unable to set typed array data");
+      return status;
+    }
+  }
+
   switch(type)
   {
   case UsdDataType::kBool:
@@ -887,743 +1034,453 @@ bool DgNodeTranslator::attributeHandled(const UsdAttribute& usdAttr)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-MStatus DgNodeTranslator::copyDynamicAttributes(MObject node, UsdPrim& prim)
+namespace {
+
+/// reads the value of a dynamic maya attribute into a VtValue of the USD type it is exported as
+typedef void (*DynamicAttributeReader)(const MObject& node, const MObject& attribute, const MPlug& plug, VtValue& value);
+
+template<typename T, typename E, MStatus (*get)(MObject, MObject, E*)>
+void readSingle(const MObject& node, const MObject& attribute, const MPlug&, VtValue& value)
 {
-  MFnDependencyNode fn(node);
-  uint32_t numAttributes = fn.attributeCount();
-  for(uint32_t i = 0; i < numAttributes; ++i)
+  T v;
+  get(node, attribute, (E*)&v);
+  value = v;
+}
+
+template<typename T, MStatus (*get)(MObject, MObject, T&)>
+void readValue(const MObject& node, const MObject& attribute, const MPlug&, VtValue& value)
+{
+  T v;
+  get(node, attribute, v);
+  value = v;
+}
+
+template<typename T, typename E, MStatus (*get)(MObject, MObject, E*, size_t)>
+void readArray(const MObject& node, const MObject& attribute, const MPlug& plug, VtValue& value)
+{
+  VtArray<T> v(plug.numElements());
+  get(node, attribute, (E*)v.data(), v.size());
+  value = v;
+}
+
+void readUChar(const MObject& node, const MObject& attribute, const MPlug&, VtValue& value)
+{
+  int16_t v;
+  maya::DgNodeHelper::getInt16(node, attribute, v);
+  value = uint8_t(v);
+}
+
+void readBoolArray(const MObject& node, const MObject& attribute, const MPlug& plug, VtValue& value)
+{
+  VtArray<bool> v(plug.numElements());
+  DgNodeTranslator::getUsdBoolArray(node, attribute, v);
+  value = v;
+}
+
+// The typed array data attributes are transferred with a single copy out of the maya array
+void readDoubleArrayData(const MObject&, const MObject&, const MPlug& plug, VtValue& value)
+{
+  MDoubleArray a = MFnDoubleArrayData(plug.asMObject()).array();
+  VtArray<double> v(a.length());
+  if(v.size())
+    a.get(v.data());
+  value = v;
+}
+
+void readIntArrayData(const MObject&, const MObject&, const MPlug& plug, VtValue& value)
+{
+  MIntArray a = MFnIntArrayData(plug.asMObject()).array();
+  VtArray<int> v(a.length());
+  if(v.size())
+    a.get(v.data());
+  value = v;
+}
+
+void readVectorArrayData(const MObject&, const MObject&, const MPlug& plug, VtValue& value)
+{
+  MVectorArray a = MFnVectorArrayData(plug.asMObject()).array();
+  VtArray<GfVec3d> v(a.length());
+  if(v.size())
+    a.get((double(*)[3])v.data());
+  value = v;
+}
+
+void readPointArrayData(const MObject&, const MObject&, const MPlug& plug, VtValue& value)
+{
+  MPointArray a = MFnPointArrayData(plug.asMObject()).array();
+  VtArray<GfVec3d> v(a.length());
+  for(uint32_t i = 0, n = a.length(); i < n; ++i)
   {
-    MObject attribute = fn.attribute(i);
-    MPlug plug(node, attribute);
+    const MPoint p = a[i].cartesianize();
+    v[i] = GfVec3d(p.x, p.y, p.z);
+  }
+  value = v;
+}
 
-    // skip child attributes (only export from highest level)
-    if(plug.isChild())
-      continue;
+void readStringArrayData(const MObject&, const MObject&, const MPlug& plug, VtValue& value)
+{
+  MStringArray a = MFnStringArrayData(plug.asMObject()).array();
+  VtArray<std::string> v(a.length());
+  for(uint32_t i = 0, n = a.length(); i < n; ++i)
+  {
+    v[i] = a[i].asChar();
+  }
+  value = v;
+}
 
-    bool isDynamic = plug.isDynamic();
-    if(isDynamic)
+void readMatrixArrayData(const MObject&, const MObject&, const MPlug& plug, VtValue& value)
+{
+  MMatrixArray a = MFnMatrixArrayData(plug.asMObject()).array();
+  VtArray<GfMatrix4d> v(a.length());
+  if(v.size())
+    std::memcpy(v.data(), &a[0], sizeof(GfMatrix4d) * v.size());
+  value = v;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  describes how a dynamic maya attribute is exported to USD
+//----------------------------------------------------------------------------------------------------------------------
+struct DynamicAttributeExport
+{
+  TfToken name;
+  SdfValueTypeName typeName;
+  DynamicAttributeReader reader = 0;
+  MFn::Type apiType = MFn::kInvalid;
+  int subType = 0; ///< the numeric unit type, or typed attribute data type
+  bool isArray = false;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the numeric unit type or typed attribute data type of an attribute, used along with the api type
+///         to identify the attribute type. For compounds, the api types and sub types of the children are folded in,
+///         so that (for example) a float4 and a double4 compound are not mistaken for one another.
+//----------------------------------------------------------------------------------------------------------------------
+int attributeSubType(const MObject& attribute, const MFn::Type apiType)
+{
+  switch(apiType)
+  {
+  case MFn::kNumericAttribute: return MFnNumericAttribute(attribute).unitType();
+  case MFn::kTypedAttribute: return MFnTypedAttribute(attribute).attrType();
+  case MFn::kCompoundAttribute:
     {
-      bool isArray = plug.isArray();
-      switch(attribute.apiType())
+      MFnCompoundAttribute fnCompound(attribute);
+      const uint32_t numChildren = fnCompound.numChildren();
+      uint32_t subType = numChildren;
+      for(uint32_t i = 0; i < numChildren; ++i)
       {
-      case MFn::kAttribute2Double:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double2);
-            GfVec2d m;
-            getVec2(node, attribute, (double*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double2Array);
-            VtArray<GfVec2d> m;
-            m.resize(plug.numElements());
-            getVec2Array(node, attribute, (double*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+        MObject child = fnCompound.child(i);
+        const MFn::Type childApiType = child.apiType();
+        subType = subType * 31u + uint32_t(childApiType);
+        subType = subType * 31u + uint32_t(attributeSubType(child, childApiType));
+      }
+      return int(subType);
+    }
+  default: break;
+  }
+  return 0;
+}
 
-      case MFn::kAttribute2Float:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float2);
-            GfVec2f m;
-            getVec2(node, attribute, (float*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float2Array);
-            VtArray<GfVec2f> m;
-            m.resize(plug.numElements());
-            getVec2Array(node, attribute, (float*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  determines the USD type and the reader of a dynamic attribute
+/// \return false if the attribute type cannot be exported
+//----------------------------------------------------------------------------------------------------------------------
+bool classifyDynamicAttribute(const MObject& attribute, DynamicAttributeExport& info)
+{
+  typedef maya::DgNodeHelper H;
+  const bool isArray = info.isArray;
+  const SdfValueTypeNameType& types = *SdfValueTypeNames;
 
-      case MFn::kAttribute2Int:
-      case MFn::kAttribute2Short:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int2);
-            GfVec2i m;
-            getVec2(node, attribute, (int32_t*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int2Array);
-            VtArray<GfVec2i> m;
-            m.resize(plug.numElements());
-            getVec2Array(node, attribute, (int32_t*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+#define AL_DYNAMIC_ATTRIBUTE(SingleType, SingleReader, ArrayType, ArrayReader) \
+  if(isArray) { info.typeName = types.ArrayType; info.reader = ArrayReader; } \
+  else { info.typeName = types.SingleType; info.reader = SingleReader; }
 
-      case MFn::kAttribute3Double:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double3);
-            GfVec3d m;
-            getVec3(node, attribute, (double*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double3Array);
-            VtArray<GfVec3d> m;
-            m.resize(plug.numElements());
-            getVec3Array(node, attribute, (double*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+  switch(info.apiType)
+  {
+  case MFn::kAttribute2Double:
+    AL_DYNAMIC_ATTRIBUTE(Double2, (readSingle<GfVec2d, double, &H::getVec2>), Double2Array, (readArray<GfVec2d, double, &H::getVec2Array>));
+    return true;
 
-      case MFn::kAttribute3Float:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float3);
-            GfVec3f m;
-            getVec3(node, attribute, (float*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float3Array);
-            VtArray<GfVec3f> m;
-            m.resize(plug.numElements());
-            getVec3Array(node, attribute, (float*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+  case MFn::kAttribute2Float:
+    AL_DYNAMIC_ATTRIBUTE(Float2, (readSingle<GfVec2f, float, &H::getVec2>), Float2Array, (readArray<GfVec2f, float, &H::getVec2Array>));
+    return true;
 
-      case MFn::kAttribute3Long:
-      case MFn::kAttribute3Short:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int3);
-            GfVec3i m;
-            getVec3(node, attribute, (int32_t*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int3Array);
-            VtArray<GfVec3i> m;
-            m.resize(plug.numElements());
-            getVec3Array(node, attribute, (int32_t*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+  case MFn::kAttribute2Int:
+  case MFn::kAttribute2Short:
+    AL_DYNAMIC_ATTRIBUTE(Int2, (readSingle<GfVec2i, int32_t, &H::getVec2>), Int2Array, (readArray<GfVec2i, int32_t, &H::getVec2Array>));
+    return true;
 
-      case MFn::kAttribute4Double:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double4);
-            GfVec4d m;
-            getVec4(node, attribute, (double*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double4Array);
-            VtArray<GfVec4d> m;
-            m.resize(plug.numElements());
-            getVec4Array(node, attribute, (double*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+  case MFn::kAttribute3Double:
+    AL_DYNAMIC_ATTRIBUTE(Double3, (readSingle<GfVec3d, double, &H::getVec3>), Double3Array, (readArray<GfVec3d, double, &H::getVec3Array>));
+    return true;
 
-      case MFn::kNumericAttribute:
-        {
-          MFnNumericAttribute fn(attribute);
-          switch(fn.unitType())
-          {
-          case MFnNumericData::kBoolean:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Bool);
-                bool value;
-                getBool(node, attribute, value);
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->BoolArray);
-                VtArray<bool> m;
-                m.resize(plug.numElements());
-                getUsdBoolArray(node, attribute, m);
-                usdAttr.Set(m);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+  case MFn::kAttribute3Float:
+    AL_DYNAMIC_ATTRIBUTE(Float3, (readSingle<GfVec3f, float, &H::getVec3>), Float3Array, (readArray<GfVec3f, float, &H::getVec3Array>));
+    return true;
 
-          case MFnNumericData::kFloat:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float);
-                float value;
-                getFloat(node, attribute, value);
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->FloatArray);
-                VtArray<float> m;
-                m.resize(plug.numElements());
-                getFloatArray(node, attribute, (float*)m.data(), m.size());
-                usdAttr.Set(m);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+  case MFn::kAttribute3Long:
+  case MFn::kAttribute3Short:
+    AL_DYNAMIC_ATTRIBUTE(Int3, (readSingle<GfVec3i, int32_t, &H::getVec3>), Int3Array, (readArray<GfVec3i, int32_t, &H::getVec3Array>));
+    return true;
 
-          case MFnNumericData::kDouble:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double);
-                double value;
-                getDouble(node, attribute, value);
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->DoubleArray);
-                VtArray<double> m;
-                m.resize(plug.numElements());
-                getDoubleArray(node, attribute, (double*)m.data(), m.size());
-                usdAttr.Set(m);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+  case MFn::kAttribute4Double:
+    AL_DYNAMIC_ATTRIBUTE(Double4, (readSingle<GfVec4d, double, &H::getVec4>), Double4Array, (readArray<GfVec4d, double, &H::getVec4Array>));
+    return true;
 
-          case MFnNumericData::kInt:
-          case MFnNumericData::kShort:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int);
-                int32_t value;
-                getInt32(node, attribute, value);
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->IntArray);
-                VtArray<int> m;
-                m.resize(plug.numElements());
-                getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-                usdAttr.Set(m);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+  case MFn::kNumericAttribute:
+    switch(info.subType)
+    {
+    case MFnNumericData::kBoolean:
+      AL_DYNAMIC_ATTRIBUTE(Bool, (readValue<bool, &H::getBool>), BoolArray, readBoolArray);
+      return true;
+    case MFnNumericData::kFloat:
+      AL_DYNAMIC_ATTRIBUTE(Float, (readValue<float, &H::getFloat>), FloatArray, (readArray<float, float, &H::getFloatArray>));
+      return true;
+    case MFnNumericData::kDouble:
+      AL_DYNAMIC_ATTRIBUTE(Double, (readValue<double, &H::getDouble>), DoubleArray, (readArray<double, double, &H::getDoubleArray>));
+      return true;
+    case MFnNumericData::kInt:
+    case MFnNumericData::kShort:
+      AL_DYNAMIC_ATTRIBUTE(Int, (readValue<int32_t, &H::getInt32>), IntArray, (readArray<int, int32_t, &H::getInt32Array>));
+      return true;
+    case MFnNumericData::kInt64:
+      AL_DYNAMIC_ATTRIBUTE(Int64, (readValue<int64_t, &H::getInt64>), Int64Array, (readArray<int64_t, int64_t, &H::getInt64Array>));
+      return true;
+    case MFnNumericData::kByte:
+    case MFnNumericData::kChar:
+      AL_DYNAMIC_ATTRIBUTE(UChar, readUChar, UCharArray, (readArray<uint8_t, int8_t, &H::getInt8Array>));
+      return true;
+    default:
+      std::cout << "Unhandled numeric attribute: " << MFnAttribute(attribute).name().asChar() << " " << info.subType << std::endl;
+      return false;
+    }
 
-          case MFnNumericData::kInt64:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int64);
-                int64_t value;
-                getInt64(node, attribute, value);
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int64Array);
-                VtArray<int64_t> m;
-                m.resize(plug.numElements());
-                getInt64Array(node, attribute, (int64_t*)m.data(), m.size());
-                usdAttr.Set(m);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+  case MFn::kDoubleAngleAttribute:
+  case MFn::kDoubleLinearAttribute:
+  case MFn::kTimeAttribute:
+    AL_DYNAMIC_ATTRIBUTE(Double, (readValue<double, &H::getDouble>), DoubleArray, (readArray<double, double, &H::getDoubleArray>));
+    return true;
 
-          case MFnNumericData::kByte:
-          case MFnNumericData::kChar:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->UChar);
-                int16_t value;
-                getInt16(node, attribute, value);
-                usdAttr.Set(uint8_t(value));
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->UCharArray);
-                VtArray<uint8_t> m;
-                m.resize(plug.numElements());
-                getInt8Array(node, attribute, (int8_t*)m.data(), m.size());
-                usdAttr.Set(m);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+  case MFn::kFloatAngleAttribute:
+  case MFn::kFloatLinearAttribute:
+    AL_DYNAMIC_ATTRIBUTE(Float, (readValue<float, &H::getFloat>), FloatArray, (readArray<float, float, &H::getFloatArray>));
+    return true;
 
-          default:
-            {
-              std::cout << "Unhandled numeric attribute: " << fn.name().asChar() << " " << fn.unitType() << std::endl;
-            }
-            break;
-          }
-        }
-        break;
+  case MFn::kEnumAttribute:
+    AL_DYNAMIC_ATTRIBUTE(Int, (readValue<int32_t, &H::getInt32>), IntArray, (readArray<int, int32_t, &H::getInt32Array>));
+    return true;
 
-      case MFn::kDoubleAngleAttribute:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double);
-            double value;
-            getDouble(node, attribute, value);
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->DoubleArray);
-            VtArray<double> value;
-            value.resize(plug.numElements());
-            getDoubleArray(node, attribute, (double*)value.data(), value.size());
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+  case MFn::kFloatMatrixAttribute:
+  case MFn::kMatrixAttribute:
+    AL_DYNAMIC_ATTRIBUTE(Matrix4d, (readSingle<GfMatrix4d, double, &H::getMatrix4x4>), Matrix4dArray, (readArray<GfMatrix4d, double, &H::getMatrix4x4Array>));
+    return true;
 
-      case MFn::kFloatAngleAttribute:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float);
-            float value;
-            getFloat(node, attribute, value);
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->FloatArray);
-            VtArray<float> value;
-            value.resize(plug.numElements());
-            getFloatArray(node, attribute, (float*)value.data(), value.size());
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+  case MFn::kTypedAttribute:
+    switch(info.subType)
+    {
+    case MFnData::kString:
+      AL_DYNAMIC_ATTRIBUTE(String, (readValue<std::string, &H::getString>), StringArray, (readArray<std::string, std::string, &H::getStringArray>));
+      return true;
+
+    // typed array data held in a single (non array) attribute
+    case MFnData::kDoubleArray:
+      if(isArray) return false;
+      info.typeName = types.DoubleArray; info.reader = readDoubleArrayData;
+      return true;
+    case MFnData::kIntArray:
+      if(isArray) return false;
+      info.typeName = types.IntArray; info.reader = readIntArrayData;
+      return true;
+    case MFnData::kVectorArray:
+      if(isArray) return false;
+      info.typeName = types.Vector3dArray; info.reader = readVectorArrayData;
+      return true;
+    case MFnData::kPointArray:
+      if(isArray) return false;
+      info.typeName = types.Point3dArray; info.reader = readPointArrayData;
+      return true;
+    case MFnData::kStringArray:
+      if(isArray) return false;
+      info.typeName = types.StringArray; info.reader = readStringArrayData;
+      return true;
+    case MFnData::kMatrixArray:
+      if(isArray) return false;
+      info.typeName = types.Matrix4dArray; info.reader = readMatrixArrayData;
+      return true;
+
+    default:
+      std::cout << "Unhandled typed attribute: " << MFnAttribute(attribute).name().asChar() << " " << info.subType << std::endl;
+      return false;
+    }
 
-      case MFn::kDoubleLinearAttribute:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double);
-            double value;
-            getDouble(node, attribute, value);
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-          else
+  case MFn::kCompoundAttribute:
+    {
+      // compounds of compounds of numerics are matrices, and compounds of 4 numerics of the same type are vec4s.
+      MFnCompoundAttribute fnCompound(attribute);
+      const uint32_t numChildren = fnCompound.numChildren();
+      if(numChildren == 2 || numChildren == 3)
+      {
+        for(uint32_t i = 0; i < numChildren; ++i)
+        {
+          MObject row = fnCompound.child(i);
+          if(row.apiType() != MFn::kCompoundAttribute)
+            return false;
+          MFnCompoundAttribute fnRow(row);
+          if(fnRow.numChildren() != numChildren)
+            return false;
+          for(uint32_t j = 0; j < numChildren; ++j)
           {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->DoubleArray);
-            VtArray<double> value;
-            value.resize(plug.numElements());
-            getDoubleArray(node, attribute, (double*)value.data(), value.size());
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
+            if(fnRow.child(j).apiType() != MFn::kNumericAttribute)
+              return false;
           }
         }
-        break;
-
-      case MFn::kFloatLinearAttribute:
+        if(numChildren == 2)
         {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float);
-            float value;
-            getFloat(node, attribute, value);
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->FloatArray);
-            VtArray<float> value;
-            value.resize(plug.numElements());
-            getFloatArray(node, attribute, (float*)value.data(), value.size());
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
+          AL_DYNAMIC_ATTRIBUTE(Matrix2d, (readSingle<GfMatrix2d, double, &H::getMatrix2x2>), Matrix2dArray, (readArray<GfMatrix2d, double, &H::getMatrix2x2Array>));
         }
-        break;
-
-      case MFn::kTimeAttribute:
+        else
         {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double);
-            double value;
-            getDouble(node, attribute, value);
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->DoubleArray);
-            VtArray<double> value;
-            value.resize(plug.numElements());
-            getDoubleArray(node, attribute, (double*)value.data(), value.size());
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
+          AL_DYNAMIC_ATTRIBUTE(Matrix3d, (readSingle<GfMatrix3d, double, &H::getMatrix3x3>), Matrix3dArray, (readArray<GfMatrix3d, double, &H::getMatrix3x3Array>));
         }
-        break;
-
-      case MFn::kEnumAttribute:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int);
-            int32_t value;
-            getInt32(node, attribute, value);
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->IntArray);
-            VtArray<int> m;
-            m.resize(plug.numElements());
-            getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
+        return true;
+      }
+      else
+      if(numChildren == 4)
+      {
+        int unitType = -1;
+        for(uint32_t i = 0; i < 4; ++i)
+        {
+          MObject child = fnCompound.child(i);
+          if(child.apiType() != MFn::kNumericAttribute)
+            return false;
+          const int childType = MFnNumericAttribute(child).unitType();
+          if(i && childType != unitType)
+            return false;
+          unitType = childType;
+        }
+        switch(unitType)
+        {
+        case MFnNumericData::kInt:
+          AL_DYNAMIC_ATTRIBUTE(Int4, (readSingle<GfVec4i, int32_t, &H::getVec4>), Int4Array, (readArray<GfVec4i, int32_t, &H::getVec4Array>));
+          return true;
+        case MFnNumericData::kFloat:
+          AL_DYNAMIC_ATTRIBUTE(Float4, (readSingle<GfVec4f, float, &H::getVec4>), Float4Array, (readArray<GfVec4f, float, &H::getVec4Array>));
+          return true;
+        case MFnNumericData::kDouble:
+          AL_DYNAMIC_ATTRIBUTE(Double4, (readSingle<GfVec4d, double, &H::getVec4>), Double4Array, (readArray<GfVec4d, double, &H::getVec4Array>));
+          return true;
+        default:
+          break;
         }
-        break;
+      }
+    }
+    return false;
 
-      case MFn::kTypedAttribute:
-        {
-          MFnTypedAttribute fnTyped(plug.attribute());
-          MFnData::Type type = fnTyped.attrType();
+  default:
+    break;
+  }
+#undef AL_DYNAMIC_ATTRIBUTE
+  return false;
+}
 
-          switch(type)
-          {
-          case MFnData::kString:
-            {
-              if(!isArray)
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->String);
-                std::string value;
-                getString(node, attribute, value);
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-              else
-              {
-                UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->StringArray);
-                VtArray<std::string> value;
-                value.resize(plug.numElements());
-                getStringArray(node, attribute, (std::string*)value.data(), value.size());
-                usdAttr.Set(value);
-                usdAttr.SetCustom(true);
-              }
-            }
-            break;
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The export description of each dynamic attribute, cached per node type id and attribute name. Nodes of the
+///         same type (e.g. the controls of a rig) tend to carry the same set of dynamic attributes, so the attribute
+///         name tokens and type dispatch only need to be computed once.
+//----------------------------------------------------------------------------------------------------------------------
+struct DynamicAttributeCache
+{
+  const DynamicAttributeExport* find(const uint32_t nodeType, const MObject& attribute, const bool isArray)
+  {
+    const MFn::Type apiType = attribute.apiType();
+    const int subType = attributeSubType(attribute, apiType);
+    MFnAttribute fnAttr(attribute);
+    auto& attributes = m_nodeTypes[nodeType];
+    DynamicAttributeExport& info = attributes[fnAttr.name().asChar()];
+    if(info.name.IsEmpty() || info.apiType != apiType || info.subType != subType || info.isArray != isArray)
+    {
+      // not seen before, or the same attribute name has a different type on this node
+      info.name = TfToken(fnAttr.name().asChar());
+      info.apiType = apiType;
+      info.subType = subType;
+      info.isArray = isArray;
+      if(!classifyDynamicAttribute(attribute, info))
+        info.reader = 0;
+    }
+    return info.reader ? &info : 0;
+  }
 
-          case MFnData::kMatrixArray:
-            {
-              MFnMatrixArrayData fnData(plug.asMObject());
-              UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix4dArray);
-              VtArray<GfMatrix4d> m;
-              m.assign((const GfMatrix4d*)&fnData.array()[0], ((const GfMatrix4d*)&fnData.array()[0]) + fnData.array().length());
-              usdAttr.Set(m);
-              usdAttr.SetCustom(true);
-            }
-            break;
+  std::unordered_map<uint32_t, std::unordered_map<std::string, DynamicAttributeExport> > m_nodeTypes;
+};
 
-          default:
-            {
-              std::cout << "Unhandled typed attribute: " << fn.name().asChar() << " " << fn.typeName().asChar() << std::endl;
-            }
-            break;
-          }
-        }
-        break;
+DynamicAttributeCache g_dynamicAttributeCache;
+} // anon
 
-      case MFn::kCompoundAttribute:
-        {
-          MFnCompoundAttribute fnCompound(plug.attribute());
-          {
-            if(fnCompound.numChildren() == 2)
-            {
-              MObject x = fnCompound.child(0);
-              MObject y = fnCompound.child(1);
-              if(x.apiType() == MFn::kCompoundAttribute &&
-                 y.apiType() == MFn::kCompoundAttribute)
-              {
-                MFnCompoundAttribute fnCompoundX(x);
-                MFnCompoundAttribute fnCompoundY(y);
+//----------------------------------------------------------------------------------------------------------------------
+MStatus DgNodeTranslator::copyDynamicAttributes(MObject node, UsdPrim& prim)
+{
+  MFnDependencyNode fn(node);
+  const uint32_t nodeType = fn.typeId().id();
 
-                if(fnCompoundX.numChildren() == 2 && fnCompoundY.numChildren() == 2)
-                {
-                  MObject xx = fnCompoundX.child(0);
-                  MObject xy = fnCompoundX.child(1);
-                  MObject yx = fnCompoundY.child(0);
-                  MObject yy = fnCompoundY.child(1);
-                  if(xx.apiType() == MFn::kNumericAttribute &&
-                     xy.apiType() == MFn::kNumericAttribute &&
-                     yx.apiType() == MFn::kNumericAttribute &&
-                     yy.apiType() == MFn::kNumericAttribute)
-                  {
-                    if(!isArray)
-                    {
-                      UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix2d);
-                      GfMatrix2d value;
-                      getMatrix2x2(node, attribute, (double*)&value);
-                      usdAttr.Set(value);
-                      usdAttr.SetCustom(true);
-                    }
-                    else
-                    {
-                      UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix2dArray);
-                      VtArray<GfMatrix2d> value;
-                      value.resize(plug.numElements());
-                      getMatrix2x2Array(node, attribute, (double*)value.data(), plug.numElements());
-                      usdAttr.Set(value);
-                      usdAttr.SetCustom(true);
-                    }
-                  }
-                }
-              }
-            }
-            else
-            if(fnCompound.numChildren() == 3)
-            {
-              MObject x = fnCompound.child(0);
-              MObject y = fnCompound.child(1);
-              MObject z = fnCompound.child(2);
-              if(x.apiType() == MFn::kCompoundAttribute &&
-                 y.apiType() == MFn::kCompoundAttribute &&
-                 z.apiType() == MFn::kCompoundAttribute)
-              {
-                MFnCompoundAttribute fnCompoundX(x);
-                MFnCompoundAttribute fnCompoundY(y);
-                MFnCompoundAttribute fnCompoundZ(z);
+  // gather the values of all the dynamic attributes first ...
+  std::vector<std::pair<const DynamicAttributeExport*, VtValue> > values;
+  uint32_t numAttributes = fn.attributeCount();
+  for(uint32_t i = 0; i < numAttributes; ++i)
+  {
+    MObject attribute = fn.attribute(i);
+    MPlug plug(node, attribute);
 
-                if(fnCompoundX.numChildren() == 3 && fnCompoundY.numChildren() == 3 && fnCompoundZ.numChildren() == 3)
-                {
-                  MObject xx = fnCompoundX.child(0);
-                  MObject xy = fnCompoundX.child(1);
-                  MObject xz = fnCompoundX.child(2);
-                  MObject yx = fnCompoundY.child(0);
-                  MObject yy = fnCompoundY.child(1);
-                  MObject yz = fnCompoundY.child(2);
-                  MObject zx = fnCompoundZ.child(0);
-                  MObject zy = fnCompoundZ.child(1);
-                  MObject zz = fnCompoundZ.child(2);
-                  if(xx.apiType() == MFn::kNumericAttribute &&
-                     xy.apiType() == MFn::kNumericAttribute &&
-                     xz.apiType() == MFn::kNumericAttribute &&
-                     yx.apiType() == MFn::kNumericAttribute &&
-                     yy.apiType() == MFn::kNumericAttribute &&
-                     yz.apiType() == MFn::kNumericAttribute &&
-                     zx.apiType() == MFn::kNumericAttribute &&
-                     zy.apiType() == MFn::kNumericAttribute &&
-                     zz.apiType() == MFn::kNumericAttribute)
-                  {
-                    if(!isArray)
-                    {
-                      UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix3d);
-                      GfMatrix3d value;
-                      getMatrix3x3(node, attribute, (double*)&value);
-                      usdAttr.Set(value);
-                      usdAttr.SetCustom(true);
-                    }
-                    else
-                    {
-                      UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix3dArray);
-                      VtArray<GfMatrix3d> value;
-                      value.resize(plug.numElements());
-                      getMatrix3x3Array(node, attribute, (double*)value.data(), plug.numElements());
-                      usdAttr.Set(value);
-                      usdAttr.SetCustom(true);
-                    }
-                  }
-                }
-              }
-            }
-            else
-            if(fnCompound.numChildren() == 4)
-            {
-              MObject x = fnCompound.child(0);
-              MObject y = fnCompound.child(1);
-              MObject z = fnCompound.child(2);
-              MObject w = fnCompound.child(3);
-              if(x.apiType() == MFn::kNumericAttribute &&
-                 y.apiType() == MFn::kNumericAttribute &&
-                 z.apiType() == MFn::kNumericAttribute &&
-                 w.apiType() == MFn::kNumericAttribute)
-              {
-                MFnNumericAttribute fnx(x);
-                MFnNumericAttribute fny(y);
-                MFnNumericAttribute fnz(z);
-                MFnNumericAttribute fnw(w);
-                MFnNumericData::Type typex = fnx.unitType();
-                MFnNumericData::Type typey = fny.unitType();
-                MFnNumericData::Type typez = fnz.unitType();
-                MFnNumericData::Type typew = fnw.unitType();
-                if(typex == typey && typex == typez && typex == typew)
-                {
-                  switch(typex)
-                  {
-                  case MFnNumericData::kInt:
-                    {
-                      if(!isArray)
-                      {
-                        UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int4);
-                        GfVec4i value;
-                        getVec4(node, attribute, (int32_t*)&value);
-                        usdAttr.Set(value);
-                        usdAttr.SetCustom(true);
-                      }
-                      else
-                      {
-                        UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Int4Array);
-                        VtArray<GfVec4i> value;
-                        value.resize(plug.numElements());
-                        getVec4Array(node, attribute, (int32_t*)value.data(), value.size());
-                        usdAttr.Set(value);
-                        usdAttr.SetCustom(true);
-                      }
-                    }
-                    break;
-
-                  case MFnNumericData::kFloat:
-                    {
-                      if(!isArray)
-                      {
-                        UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float4);
-                        GfVec4f value;
-                        getVec4(node, attribute, (float*)&value);
-                        usdAttr.Set(value);
-                        usdAttr.SetCustom(true);
-                      }
-                      else
-                      {
-                        UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Float4Array);
-                        VtArray<GfVec4f> value;
-                        value.resize(plug.numElements());
-                        getVec4Array(node, attribute, (float*)value.data(), value.size());
-                        usdAttr.Set(value);
-                        usdAttr.SetCustom(true);
-                      }
-                    }
-                    break;
-
-                  case MFnNumericData::kDouble:
-                    {
-                      if(!isArray)
-                      {
-                        UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double4);
-                        GfVec4d value;
-                        getVec4(node, attribute, (double*)&value);
-                        usdAttr.Set(value);
-                        usdAttr.SetCustom(true);
-                      }
-                      else
-                      {
-                        UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Double4Array);
-                        VtArray<GfVec4d> value;
-                        value.resize(plug.numElements());
-                        getVec4Array(node, attribute, (double*)value.data(), value.size());
-                        usdAttr.Set(value);
-                        usdAttr.SetCustom(true);
-                      }
-                    }
-                    break;
-
-                  default: break;
-                  }
-                }
-              }
-            }
-          }
-        }
-        break;
+    // skip child attributes (only export from highest level)
+    if(plug.isChild() || !plug.isDynamic())
+      continue;
 
-      case MFn::kFloatMatrixAttribute:
-      case MFn::kMatrixAttribute:
-        {
-          if(!isArray)
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix4d);
-            GfMatrix4d m;
-            getMatrix4x4(node, attribute, (double*)&m);
-            usdAttr.Set(m);
-            usdAttr.SetCustom(true);
-          }
-          else
-          {
-            UsdAttribute usdAttr = prim.CreateAttribute(TfToken(plug.partialName(false, false, false, false, false, true).asChar()), SdfValueTypeNames->Matrix4dArray);
-            VtArray<GfMatrix4d> value;
-            value.resize(plug.numElements());
-            getMatrix4x4Array(node, attribute, (double*)value.data(), value.size());
-            usdAttr.Set(value);
-            usdAttr.SetCustom(true);
-          }
-        }
-        break;
+    const DynamicAttributeExport* info = g_dynamicAttributeCache.find(nodeType, attribute, plug.isArray());
+    if(info)
+    {
+      values.emplace_back(info, VtValue());
+      info->reader(node, attribute, plug, values.back().second);
+    }
+  }
 
-      default: break;
-      }
+  if(values.empty())
+    return MS::kSuccess;
+
+  // ... and then author them in one batch, directly into the edit target layer
+  UsdStageWeakPtr stage = prim.GetStage();
+  const UsdEditTarget& editTarget = stage->GetEditTarget();
+  SdfLayerHandle layer = editTarget.GetLayer();
+  const SdfPath primPath = editTarget.MapToSpecPath(prim.GetPath());
+
+  SdfChangeBlock changeBlock;
+  SdfPrimSpecHandle primSpec = SdfCreatePrimInLayer(layer, primPath);
+  if(!primSpec)
+  {
+    return MS::kFailure;
+  }
+  for(const auto& value : values)
+  {
+    const DynamicAttributeExport& info = *value.first;
+    SdfAttributeSpecHandle attrSpec = layer->GetAttributeAtPath(primPath.AppendProperty(info.name));
+    if(!attrSpec)
+    {
+      attrSpec = SdfAttributeSpec::New(primSpec, info.name, info.typeName, SdfVariabilityVarying, true);
+    }
+    else
+    if(attrSpec->GetTypeName() != info.typeName)
+    {
+      std::cout << "Unable to export dynamic attribute: " << info.name.GetText() << ", it already exists with the type: "
+                << attrSpec->GetTypeName().GetAsToken().GetText() << std::endl;
+      continue;
+    }
+    if(attrSpec)
+    {
+      attrSpec->SetDefaultValue(value.second);
     }
   }
   return MS::kSuccess;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+bool DgNodeTranslator::getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& sample)
 {
   MObject node = plug.node();
   MObject attribute = plug.attribute();
@@ -1635,14 +1492,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       int8_t value;
       getInt8(node, attribute, value);
-      usdAttr.Set(uint8_t(value), timeCode);
+      sample = uint8_t(value);
     }
     else
     {
       VtArray<uint8_t> m;
       m.resize(plug.numElements());
       getInt8Array(node, attribute, (int8_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1651,14 +1508,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       int32_t value;
       getInt32(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      sample = value;
     }
     else
     {
       VtArray<int32_t> m;
       m.resize(plug.numElements());
       getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1667,14 +1524,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       int32_t value;
       getInt32(node, attribute, value);
-      usdAttr.Set(uint32_t(value), timeCode);
+      sample = uint32_t(value);
     }
     else
     {
       VtArray<uint32_t> m;
       m.resize(plug.numElements());
       getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1683,14 +1540,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       int64_t value;
       getInt64(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      sample = value;
     }
     else
     {
       VtArray<int64_t> m;
       m.resize(plug.numElements());
       getInt64Array(node, attribute, (int64_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1699,14 +1556,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       int64_t value;
       getInt64(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      sample = value;
     }
     else
     {
       VtArray<int64_t> m;
       m.resize(plug.numElements());
       getInt64Array(node, attribute, (int64_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1715,14 +1572,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       float value;
       getFloat(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      sample = value;
     }
     else
     {
       VtArray<float> m;
       m.resize(plug.numElements());
       getFloatArray(node, attribute, (float*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1731,14 +1588,14 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       double value;
       getDouble(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      sample = value;
     }
     else
     {
       VtArray<double> m;
       m.resize(plug.numElements());
       getDoubleArray(node, attribute, (double*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -1747,24 +1604,25 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       GfHalf value;
       getHalf(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      sample = value;
     }
     else
     {
       VtArray<GfHalf> m;
       m.resize(plug.numElements());
       getHalfArray(node, attribute, (GfHalf*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
   default:
     break;
   }
+  return !sample.IsEmpty();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+bool DgNodeTranslator::getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& sample)
 {
   MObject node = plug.node();
   MObject attribute = plug.attribute();
@@ -1783,14 +1641,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec2d m;
           getVec2(node, attribute, (double*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec2d> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (double*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1799,14 +1657,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec2f m;
           getVec2(node, attribute, (float*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec2f> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (float*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1815,14 +1673,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec2i m;
           getVec2(node, attribute, (int*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec2i> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (int*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1831,14 +1689,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec2h m;
           getVec2(node, attribute, (GfHalf*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec2h> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (GfHalf*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1860,14 +1718,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec3d m;
           getVec3(node, attribute, (double*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec3d> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (double*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1876,14 +1734,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec3f m;
           getVec3(node, attribute, (float*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec3f> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (float*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1892,14 +1750,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec3i m;
           getVec3(node, attribute, (int*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec3i> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (int*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1908,14 +1766,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec3h m;
           getVec3(node, attribute, (GfHalf*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec3h> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (GfHalf*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1934,14 +1792,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec4d m;
           getVec4(node, attribute, (double*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec4d> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (double*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1950,14 +1808,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec4f m;
           getVec4(node, attribute, (float*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec4f> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (float*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1966,14 +1824,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec4i m;
           getVec4(node, attribute, (int*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec4i> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (int*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -1982,14 +1840,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
         {
           GfVec4h m;
           getVec4(node, attribute, (GfHalf*)&m);
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
           VtArray<GfVec4h> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (GfHalf*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2010,14 +1868,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             bool value;
             getBool(node, attribute, value);
-            usdAttr.Set(value, timeCode);
+            sample = value;
           }
           else
           {
             VtArray<bool> m;
             m.resize(plug.numElements());
             getUsdBoolArray(node, attribute, m);
-            usdAttr.Set(m, timeCode);
+            sample = m;
           }
         }
         break;
@@ -2030,7 +1888,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
       case MFnNumericData::kByte:
       case MFnNumericData::kChar:
         {
-          copySimpleValue(plug, usdAttr, timeCode);
+          getSimpleValue(plug, usdAttr, sample);
         }
         break;
 
@@ -2048,7 +1906,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
   case MFn::kDoubleLinearAttribute:
   case MFn::kFloatLinearAttribute:
     {
-      copySimpleValue(plug, usdAttr, timeCode);
+      getSimpleValue(plug, usdAttr, sample);
     }
     break;
 
@@ -2058,14 +1916,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
       {
         int32_t value;
         getInt32(node, attribute, value);
-        usdAttr.Set(value, timeCode);
+        sample = value;
       }
       else
       {
         VtArray<int> m;
         m.resize(plug.numElements());
         getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-        usdAttr.Set(m, timeCode);
+        sample = m;
       }
     }
     break;
@@ -2088,7 +1946,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           MFnMatrixArrayData fnData(plug.asMObject());
           VtArray<GfMatrix4d> m;
           m.assign((const GfMatrix4d*)&fnData.array()[0], ((const GfMatrix4d*)&fnData.array()[0]) + fnData.array().length());
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2129,14 +1987,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
                 {
                   GfMatrix2d value;
                   getMatrix2x2(node, attribute, (double*)&value);
-                  usdAttr.Set(value, timeCode);
+                  sample = value;
                 }
                 else
                 {
                   VtArray<GfMatrix2d> value;
                   value.resize(plug.numElements());
                   getMatrix2x2Array(node, attribute, (double*)value.data(), plug.numElements());
-                  usdAttr.Set(value, timeCode);
+                  sample = value;
                 }
               }
             }
@@ -2181,14 +2039,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
                 {
                   GfMatrix3d value;
                   getMatrix3x3(node, attribute, (double*)&value);
-                  usdAttr.Set(value, timeCode);
+                  sample = value;
                 }
                 else
                 {
                   VtArray<GfMatrix3d> value;
                   value.resize(plug.numElements());
                   getMatrix3x3Array(node, attribute, (double*)value.data(), plug.numElements());
-                  usdAttr.Set(value, timeCode);
+                  sample = value;
                 }
               }
             }
@@ -2224,14 +2082,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
                   {
                     GfVec4i value;
                     getVec4(node, attribute, (int32_t*)&value);
-                    usdAttr.Set(value, timeCode);
+                    sample = value;
                   }
                   else
                   {
                     VtArray<GfVec4i> value;
                     value.resize(plug.numElements());
                     getVec4Array(node, attribute, (int32_t*)value.data(), value.size());
-                    usdAttr.Set(value, timeCode);
+                    sample = value;
                   }
                 }
                 break;
@@ -2242,14 +2100,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
                   {
                     GfVec4f value;
                     getVec4(node, attribute, (float*)&value);
-                    usdAttr.Set(value, timeCode);
+                    sample = value;
                   }
                   else
                   {
                     VtArray<GfVec4f> value;
                     value.resize(plug.numElements());
                     getVec4Array(node, attribute, (float*)value.data(), value.size());
-                    usdAttr.Set(value, timeCode);
+                    sample = value;
                   }
                 }
                 break;
@@ -2260,14 +2118,14 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
                   {
                     GfVec4d value;
                     getVec4(node, attribute, (double*)&value);
-                    usdAttr.Set(value, timeCode);
+                    sample = value;
                   }
                   else
                   {
                     VtArray<GfVec4d> value;
                     value.resize(plug.numElements());
                     getVec4Array(node, attribute, (double*)value.data(), value.size());
-                    usdAttr.Set(value, timeCode);
+                    sample = value;
                   }
                 }
                 break;
@@ -2288,24 +2146,25 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
       {
         GfMatrix4d m;
         getMatrix4x4(node, attribute, (double*)&m);
-        usdAttr.Set(m, timeCode);
+        sample = m;
       }
       else
       {
         VtArray<GfMatrix4d> value;
         value.resize(plug.numElements());
         getMatrix4x4Array(node, attribute, (double*)value.data(), value.size());
-        usdAttr.Set(value, timeCode);
+        sample = value;
       }
     }
     break;
 
   default: break;
   }
+  return !sample.IsEmpty();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+bool DgNodeTranslator::getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, const float scale, VtValue& sample)
 {
   MObject node = plug.node();
   MObject attribute = plug.attribute();
@@ -2317,7 +2176,7 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       float value;
       getFloat(node, attribute, value);
-      usdAttr.Set(value * scale, timeCode);
+      sample = value * scale;
     }
     else
     {
@@ -2328,7 +2187,7 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
       {
         *it *= scale;
       }
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
@@ -2337,7 +2196,7 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
     {
       double value;
       getDouble(node, attribute, value);
-      usdAttr.Set(value * scale, timeCode);
+      sample = value * scale;
     }
     else
     {
@@ -2349,17 +2208,18 @@ void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr,
       {
         *it *= temp;
       }
-      usdAttr.Set(m, timeCode);
+      sample = m;
     }
     break;
 
   default:
     break;
   }
+  return !sample.IsEmpty();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+bool DgNodeTranslator::getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, const float scale, VtValue& sample)
 {
   MObject node = plug.node();
   MObject attribute = plug.attribute();
@@ -2379,7 +2239,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           GfVec2d m;
           getVec2(node, attribute, (double*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
@@ -2391,7 +2251,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             *it *= temp;
           }
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2401,7 +2261,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           GfVec2f m;
           getVec2(node, attribute, (float*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
@@ -2412,7 +2272,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             *it *= scale;
           }
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2435,7 +2295,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           GfVec3d m;
           getVec3(node, attribute, (double*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
@@ -2447,7 +2307,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             *it *= temp;
           }
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2457,7 +2317,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           GfVec3f m;
           getVec3(node, attribute, (float*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
@@ -2468,7 +2328,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             *it *= scale;
           }
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2488,7 +2348,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           GfVec4d m;
           getVec4(node, attribute, (double*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
@@ -2500,7 +2360,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             *it *= temp;
           }
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2510,7 +2370,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           GfVec4f m;
           getVec4(node, attribute, (float*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         else
         {
@@ -2521,7 +2381,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
           {
             *it *= scale;
           }
-          usdAttr.Set(m, timeCode);
+          sample = m;
         }
         break;
 
@@ -2544,7 +2404,7 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
       case MFnNumericData::kByte:
       case MFnNumericData::kChar:
         {
-          copySimpleValue(plug, usdAttr, scale, timeCode);
+          getSimpleValue(plug, usdAttr, scale, sample);
         }
         break;
 
@@ -2562,12 +2422,45 @@ void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAt
   case MFn::kDoubleLinearAttribute:
   case MFn::kFloatLinearAttribute:
     {
-      copySimpleValue(plug, usdAttr, scale, timeCode);
+      getSimpleValue(plug, usdAttr, scale, sample);
     }
     break;
 
   default: break;
   }
+  return !sample.IsEmpty();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+{
+  VtValue sample;
+  if(getSimpleValue(plug, usdAttr, sample))
+    usdAttr.Set(sample, timeCode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+{
+  VtValue sample;
+  if(getAttributeValue(plug, usdAttr, sample))
+    usdAttr.Set(sample, timeCode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeTranslator::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+{
+  VtValue sample;
+  if(getSimpleValue(plug, usdAttr, scale, sample))
+    usdAttr.Set(sample, timeCode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+{
+  VtValue sample;
+  if(getAttributeValue(plug, usdAttr, scale, sample))
+    usdAttr.Set(sample, timeCode);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -22,6 +22,8 @@
 #include "maya/MAngle.h"
 #include "maya/MDistance.h"
 #include "maya/MTime.h"
+#include "maya/MTimeArray.h"
+#include "maya/MDoubleArray.h"
 #include "maya/MFnAnimCurve.h"
 
 #include "maya/MGlobal.h"
@@ -29,6 +31,7 @@
 
 #include "pxr/base/gf/half.h"
 #include "pxr/usd/usd/attribute.h"
+#include "pxr/usd/usd/attributeQuery.h"
 #include "pxr/usd/usdGeom/xformOp.h"
 
 #include <string>
@@ -108,6 +111,22 @@ public:
   /// \return MS::kSuccess on success, error code otherwise
   static MStatus setFloatAttrAnim(MObject node, MObject attr, UsdAttribute usdAttr, double conversionFactor = 1.0);
 
+  /// \brief  reads all of the time samples authored on a USD attribute, using a single attribute query rather than
+  ///         resolving the attribute value for each sample in turn.
+  /// \param  usdAttr the USD attribute that contains the keyframe data
+  /// \param  times the returned sample times (in film units, i.e. frames at 24fps)
+  /// \param  values the returned sample values. If the attribute is not of type T, the values are cast to T.
+  /// \return true if the attribute has time samples
+  template<typename T>
+  static bool readTimeSamples(const UsdAttribute& usdAttr, MTimeArray& times, std::vector<T>& values);
+
+  /// \brief  adds a set of keys to an animation curve with a single call to MFnAnimCurve::addKeys
+  /// \param  fnCurve the anim curve to add the keys to
+  /// \param  times the key frame times
+  /// \param  values the key frame values (in maya's internal units)
+  /// \return MS::kSuccess on success, error code otherwise
+  static MStatus addKeys(MFnAnimCurve& fnCurve, MTimeArray& times, MDoubleArray& values);
+
   //--------------------------------------------------------------------------------------------------------------------
   /// \name   Get array values from Maya
   //--------------------------------------------------------------------------------------------------------------------
@@ -296,9 +315,10 @@ public:
   /// \return MS::kSuccess if succeeded, error code otherwise
   static MStatus addDynamicAttribute(MObject node, const UsdAttribute& usdAttr);
 
-  /// \brief  copy all custom attributes from the usd primitive onto the maya node.
-  /// \param  node the node to copy the attributes to
-  /// \param  prim the USD prim to copy the attributes from
+  /// \brief  copy all dynamic attributes from the maya node onto the usd primitive. The attribute types are cached per
+  ///         node type, and all of the attributes are authored within a single SdfChangeBlock.
+  /// \param  node the node to copy the attributes from
+  /// \param  prim the USD prim to copy the attributes to
   /// \return MS::kSuccess if succeeded, error code otherwise
   static MStatus copyDynamicAttributes(MObject node, UsdPrim& prim);
 
@@ -327,6 +347,36 @@ public:
   /// \param  scale a scaling factor to apply to provide support for
   /// \param  timeCode the timecode to use when setting the data
   static void copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, float scale, const UsdTimeCode& timeCode);
+
+  /// \brief  read the current value of the plug specified, converted to the type of the usdAttr, without writing it.
+  /// \param  plug the attribute to be read
+  /// \param  usdAttr the attribute that determines the type of the returned value
+  /// \param  sample the returned value
+  /// \return true if a value could be extracted from the plug
+  static bool getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& sample);
+
+  /// \brief  read the current value of the plug specified, converted to the type of the usdAttr, without writing it.
+  /// \param  plug the attribute to be read
+  /// \param  usdAttr the attribute that determines the type of the returned value
+  /// \param  sample the returned value
+  /// \return true if a value could be extracted from the plug
+  static bool getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& sample);
+
+  /// \brief  read the current value of the plug specified, converted to the type of the usdAttr, without writing it.
+  /// \param  plug the attribute to be read
+  /// \param  usdAttr the attribute that determines the type of the returned value
+  /// \param  scale a scaling factor to apply to the value
+  /// \param  sample the returned value
+  /// \return true if a value could be extracted from the plug
+  static bool getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, float scale, VtValue& sample);
+
+  /// \brief  read the current value of the plug specified, converted to the type of the usdAttr, without writing it.
+  /// \param  plug the attribute to be read
+  /// \param  usdAttr the attribute that determines the type of the returned value
+  /// \param  scale a scaling factor to apply to the value
+  /// \param  sample the returned value
+  /// \return true if a value could be extracted from the plug
+  static bool getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, float scale, VtValue& sample);
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -349,41 +399,68 @@ MStatus DgNodeTranslator::setVec3Anim(MObject node, MObject attr, const UsdGeomX
   acFnSetZ.create(plug.child(2), NULL, &status);
   AL_MAYA_CHECK_ERROR(status, xformErrorCreate);
 
-  std::vector<double> times;
-  op.GetTimeSamples(&times);
+  MTimeArray times;
+  std::vector<T> values;
+  readTimeSamples(op.GetAttr(), times, values);
+
+  // split the samples into one channel per curve, applying the unit conversion in the same pass
+  const uint32_t count = times.length();
+  MDoubleArray x(count), y(count), z(count);
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    x[i] = values[i][0] * conversionFactor;
+    y[i] = values[i][1] * conversionFactor;
+    z[i] = values[i][2] * conversionFactor;
+  }
+
+  const char* const xformErrorKey = "DgNodeTranslator:setVec3Anim error setting keys on animation curve";
+  AL_MAYA_CHECK_ERROR(addKeys(acFnSetX, times, x), xformErrorKey);
+  AL_MAYA_CHECK_ERROR(addKeys(acFnSetY, times, y), xformErrorKey);
+  AL_MAYA_CHECK_ERROR(addKeys(acFnSetZ, times, z), xformErrorKey);
 
-  const char* const xformErrorKey = "DgNodeTranslator:setVec3Anim error setting key on animation curve";
+  return MS::kSuccess;
+}
 
-  T value(0);
-  for(auto const& timeValue: times)
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool DgNodeTranslator::readTimeSamples(const UsdAttribute& usdAttr, MTimeArray& times, std::vector<T>& values)
+{
+  UsdAttributeQuery query(usdAttr);
+  std::vector<double> sampleTimes;
+  if(!query.GetTimeSamples(&sampleTimes) || sampleTimes.empty())
   {
-    const bool retValue = op.GetAs<T>(&value, timeValue);
-    if (!retValue) continue;
+    times.clear();
+    values.clear();
+    return false;
+  }
 
-    MTime tm(timeValue, MTime::kFilm);
+  times.setLength(sampleTimes.size());
+  values.resize(sampleTimes.size());
 
-    switch (acFnSetX.animCurveType())
+  // only go through a VtValue if the attribute needs converting to T
+  const bool exactType = usdAttr.GetTypeName().GetType() == TfType::Find<T>();
+  uint32_t count = 0;
+  VtValue value;
+  for(const double sampleTime : sampleTimes)
+  {
+    if(exactType)
     {
-      case MFnAnimCurve::kAnimCurveTL: // time->distance: translation
-      case MFnAnimCurve::kAnimCurveTA: // time->angle: rotation
-      case MFnAnimCurve::kAnimCurveTU: // time->double: scale
-      {
-        acFnSetX.addKey(tm, value[0] * conversionFactor, MFnAnimCurve::kTangentGlobal, MFnAnimCurve::kTangentGlobal, NULL, &status);
-        AL_MAYA_CHECK_ERROR(status, xformErrorKey);
-        acFnSetY.addKey(tm, value[1] * conversionFactor, MFnAnimCurve::kTangentGlobal, MFnAnimCurve::kTangentGlobal, NULL, &status);
-        AL_MAYA_CHECK_ERROR(status, xformErrorKey);
-        acFnSetZ.addKey(tm, value[2] * conversionFactor, MFnAnimCurve::kTangentGlobal, MFnAnimCurve::kTangentGlobal, NULL, &status);
-        AL_MAYA_CHECK_ERROR(status, xformErrorKey);
-        break;
-      }
-      default:
-      {
-        break;
-      }
+      if(!query.Get(&values[count], sampleTime))
+        continue;
     }
+    else
+    {
+      if(!query.Get(&value, sampleTime) || !value.CanCast<T>())
+        continue;
+      values[count] = VtValue::Cast<T>(value).template UncheckedGet<T>();
+    }
+    times[count] = MTime(sampleTime, MTime::kFilm);
+    ++count;
   }
 
-  return MS::kSuccess;
+  times.setLength(count);
+  values.resize(count);
+  return true;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
+
+namespace AL {
+namespace usdmaya {
+namespace fileio {
+namespace translators {
+
+// defined in MeshKernelsScalar.cpp, MeshKernelsSSE.cpp and MeshKernelsAVX2.cpp
+const MeshKernels& scalarMeshKernels();
+const MeshKernels& sseMeshKernels();
+const MeshKernels& avx2MeshKernels();
+
+namespace {
+const MeshKernels* g_activeMeshKernels = nullptr;
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+const MeshKernels* meshKernels(AL::maya::SimdLevel level)
+{
+  // if the compiler was unable to target an instruction set (e.g. on a non x86 build), the translation unit for that
+  // level will have fallen back to a narrower code path, and reports that level instead.
+  const MeshKernels* kernels = nullptr;
+  switch(level)
+  {
+  case AL::maya::SimdLevel::kScalar: kernels = &scalarMeshKernels(); break;
+  case AL::maya::SimdLevel::kSSE3: kernels = &sseMeshKernels(); break;
+  case AL::maya::SimdLevel::kAVX2: kernels = &avx2MeshKernels(); break;
+  }
+  return (kernels && kernels->level == level) ? kernels : nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const MeshKernels& activeMeshKernels()
+{
+  return g_activeMeshKernels ? *g_activeMeshKernels : scalarMeshKernels();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+AL::maya::SimdLevel bindMeshKernels(AL::maya::SimdLevel maxLevel)
+{
+  const AL::maya::SimdLevel hostLevel = AL::maya::hostSimdLevel();
+  uint32_t level = uint32_t(hostLevel < maxLevel ? hostLevel : maxLevel);
+  for(; level > uint32_t(AL::maya::SimdLevel::kScalar); --level)
+  {
+    if(const MeshKernels* kernels = meshKernels(AL::maya::SimdLevel(level)))
+    {
+      g_activeMeshKernels = kernels;
+      return kernels->level;
+    }
+  }
+  g_activeMeshKernels = &scalarMeshKernels();
+  return AL::maya::SimdLevel::kScalar;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // translators
+} // fileio
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+#include "AL/maya/CpuFeatures.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AL {
+namespace usdmaya {
+namespace fileio {
+namespace translators {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The data conversion kernels used when importing and exporting meshes. A table is compiled for each of the
+///         SIMD levels (see MeshKernelsScalar.cpp, MeshKernelsSSE.cpp and MeshKernelsAVX2.cpp), and the widest one
+///         supported by the host CPU is bound when the plugin is loaded. The free functions declared in
+///         MeshTranslator.h dispatch through the bound table.
+//----------------------------------------------------------------------------------------------------------------------
+struct MeshKernels
+{
+  /// the instruction set the kernels were compiled for
+  AL::maya::SimdLevel level;
+  void (*zipUVs)(const float* u, const float* v, float* uv, const size_t count);
+  void (*unzipUVs)(const float* const uv, float* const u, float* const v, const size_t count);
+  void (*convert3DArrayTo4DArray)(const float* const input, float* const output, size_t count);
+  void (*convertFloatVec3ArrayToDoubleVec3Array)(const float* const input, double* const output, size_t count);
+  void (*convert3DFloatArrayTo4DDoubleArray)(const float* const input, double* const output, size_t count);
+  void (*interleaveIndexedUvData)(float* output, const float* u, const float* v, const int32_t* indices, const uint32_t numIndices);
+  bool (*isUvSetDataSparse)(const int32_t* uvCounts, const uint32_t count);
+};
+
+/// \brief  returns the kernels compiled for the specified SIMD level
+/// \param  level the SIMD level
+/// \return the kernels, or nullptr if this build does not contain kernels for that level
+const MeshKernels* meshKernels(AL::maya::SimdLevel level);
+
+/// \brief  returns the kernels currently in use. These are the scalar kernels until bindMeshKernels is called.
+/// \return the bound kernels
+const MeshKernels& activeMeshKernels();
+
+/// \brief  binds the widest kernels that are supported by the host CPU, and do not exceed maxLevel
+/// \param  maxLevel the widest SIMD level that may be bound
+/// \return the SIMD level of the kernels that were bound
+AL::maya::SimdLevel bindMeshKernels(AL::maya::SimdLevel maxLevel = AL::maya::SimdLevel::kAVX2);
+
+//----------------------------------------------------------------------------------------------------------------------
+} // translators
+} // fileio
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
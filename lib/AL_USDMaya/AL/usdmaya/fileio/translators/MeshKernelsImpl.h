@@ -0,0 +1,586 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+//----------------------------------------------------------------------------------------------------------------------
+/// \file   MeshKernelsImpl.h
+/// \brief  The implementation of the mesh kernels. This file is included by MeshKernelsScalar.cpp, MeshKernelsSSE.cpp
+///         and MeshKernelsAVX2.cpp, each of which is compiled for a different instruction set. The code path within
+///         each kernel is chosen by AL_MAYA_ENABLE_SIMD and __AVX2__, as seen by the including translation unit.
+///         Everything in here has internal linkage, so that the differently compiled copies never get merged.
+//----------------------------------------------------------------------------------------------------------------------
+#include "AL/maya/SIMD.h"
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
+
+namespace AL {
+namespace usdmaya {
+namespace fileio {
+namespace translators {
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+#if AL_MAYA_ENABLE_SIMD
+#if defined(__AVX2__)
+void convert3Dto4d_avx(f256 a, f256 b, f256 c, float* const output)
+{
+  static const f256 wvalues = set8f(0, 0, 0, 1.0f, 0, 0, 0, 1.0f);
+  static const f256 wmask = set8f(0, 0, 0, -0.0f, 0, 0, 0, -0.0f);
+  const f256 v23 = permute2f128(a, b, 0x21);
+  const f256 v45 = permute2f128(b, c, 0x21);
+  static const i256 mask01 = set8i(0, 1, 2, 0, 3, 4, 5, 0);
+  static const i256 mask23 = set8i(2, 3, 4, 0, 5, 6, 7, 0);
+  f256 o01 = permutevar8x32f(a, mask01);
+  f256 o23 = permutevar8x32f(v23, mask23);
+  f256 o45 = permutevar8x32f(v45, mask01);
+  f256 o67 = permutevar8x32f(c, mask23);
+  o01 = select8f(o01, wvalues, wmask);
+  o23 = select8f(o23, wvalues, wmask);
+  o45 = select8f(o45, wvalues, wmask);
+  o67 = select8f(o67, wvalues, wmask);
+  storeu8f(output, o01);
+  storeu8f(output + 8, o23);
+  storeu8f(output + 16, o45);
+  storeu8f(output + 24, o67);
+}
+#endif
+
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  assuming a, b, & c are 8 packed 3D vectors of the form:
+///
+///         { v0x, v0y, v0z, v1x, v1y, v1z,   *snip*, v7x, v7y, v7z }
+///
+///         This method will convert that to 4D vectors with a 'w' value of 1.
+///
+///         { v0x, v0y, v0z, 1.0, v1x, v1y, v1z, 1.0, *snip*, v7x, v7y, v7z, 1.0 }
+///
+///         The output array must contain 32 floating poing values
+//----------------------------------------------------------------------------------------------------------------------
+void convert3Dto4d_sse(const f128 a, const f128 b, const f128 c, float* output)
+{
+  static const f128 wvalues = set4f(0, 0, 0, 1.0f);
+  static const f128 wmask = cast4f(set4i(0, 0, 0, 0xFFFFFFFF));
+
+  const f128 o0 = select4f(a, wvalues, wmask);
+  const f128 o3 = or4f(cast4f(shiftBytesRight(cast4i(c), 4)), wvalues);
+  f128 o1 = shuffle4f(a, b, 1, 0, 3, 3);
+  o1 = select4f(shuffle4f(o1, o1, 1, 3, 2, 0), wvalues, wmask);
+  f128 o2 = select4f(shuffle4f(b, c, 1, 0, 3, 2), wvalues, wmask);
+
+  storeu4f(output, o0);
+  storeu4f(output + 4, o1);
+  storeu4f(output + 8, o2);
+  storeu4f(output + 12, o3);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void convert3Dto4d(const float* const c, float* const output, uint32_t count)
+{
+  switch(count)
+  {
+  case 3:
+    output[8] = c[6];
+    output[9] = c[7];
+    output[10] = c[8];
+    output[11] = 1.0f;
+  case 2:
+    output[4] = c[3];
+    output[5] = c[4];
+    output[6] = c[5];
+    output[7] = 1.0f;
+  case 1:
+    output[0] = c[0];
+    output[1] = c[1];
+    output[2] = c[2];
+    output[3] = 1.0f;
+    default: break;
+  }
+}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+void convert3DArrayTo4DArray(const float* const input, float* const output, size_t count)
+{
+#if AL_MAYA_ENABLE_SIMD
+# if defined(__AVX2__) && ENABLE_SOME_AVX_ROUTINES
+  size_t count8 = count >> 3;
+  bool count4 = (count & 0x4) != 0;
+  uint32_t remainder = count & 0x3;
+  size_t i = 0, j = 0;
+  for(size_t n = 24 * count8; i != n; i += 24, j += 32)
+  {
+    const float* const ptr = input + i;
+    const f256 a = loadu8f(ptr);
+    const f256 b = loadu8f(ptr + 8);
+    const f256 c = loadu8f(ptr + 16);
+    convert3Dto4d_avx(a, b, c, output + j);
+  }
+  if(count4)
+  {
+    const float* const ptr = input + i;
+    const f128 a = loadu4f(ptr);
+    const f128 b = loadu4f(ptr + 4);
+    const f128 c = loadu4f(ptr + 8);
+    convert3Dto4d_sse(a, b, c, output + j);
+    i += 12;
+    j += 16;
+  }
+  convert3Dto4d(input + i, output + j, remainder);
+# elif defined(__SSE3__)
+  const size_t count4 = count >> 2;
+  const uint32_t remainder = count & 0x3;
+  size_t i = 0, j = 0;
+  for(size_t n = 12 * count4; i != n; i += 12, j += 16)
+  {
+    const float* const ptr = input + i;
+    const f128 a = loadu4f(ptr);
+    const f128 b = loadu4f(ptr + 4);
+    const f128 c = loadu4f(ptr + 8);
+    convert3Dto4d_sse(a, b, c, output + j);
+  }
+  convert3Dto4d(input + i, output + j, remainder);
+# endif
+#else
+  for(size_t i = 0, j = 0, n = count * 3; i != n; i += 3, j += 4)
+  {
+    output[j ] = input[i ];
+    output[j + 1] = input[i + 1];
+    output[j + 2] = input[i + 2];
+    output[j + 3] = 1.0f;
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void convertFloatVec3ArrayToDoubleVec3Array(const float* const input, double* const output, size_t count)
+{
+#if AL_MAYA_ENABLE_SIMD
+  const size_t count4 = count >> 2;
+  for(size_t i = 0; i < count4; ++i)
+  {
+    const float* const ptr = input + i * 12;
+    const f128 r0 = loadu4f(ptr);
+    const f128 r1 = loadu4f(ptr + 4);
+    const f128 r2 = loadu4f(ptr + 8);
+    const d128 r1a = cvt2f_to_2d(cast4f(shiftBytesRight(cast4i(r0), 8)));
+    const d128 r1b = cvt2f_to_2d(cast4f(shiftBytesRight(cast4i(r1), 8)));
+    const d128 r1c = cvt2f_to_2d(cast4f(shiftBytesRight(cast4i(r2), 8)));
+    const d128 r0a = cvt2f_to_2d(r0);
+    const d128 r0b = cvt2f_to_2d(r1);
+    const d128 r0c = cvt2f_to_2d(r2);
+    double* const optr = output + i * 12;
+    storeu2d(optr, r0a);
+    storeu2d(optr + 2, r1a);
+    storeu2d(optr + 4, r0b);
+    storeu2d(optr + 6, r1b);
+    storeu2d(optr + 8, r0c);
+    storeu2d(optr + 10, r1c);
+  }
+  for(size_t i = count4 << 2; i < count; ++i)
+  {
+    output[i * 3] = float(input[i * 3]);
+    output[i * 3 + 1] = float(input[i * 3 + 1]);
+    output[i * 3 + 2] = float(input[i * 3 + 2]);
+  }
+#else
+  for(size_t i = 0, n = 3 * count; i < n; i += 3)
+  {
+    output[i] = float(input[i]);
+    output[i + 1] = float(input[i + 1]);
+    output[i + 2] = float(input[i + 2]);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void convert3DFloatArrayTo4DDoubleArray(const float* const input, double* const output, size_t count)
+{
+  size_t i = 0, j = 0, n = count * 4;
+#if AL_MAYA_ENABLE_SIMD
+  // four points at a time: 12 floats in, 16 doubles out
+  const __m128d one = _mm_set1_pd(1.0);
+  for(const size_t n16 = (count & ~size_t(3)) * 4; i != n16; i += 16, j += 12)
+  {
+    const __m128 a = _mm_loadu_ps(input + j);      // x0 y0 z0 x1
+    const __m128 b = _mm_loadu_ps(input + j + 4);  // y1 z1 x2 y2
+    const __m128 c = _mm_loadu_ps(input + j + 8);  // z2 x3 y3 z3
+    const __m128d x0y0 = _mm_cvtps_pd(a);
+    const __m128d z0x1 = _mm_cvtps_pd(_mm_movehl_ps(a, a));
+    const __m128d y1z1 = _mm_cvtps_pd(b);
+    const __m128d x2y2 = _mm_cvtps_pd(_mm_movehl_ps(b, b));
+    const __m128d z2x3 = _mm_cvtps_pd(c);
+    const __m128d y3z3 = _mm_cvtps_pd(_mm_movehl_ps(c, c));
+    _mm_storeu_pd(output + i, x0y0);
+    _mm_storeu_pd(output + i + 2, _mm_move_sd(one, z0x1));
+    _mm_storeu_pd(output + i + 4, _mm_shuffle_pd(z0x1, y1z1, 1));
+    _mm_storeu_pd(output + i + 6, _mm_unpackhi_pd(y1z1, one));
+    _mm_storeu_pd(output + i + 8, x2y2);
+    _mm_storeu_pd(output + i + 10, _mm_move_sd(one, z2x3));
+    _mm_storeu_pd(output + i + 12, _mm_shuffle_pd(z2x3, y3z3, 1));
+    _mm_storeu_pd(output + i + 14, _mm_unpackhi_pd(y3z3, one));
+  }
+#endif
+  for(; i != n; i += 4, j += 3)
+  {
+    output[i] = input[j];
+    output[i + 1] = input[j + 1];
+    output[i + 2] = input[j + 2];
+    output[i + 3] = 1.0;
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void unzipUVs(const float* const uv, float* const u, float* const v, const size_t count)
+{
+#if AL_MAYA_ENABLE_SIMD
+
+#ifdef __AVX2__
+  const size_t count8 = count & ~7ULL;
+  size_t i = 0, j = 0;
+  for(; i < count8; i += 8, j += 16)
+  {
+    const f256 uva = loadu8f(uv + j);
+    const f256 uvb = loadu8f(uv + j + 8);
+    const f256 uva1 = permute2f128(uva, uvb, 0x20);
+    const f256 uvb1 = permute2f128(uva, uvb, 0x31);
+    const f256 uvals = shuffle8f(uva1, uvb1, 2, 0, 2, 0);
+    const f256 vvals = shuffle8f(uva1, uvb1, 3, 1, 3, 1);
+    storeu8f(u + i, uvals);
+    storeu8f(v + i, vvals);
+  }
+
+  if(count & 0x4)
+  {
+    const f128 uva = loadu4f(uv + j);
+    const f128 uvb = loadu4f(uv + j + 4);
+    const f128 uvals = shuffle4f(uva, uvb, 2, 0, 2, 0);
+    const f128 vvals = shuffle4f(uva, uvb, 3, 1, 3, 1);
+    storeu4f(u + i, uvals);
+    storeu4f(v + i, vvals);
+    i += 4;
+    j += 8;
+  }
+#else
+
+  const size_t count4 = count & ~3ULL;
+  size_t i = 0, j = 0;
+  for(; i < count4; i += 4, j += 8)
+  {
+    const f128 uva = loadu4f(uv + j);
+    const f128 uvb = loadu4f(uv + j + 4);
+    const f128 uvals = shuffle4f(uva, uvb, 2, 0, 2, 0);
+    const f128 vvals = shuffle4f(uva, uvb, 3, 1, 3, 1);
+    storeu4f(u + i, uvals);
+    storeu4f(v + i, vvals);
+  }
+
+#endif
+
+  switch(count & 3)
+  {
+  case 3:
+    u[i + 2] = uv[j + 4];
+    v[i + 2] = uv[j + 5];
+  case 2:
+    u[i + 1] = uv[j + 2];
+    v[i + 1] = uv[j + 3];
+  case 1:
+    u[i] = uv[j];
+    v[i] = uv[j + 1];
+  default:
+    break;
+  }
+
+#else
+  for(size_t i = 0, j = 0; i < count; ++i, j += 2)
+  {
+    u[i] = uv[j];
+    v[i] = uv[j + 1];
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Checks to see if any elements within the UV counts array happen to be zero.
+//----------------------------------------------------------------------------------------------------------------------
+bool isUvSetDataSparse(const int32_t* uvCounts, const uint32_t count)
+{
+#if AL_MAYA_ENABLE_SIMD
+# if defined(__AVX2__) && ENABLE_SOME_AVX_ROUTINES
+  const i256* counts = (const __m256i*)&uvCounts[0];
+  const i256 zero = zero8i();
+  const uint32_t count8 = count >> 3;
+
+  for(uint32_t i = 0; i < count8; ++i)
+  {
+    if(movemask8i(cmpeq8i(zero, loadu8i(counts + i))))
+      return true;
+  }
+
+  for(uint32_t i = count8 << 3; i < count; ++i)
+  {
+    if(!uvCounts[i]) return true;
+  }
+# else
+  const i128* counts = (const i128*)(&uvCounts[0]);
+  const i128 zero = zero4i();
+  const uint32_t count4 = count >> 2;
+
+  for(uint32_t i = 0; i < count4; ++i)
+  {
+    if(movemask4i(cmpeq4i(zero, loadu4i(counts + i))))
+      return true;
+  }
+
+  for(uint32_t i = count4 << 2; i < count; ++i)
+  {
+    if(!uvCounts[i]) return true;
+  }
+# endif
+#else
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(!uvCounts[i])
+      return true;
+  }
+#endif
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void zipUVs(const float* u, const float* v, float* uv, const size_t count)
+{
+#if AL_MAYA_ENABLE_SIMD
+# ifdef __AVX2__
+
+  uint32_t uvCount8 = count & ~7U;
+
+  for(uint32_t i = 0; i < uvCount8; i += 8, uv += 16)
+  {
+    const f256 U = loadu8f(u + i);
+    const f256 V = loadu8f(v + i);
+    const f256 uv0 = unpacklo8f(U, V);
+    const f256 uv1 = unpackhi8f(U, V);
+    storeu8f(uv, permute2f128(uv0, uv1, 0x20));
+    storeu8f(uv + 8, permute2f128(uv0, uv1, 0x31));
+  }
+
+  if(count & 0x4)
+  {
+    const f128 U = loadu4f(u + uvCount8);
+    const f128 V = loadu4f(v + uvCount8);
+    storeu4f(uv, unpacklo4f(U, V));
+    storeu4f(uv + 4, unpackhi4f(U, V));
+    uv += 8;
+    uvCount8 += 4;
+  }
+
+  switch(count & 3)
+  {
+  case 3:
+    uv[4] = u[uvCount8 + 2];
+    uv[5] = v[uvCount8 + 2];
+  case 2:
+    uv[2] = u[uvCount8 + 1];
+    uv[3] = v[uvCount8 + 1];
+  case 1:
+    uv[0] = u[uvCount8 + 0];
+    uv[1] = v[uvCount8 + 0];
+  default:
+    break;
+  }
+
+# else
+
+  const uint32_t uvCount4 = count & ~3U;
+
+  for(uint32_t i = 0; i < uvCount4; i += 4, uv += 8)
+  {
+    const f128 U = loadu4f(u + i);
+    const f128 V = loadu4f(v + i);
+    storeu4f(uv, unpacklo4f(U, V));
+    storeu4f(uv + 4, unpackhi4f(U, V));
+  }
+
+  switch(count & 3)
+  {
+  case 3:
+    uv[4] = u[uvCount4 + 2];
+    uv[5] = v[uvCount4 + 2];
+  case 2:
+    uv[2] = u[uvCount4 + 1];
+    uv[3] = v[uvCount4 + 1];
+  case 1:
+    uv[0] = u[uvCount4 + 0];
+    uv[1] = v[uvCount4 + 0];
+  default:
+    break;
+  }
+
+# endif
+#else
+  for(uint32_t i = 0, j = 0; i < count; i++, j += 2)
+  {
+    uv[j] = u[i];
+    uv[j + 1] = v[i];
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void interleaveIndexedUvData(float* output, const float* u, const float* v, const int32_t* indices, const uint32_t numIndices)
+{
+#if AL_MAYA_ENABLE_SIMD
+
+#if defined(__AVX2__) && ENABLE_SOME_AVX_ROUTINES
+
+  const uint32_t numIndices8 = numIndices & ~7;
+  uint32_t i = 0;
+  for(; i < numIndices8; i += 8, output += 16)
+  {
+    const i256 I = loadu8i(indices + i);
+    const f256 U = i32gather8f(u, I);
+    const f256 V = i32gather8f(v, I);
+    const f256 uv0 = unpacklo8f(U, V);
+    const f256 uv1 = unpackhi8f(U, V);
+    storeu8f(output, permute2f128(uv0, uv1, 0x20));
+    storeu8f(output + 8, permute2f128(uv0, uv1, 0x31));
+  }
+
+  if(numIndices & 0x4)
+  {
+    const i128 I = loadu4i(indices + i);
+    const f128 U = i32gather4f(u, I);
+    const f128 V = i32gather4f(v, I);
+    const f128 uv0 = unpacklo4f(U, V);
+    const f128 uv1 = unpackhi4f(U, V);
+    storeu4f(output, uv0);
+    storeu4f(output + 4, uv1);
+    output += 8;
+    i += 4;
+  }
+
+#else
+
+  const i128 uptr = splat2i64(intptr_t(u));
+  const i128 vptr = splat2i64(intptr_t(v));
+  const i128 mask = set4i(0xFFFFFFFF, 0, 0xFFFFFFFF, 0);
+
+  const uint32_t numIndices4 = numIndices & ~3;
+  uint32_t i = 0;
+  for(; i < numIndices4; i += 4, output += 8)
+  {
+    // load 4 indices
+    const i128 I = loadu4i(indices + i);
+
+    // mask out into 2 pairs of 64 bit indices, and scale values by 4 (using shift)
+    const i128 I02 = lshift64(and4i(mask, I), 2);
+    const i128 I13 = lshift64(and4i(mask, shiftBytesRight(I, 4)), 2);
+
+    // get addresses by adding the base offset
+    const i128 U02 = add2i64(I02, uptr);
+    const i128 U13 = add2i64(I13, uptr);
+    const i128 V02 = add2i64(I02, vptr);
+    const i128 V13 = add2i64(I13, vptr);
+
+    #ifndef __SSE4_1__
+    ALIGN16(float* ptrs[8]);
+    store4i(ptrs    , U02);
+    store4i(ptrs + 2, U13);
+    store4i(ptrs + 4, V02);
+    store4i(ptrs + 6, V13);
+
+    const f128 u0 = load1f(ptrs[0]);
+    const f128 u2 = load1f(ptrs[1]);
+    const f128 u1 = load1f(ptrs[2]);
+    const f128 u3 = load1f(ptrs[3]);
+    const f128 v0 = load1f(ptrs[4]);
+    const f128 v2 = load1f(ptrs[5]);
+    const f128 v1 = load1f(ptrs[6]);
+    const f128 v3 = load1f(ptrs[7]);
+    #else
+    #define extract_float_ptr(reg, index) reinterpret_cast<const float*>(_mm_extract_epi64(reg, index))
+    const f128 u0 = load1f(extract_float_ptr(U02, 0));
+    const f128 u2 = load1f(extract_float_ptr(U02, 1));
+    const f128 u1 = load1f(extract_float_ptr(U13, 0));
+    const f128 u3 = load1f(extract_float_ptr(U13, 1));
+    const f128 v0 = load1f(extract_float_ptr(V02, 0));
+    const f128 v2 = load1f(extract_float_ptr(V02, 1));
+    const f128 v1 = load1f(extract_float_ptr(V13, 0));
+    const f128 v3 = load1f(extract_float_ptr(V13, 1));
+    #undef extract_float_ptr
+    #endif
+
+    const f128 uv0 = unpacklo4f(u0, v0);
+    const f128 uv1 = unpacklo4f(u1, v1);
+    storeu4f(output, movelh4f(uv0, uv1));
+
+    const f128 uv2 = unpacklo4f(u2, v2);
+    const f128 uv3 = unpacklo4f(u3, v3);
+    storeu4f(output + 4, movelh4f(uv2, uv3));
+  }
+
+#endif
+
+  switch(numIndices & 0x3)
+  {
+  case 3: output[4] = u[indices[i + 2]];
+          output[5] = v[indices[i + 2]];
+  case 2: output[2] = u[indices[i + 1]];
+          output[3] = v[indices[i + 1]];
+  case 1: output[0] = u[indices[i]];
+          output[1] = v[indices[i]];
+  default: break;
+  }
+
+#else
+
+  for(uint32_t i = 0, j = 0; i < numIndices; ++i, j += 2)
+  {
+    output[j] = u[indices[i]];
+    output[j + 1] = v[indices[i]];
+  }
+
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+#if AL_MAYA_ENABLE_SIMD && defined(__AVX2__)
+constexpr AL::maya::SimdLevel g_meshKernelsLevel = AL::maya::SimdLevel::kAVX2;
+#elif AL_MAYA_ENABLE_SIMD
+constexpr AL::maya::SimdLevel g_meshKernelsLevel = AL::maya::SimdLevel::kSSE3;
+#else
+constexpr AL::maya::SimdLevel g_meshKernelsLevel = AL::maya::SimdLevel::kScalar;
+#endif
+
+/// the kernels as compiled for the instruction set of the including translation unit
+constexpr MeshKernels g_meshKernels =
+{
+  g_meshKernelsLevel,
+  zipUVs,
+  unzipUVs,
+  convert3DArrayTo4DArray,
+  convertFloatVec3ArrayToDoubleVec3Array,
+  convert3DFloatArrayTo4DDoubleArray,
+  interleaveIndexedUvData,
+  isUvSetDataSparse
+};
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+} // translators
+} // fileio
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,37 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// The scalar kernels, used as the fallback when the host CPU supports none of the SIMD levels.
+//
+#define AL_MAYA_ENABLE_SIMD 0
+#include "AL/usdmaya/fileio/translators/MeshKernelsImpl.h"
+
+namespace AL {
+namespace usdmaya {
+namespace fileio {
+namespace translators {
+
+//----------------------------------------------------------------------------------------------------------------------
+const MeshKernels& scalarMeshKernels()
+{
+  return g_meshKernels;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // translators
+} // fileio
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -18,7 +18,9 @@
 #include "AL/usdmaya/fileio/ExportParams.h"
 #include "AL/usdmaya/fileio/ImportParams.h"
 #include "AL/usdmaya/fileio/AnimationTranslator.h"
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
 #include "AL/usdmaya/fileio/translators/MeshTranslator.h"
+#include "AL/usdmaya/nodes/MeshAnimDeformer.h"
 
 #include "maya/MAnimUtil.h"
 #include "maya/MColorArray.h"
@@ -33,16 +35,25 @@
 #include "maya/MItMeshVertex.h"
 #include "maya/MObject.h"
 #include "maya/MPlug.h"
+#include "maya/MSelectionList.h"
+#include "maya/MStringArray.h"
 #include "maya/MUintArray.h"
 #include "maya/MVector.h"
 #include "maya/MVectorArray.h"
 
+#include "pxr/base/work/loops.h"
+#include "pxr/usd/sdf/attributeSpec.h"
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/sdf/layer.h"
+#include "pxr/usd/sdf/primSpec.h"
 #include "pxr/usd/usd/modelAPI.h"
 #include "pxr/usd/usd/timeCode.h"
 #include "pxr/usd/usdGeom/mesh.h"
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
+#include <vector>
 
 namespace AL {
 namespace usdmaya {
@@ -68,180 +79,25 @@ static void doubleToFloat(float* output, const double* const input, size_t count
 
 constexpr auto _alusd_colour = "alusd_colour_";
 
-//----------------------------------------------------------------------------------------------------------------------
-#if AL_MAYA_ENABLE_SIMD
-#if defined(__AVX2__)
-static void convert3Dto4d_avx(f256 a, f256 b, f256 c, float* const output)
-{
-  static const f256 wvalues = set8f(0, 0, 0, 1.0f, 0, 0, 0, 1.0f);
-  static const f256 wmask = set8f(0, 0, 0, -0.0f, 0, 0, 0, -0.0f);
-  const f256 v23 = permute2f128(a, b, 0x12);
-  const f256 v45 = permute2f128(b, c, 0x12);
-  static const i256 mask01 = set8i(0, 1, 2, 0, 3, 4, 5, 0);
-  static const i256 mask23 = set8i(2, 3, 4, 0, 5, 6, 7, 0);
-  f256 o01 = permutevar8x32f(a, mask01);
-  f256 o23 = permutevar8x32f(v23, mask23);
-  f256 o45 = permutevar8x32f(v45, mask01);
-  f256 o67 = permutevar8x32f(c, mask23);
-  o01 = select8f(wvalues, o01, wmask);
-  o23 = select8f(wvalues, o01, wmask);
-  o45 = select8f(wvalues, o01, wmask);
-  o67 = select8f(wvalues, o01, wmask);
-  storeu8f(output, o01);
-  storeu8f(output + 8, o23);
-  storeu8f(output + 16, o45);
-  storeu8f(output + 24, o67);
-}
-#endif
-
+/// the custom data key on a sparse UV set primvar, that holds the index of the UV used by the unmapped faces
+static const TfToken _alusd_unassignedUvIndex("alusd_unassignedUvIndex");
 
 //----------------------------------------------------------------------------------------------------------------------
-/// \brief  assuming a, b, & c are 8 packed 3D vectors of the form:
-///
-///         { v0x, v0y, v0z, v1x, v1y, v1z,   *snip*, v7x, v7y, v7z }
-///
-///         This method will convert that to 4D vectors with a 'w' value of 1.
-///
-///         { v0x, v0y, v0z, 1.0, v1x, v1y, v1z, 1.0, *snip*, v7x, v7y, v7z, 1.0 }
-///
-///         The output array must contain 32 floating poing values
-//----------------------------------------------------------------------------------------------------------------------
-static void convert3Dto4d_sse(const f128 a, const f128 b, const f128 c, float* output)
+void convert3DArrayTo4DArray(const float* const input, float* const output, size_t count)
 {
-  static const f128 wvalues = set4f(0, 0, 0, 1.0f);
-  static const f128 wmask = cast4f(set4i(0, 0, 0, 0xFFFFFFFF));
-
-  const f128 o0 = select4f(a, wvalues, wmask);
-  const f128 o3 = or4f(cast4f(shiftBytesRight(cast4i(c), 4)), wvalues);
-  f128 o1 = shuffle4f(a, b, 1, 0, 3, 3);
-  o1 = select4f(shuffle4f(o1, o1, 1, 3, 2, 0), wvalues, wmask);
-  f128 o2 = select4f(shuffle4f(b, c, 1, 0, 3, 2), wvalues, wmask);
-
-  storeu4f(output, o0);
-  storeu4f(output + 4, o1);
-  storeu4f(output + 8, o2);
-  storeu4f(output + 12, o3);
+  activeMeshKernels().convert3DArrayTo4DArray(input, output, count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-static void convert3Dto4d(const float* const c, float* const output, uint32_t count)
+void convertFloatVec3ArrayToDoubleVec3Array(const float* const input, double* const output, size_t count)
 {
-  switch(count)
-  {
-  case 3:
-    output[8] = c[6];
-    output[9] = c[7];
-    output[10] = c[8];
-    output[11] = 1.0f;
-  case 2:
-    output[4] = c[3];
-    output[5] = c[4];
-    output[6] = c[5];
-    output[7] = 1.0f;
-  case 1:
-    output[0] = c[0];
-    output[1] = c[1];
-    output[2] = c[2];
-    output[3] = 1.0f;
-    default: break;
-  }
+  activeMeshKernels().convertFloatVec3ArrayToDoubleVec3Array(input, output, count);
 }
-#endif
 
 //----------------------------------------------------------------------------------------------------------------------
-void convert3DArrayTo4DArray(const float* const input, float* const output, size_t count)
+void convert3DFloatArrayTo4DDoubleArray(const float* const input, double* const output, size_t count)
 {
-#if AL_MAYA_ENABLE_SIMD
-# if defined(__AVX2__) && ENABLE_SOME_AVX_ROUTINES
-  size_t count8 = count >> 3;
-  bool count4 = (count & 0x4) != 0;
-  uint32_t remainder = count & 0x3;
-  size_t i = 0, j = 0;
-  for(size_t n = 24 * count8; i != n; i += 24, j += 32)
-  {
-    const float* const ptr = input + i;
-    const f256 a = loadu8f(ptr);
-    const f256 b = loadu8f(ptr + 8);
-    const f256 c = loadu8f(ptr + 16);
-    convert3Dto4d_avx(a, b, c, output + j);
-  }
-  if(count4)
-  {
-    const float* const ptr = input + i;
-    const f128 a = loadu4f(ptr);
-    const f128 b = loadu4f(ptr + 4);
-    const f128 c = loadu4f(ptr + 8);
-    convert3Dto4d_sse(a, b, c, output + j);
-    i += 12;
-    j += 16;
-  }
-  convert3Dto4d(input + i, output + j, remainder);
-# elif defined(__SSE3__)
-  const size_t count4 = count >> 2;
-  const uint32_t remainder = count & 0x3;
-  size_t i = 0, j = 0;
-  for(size_t n = 12 * count4; i != n; i += 12, j += 16)
-  {
-    const float* const ptr = input + i;
-    const f128 a = loadu4f(ptr);
-    const f128 b = loadu4f(ptr + 4);
-    const f128 c = loadu4f(ptr + 8);
-    convert3Dto4d_sse(a, b, c, output + j);
-  }
-  convert3Dto4d(input + i, output + j, remainder);
-# endif
-#else
-  for(size_t i = 0, j = 0, n = count * 3; i != n; i += 3, j += 4)
-  {
-    output[j ] = input[i ];
-    output[j + 1] = input[i + 1];
-    output[j + 2] = input[i + 2];
-    output[j + 3] = 1.0f;
-  }
-#endif
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-void convertFloatVec3ArrayToDoubleVec3Array(const float* const input, double* const output, size_t count)
-{
-#if AL_MAYA_ENABLE_SIMD
-  const f128* const input128 = (const f128*)input;
-  d128* const output128 = (d128*)output;
-  const size_t count4 = count >> 2;
-  for(size_t i = 0; i < count4; ++i)
-  {
-    const f128* const input = input128 + i * 3;
-    d128* const output = output128 + i * 6;
-    const f128 r0 = input[0];
-    const f128 r1 = input[1];
-    const f128 r2 = input[2];
-    const d128 r1a = cvt2f_to_2d(cast4f(shiftBytesRight(cast4i(r0), 8)));
-    const d128 r1b = cvt2f_to_2d(cast4f(shiftBytesRight(cast4i(r1), 8)));
-    const d128 r1c = cvt2f_to_2d(cast4f(shiftBytesRight(cast4i(r2), 8)));
-    const d128 r0a = cvt2f_to_2d(r0);
-    const d128 r0b = cvt2f_to_2d(r1);
-    const d128 r0c = cvt2f_to_2d(r2);
-    output[0] = r0a;
-    output[1] = r1a;
-    output[2] = r0b;
-    output[3] = r1b;
-    output[4] = r0c;
-    output[5] = r1c;
-  }
-  for(size_t i = count4 << 2; i < count; ++i)
-  {
-    output[i * 3] = float(input[i * 3]);
-    output[i * 3 + 1] = float(input[i * 3 + 1]);
-    output[i * 3 + 2] = float(input[i * 3 + 2]);
-  }
-#else
-  for(size_t i = 0, n = 3 * count; i < n; i += 3)
-  {
-    output[i] = float(input[i]);
-    output[i + 1] = float(input[i + 1]);
-    output[i + 2] = float(input[i + 2]);
-  }
-#endif
+  activeMeshKernels().convert3DFloatArrayTo4DDoubleArray(input, output, count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -332,7 +188,17 @@ static void gatherFaceConnectsAndVertices(const UsdGeomMesh& mesh, MFloatPointAr
     }
   }
 
-  mesh.GetPointsAttr().Get(&pointData, timeCode);
+  // animated meshes (e.g. simulation caches) may only have time samples authored for their points. In that case the
+  // mesh is built from the first sample, and the remaining samples are streamed by a MeshAnimDeformer.
+  UsdAttribute pointsAttr = mesh.GetPointsAttr();
+  if(!pointsAttr.Get(&pointData, timeCode))
+  {
+    std::vector<double> times;
+    if(pointsAttr.GetTimeSamples(&times) && !times.empty())
+    {
+      pointsAttr.Get(&pointData, UsdTimeCode(times.front()));
+    }
+  }
   mesh.GetNormalsAttr().Get(&normalsData, timeCode);
 
   points.setLength(pointData.size());
@@ -380,72 +246,7 @@ static void applyHoleFaces(const UsdGeomMesh& mesh, MFnMesh& fnMesh)
 //----------------------------------------------------------------------------------------------------------------------
 void unzipUVs(const float* const uv, float* const u, float* const v, const size_t count)
 {
-#if AL_MAYA_ENABLE_SIMD
-
-#ifdef __AVX2__
-  const size_t count8 = count & ~7ULL;
-  size_t i = 0, j = 0;
-  for(; i < count8; i += 8, j += 16)
-  {
-    const f256 uva = loadu8f(uv + j);
-    const f256 uvb = loadu8f(uv + j + 8);
-    const f256 uva1 = permute2f128(uva, uvb, 0x20);
-    const f256 uvb1 = permute2f128(uva, uvb, 0x31);
-    const f256 uvals = shuffle8f(uva1, uvb1, 2, 0, 2, 0);
-    const f256 vvals = shuffle8f(uva1, uvb1, 3, 1, 3, 1);
-    storeu8f(u + i, uvals);
-    storeu8f(v + i, vvals);
-  }
-
-  if(count & 0x4)
-  {
-    const f128 uva = loadu4f(uv + j);
-    const f128 uvb = loadu4f(uv + j + 4);
-    const f128 uvals = shuffle4f(uva, uvb, 2, 0, 2, 0);
-    const f128 vvals = shuffle4f(uva, uvb, 3, 1, 3, 1);
-    storeu4f(u + i, uvals);
-    storeu4f(v + i, vvals);
-    i += 4;
-    j += 8;
-  }
-#else
-
-  const size_t count4 = count & ~3ULL;
-  size_t i = 0, j = 0;
-  for(; i < count4; i += 4, j += 8)
-  {
-    const f128 uva = loadu4f(uv + j);
-    const f128 uvb = loadu4f(uv + j + 4);
-    const f128 uvals = shuffle4f(uva, uvb, 2, 0, 2, 0);
-    const f128 vvals = shuffle4f(uva, uvb, 3, 1, 3, 1);
-    storeu4f(u + i, uvals);
-    storeu4f(v + i, vvals);
-  }
-
-#endif
-
-  switch(count & 3)
-  {
-  case 3:
-    u[i + 2] = uv[j + 4];
-    v[i + 2] = uv[j + 5];
-  case 2:
-    u[i + 1] = uv[j + 2];
-    v[i + 1] = uv[j + 3];
-  case 1:
-    u[i] = uv[j];
-    v[i] = uv[j + 1];
-  default:
-    break;
-  }
-
-#else
-  for(size_t i = 0, j = 0; i < count; ++i, j += 2)
-  {
-    u[i] = uv[j];
-    v[i] = uv[j + 1];
-  }
-#endif
+  activeMeshKernels().unzipUVs(uv, u, v, count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -797,6 +598,20 @@ static void applyPrimVars(const UsdGeomMesh& mesh, MFnMesh& fnMesh, const MIntAr
         v.setLength(rawVal.size());
         unzipUVs((const float*)rawVal.cdata(), &u[0], &v[0], rawVal.size());
 
+        // a sparse UV set, where the unmapped faces index a single unassigned UV. If that UV was appended to the end
+        // of the values (as the exporter does), it's dropped so that it doesn't end up as an orphaned UV in maya.
+        int32_t unassignedIndex = -1;
+        const VtValue unassigned = primvar.GetAttr().GetCustomDataByKey(_alusd_unassignedUvIndex);
+        if(unassigned.IsHolding<int32_t>() && primvar.IsIndexed() && interpolation == UsdGeomTokens->faceVarying)
+        {
+          unassignedIndex = unassigned.UncheckedGet<int32_t>();
+          if(unassignedIndex == int32_t(rawVal.size()) - 1)
+          {
+            u.setLength(unassignedIndex);
+            v.setLength(unassignedIndex);
+          }
+        }
+
         MString uvSetName(name.GetText());
         MString* uv_set = &uvSetName;
         if (uvSetName == "st")
@@ -815,8 +630,22 @@ static void applyPrimVars(const UsdGeomMesh& mesh, MFnMesh& fnMesh, const MIntAr
               {
                 VtIntArray usdindices;
                 primvar.GetIndices(&usdindices);
-                indices = MIntArray(usdindices.cdata(), usdindices.size());
-                if(!fnMesh.assignUVs(counts, indices, uv_set))
+                bool assigned;
+                if(unassignedIndex >= 0 && counts.length() && usdindices.size() == connects.length())
+                {
+                  MIntArray uvCounts(counts);
+                  indices.setLength(usdindices.size());
+                  const uint32_t numIds =
+                      compactSparseUvIndices(&uvCounts[0], &indices[0], usdindices.cdata(), uvCounts.length(), unassignedIndex);
+                  indices.setLength(numIds);
+                  assigned = fnMesh.assignUVs(uvCounts, indices, uv_set);
+                }
+                else
+                {
+                  indices = MIntArray(usdindices.cdata(), usdindices.size());
+                  assigned = fnMesh.assignUVs(counts, indices, uv_set);
+                }
+                if(!assigned)
                 {
                   std::cout << "Failed to assign UVS for uvset: " << uvSetName.asChar() << ", on mesh " << fnMesh.name().asChar() << "\n";
                 }
@@ -909,381 +738,67 @@ bool MeshTranslator::attributeHandled(const UsdAttribute& usdAttr)
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
 
-//----------------------------------------------------------------------------------------------------------------------
-static void copyFaceConnectsAndPolyCounts(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
-{
-  MIntArray faceConnects, polyCounts;
-  fnMesh.getVertices(polyCounts, faceConnects);
-  VtArray<int32_t> faceVertexCounts(polyCounts.length());
-  VtArray<int32_t> faceVertexIndices(faceConnects.length());
-  memcpy((int32_t*)faceVertexCounts.data(), &polyCounts[0], sizeof(uint32_t) * polyCounts.length());
-  memcpy((int32_t*)faceVertexIndices.data(), &faceConnects[0], sizeof(uint32_t) * faceConnects.length());
-  mesh.GetFaceVertexCountsAttr().Set(faceVertexCounts);
-  mesh.GetFaceVertexIndicesAttr().Set(faceVertexIndices);
-}
-
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  Checks to see if any elements within the UV counts array happen to be zero.
 //----------------------------------------------------------------------------------------------------------------------
 bool isUvSetDataSparse(const int32_t* uvCounts, const uint32_t count)
 {
-#if AL_MAYA_ENABLE_SIMD
-# if defined(__AVX2__) && ENABLE_SOME_AVX_ROUTINES
-  const i256* counts = (const __m256i*)&uvCounts[0];
-  const i256 zero = zero8i();
-  const uint32_t count8 = count >> 3;
-
-  for(uint32_t i = 0; i < count8; ++i)
-  {
-    if(movemask8i(cmpeq8i(zero, loadu8i(counts + i))))
-      return true;
-  }
-
-  for(uint32_t i = count8 << 3; i < count; ++i)
-  {
-    if(!uvCounts[i]) return true;
-  }
-# else
-  const i128* counts = (const i128*)(&uvCounts[0]);
-  const i128 zero = zero4i();
-  const uint32_t count4 = count >> 2;
-
-  for(uint32_t i = 0; i < count4; ++i)
-  {
-    if(movemask4i(cmpeq4i(zero, loadu4i(counts + i))))
-      return true;
-  }
-
-  for(uint32_t i = count4 << 2; i < count; ++i)
-  {
-    if(!uvCounts[i]) return true;
-  }
-# endif
-#else
-  for(uint32_t i = 0; i < count; ++i)
-  {
-    if(!uvCounts[i])
-      return true;
-  }
-#endif
-  return false;
+  return activeMeshKernels().isUvSetDataSparse(uvCounts, count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 void zipUVs(const float* u, const float* v, float* uv, const size_t count)
 {
-#if AL_MAYA_ENABLE_SIMD
-# ifdef __AVX2__
-
-  uint32_t uvCount8 = count & ~7U;
-
-  for(uint32_t i = 0; i < uvCount8; i += 8, uv += 16)
-  {
-    const f256 U = loadu8f(u + i);
-    const f256 V = loadu8f(v + i);
-    const f256 uv0 = unpacklo8f(U, V);
-    const f256 uv1 = unpackhi8f(U, V);
-    storeu8f(uv, permute2f128(uv0, uv1, 0x20));
-    storeu8f(uv + 8, permute2f128(uv0, uv1, 0x31));
-  }
-
-  if(count & 0x4)
-  {
-    const f128 U = loadu4f(u + uvCount8);
-    const f128 V = loadu4f(v + uvCount8);
-    storeu4f(uv, unpacklo4f(U, V));
-    storeu4f(uv + 4, unpackhi4f(U, V));
-    uv += 8;
-    uvCount8 += 4;
-  }
-
-  switch(count & 3)
-  {
-  case 3:
-    uv[4] = u[uvCount8 + 2];
-    uv[5] = v[uvCount8 + 2];
-  case 2:
-    uv[2] = u[uvCount8 + 1];
-    uv[3] = v[uvCount8 + 1];
-  case 1:
-    uv[0] = u[uvCount8 + 0];
-    uv[1] = v[uvCount8 + 0];
-  default:
-    break;
-  }
-
-# else
-
-  const uint32_t uvCount4 = count & ~3U;
-
-  for(uint32_t i = 0; i < uvCount4; i += 4, uv += 8)
-  {
-    const f128 U = loadu4f(u + i);
-    const f128 V = loadu4f(v + i);
-    storeu4f(uv, unpacklo4f(U, V));
-    storeu4f(uv + 4, unpackhi4f(U, V));
-  }
-
-  switch(count & 3)
-  {
-  case 3:
-    uv[4] = u[uvCount4 + 2];
-    uv[5] = v[uvCount4 + 2];
-  case 2:
-    uv[2] = u[uvCount4 + 1];
-    uv[3] = v[uvCount4 + 1];
-  case 1:
-    uv[0] = u[uvCount4 + 0];
-    uv[1] = v[uvCount4 + 0];
-  default:
-    break;
-  }
-
-# endif
-#else
-  for(uint32_t i = 0, j = 0; i < count; i++, j += 2)
-  {
-    uv[j] = u[i];
-    uv[j + 1] = v[i];
-  }
-#endif
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-static void copyUvSetData(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
-{
-  UsdPrim prim = mesh.GetPrim();
-  MStringArray uvSetNames;
-  MStatus status = fnMesh.getUVSetNames(uvSetNames);
-  if(status == MS::kSuccess && uvSetNames.length() > 0)
-  {
-    VtArray<GfVec2f> uvValues;
-    MFloatArray uValues, vValues;
-    MIntArray uvCounts, uvIds;
-
-    for (uint32_t i = 0; i < uvSetNames.length(); i++)
-    {
-      // Initialize the VtArray to the max possible size (facevarying)
-      if(fnMesh.getAssignedUVs(uvCounts, uvIds, &uvSetNames[i]))
-      {
-        int32_t* ptr = &uvCounts[0];
-        if(!isUvSetDataSparse(ptr, uvCounts.length()))
-        {
-          if(fnMesh.getUVs(uValues, vValues, &uvSetNames[i]))
-          {
-            uvValues.resize(uValues.length());
-            if (uvSetNames[i] == "map1")
-            {
-              uvSetNames[i] = "st";
-            }
-
-            float* uptr = &uValues[0];
-            float* vptr = &vValues[0];
-            float* uvptr = (float*)uvValues.data();
-            zipUVs(uptr, vptr, uvptr, vValues.length());
-
-            /// \todo   Ideally I'd want some form of interpolation scheme such as UsdGeomTokens->faceVaryingIndexed
-            UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->faceVarying);
-            uvSet.Set(uvValues);
-
-            VtArray<int32_t> uvIndices;
-            int32_t* ptr = &uvIds[0];
-            uvIndices.assign(ptr, ptr + uvIds.length());
-
-            uvSet.SetIndices(uvIndices);
-          }
-        }
-        else
-        {
-          // What to do here then....
-        }
-      }
-    }
-  }
+  activeMeshKernels().zipUVs(u, v, uv, count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 void interleaveIndexedUvData(float* output, const float* u, const float* v, const int32_t* indices, const uint32_t numIndices)
 {
-#if AL_MAYA_ENABLE_SIMD
-
-#if defined(__AVX2__) && ENABLE_SOME_AVX_ROUTINES
-
-  const uint32_t numIndices8 = numIndices & ~7;
-  uint32_t i = 0;
-  for(; i < numIndices8; i += 8, output += 16)
-  {
-    const i256 I = loadu8i(indices + i);
-    const f256 U = i32gather8f(u, I);
-    const f256 V = i32gather8f(v, I);
-    const f256 uv0 = unpacklo8f(U, V);
-    const f256 uv1 = unpackhi8f(U, V);
-    storeu8f(output, permute2f128(uv0, uv1, 0x20));
-    storeu8f(output + 8, permute2f128(uv0, uv1, 0x31));
-  }
-
-  if(numIndices & 0x4)
-  {
-    const i128 I = loadu4i(indices + i);
-    const f128 U = i32gather4f(u, I);
-    const f128 V = i32gather4f(v, I);
-    const f128 uv0 = unpacklo4f(U, V);
-    const f128 uv1 = unpackhi4f(U, V);
-    storeu4f(output, uv0);
-    storeu4f(output + 4, uv1);
-    output += 8;
-    i += 4;
-  }
-
-#else
-
-  const i128 uptr = splat2i64(intptr_t(u));
-  const i128 vptr = splat2i64(intptr_t(v));
-  const i128 mask = set4i(0xFFFFFFFF, 0, 0xFFFFFFFF, 0);
-
-  const uint32_t numIndices4 = numIndices & ~3;
-  uint32_t i = 0;
-  for(; i < numIndices4; i += 4, output += 8)
-  {
-    // load 4 indices
-    const i128 I = loadu4i(indices + i);
-
-    // mask out into 2 pairs of 64 bit indices, and scale values by 4 (using shift)
-    const i128 I02 = lshift64(and4i(mask, I), 2);
-    const i128 I13 = lshift64(and4i(mask, shiftBytesRight(I, 4)), 2);
-
-    // get addresses by adding the base offset
-    const i128 U02 = add2i64(I02, uptr);
-    const i128 U13 = add2i64(I13, uptr);
-    const i128 V02 = add2i64(I02, vptr);
-    const i128 V13 = add2i64(I13, vptr);
-
-    #ifndef __SSE4_1__
-    ALIGN16(float* ptrs[8]);
-    store4i(ptrs    , U02);
-    store4i(ptrs + 2, U13);
-    store4i(ptrs + 4, V02);
-    store4i(ptrs + 6, V13);
-
-    const f128 u0 = load1f(ptrs[0]);
-    const f128 u2 = load1f(ptrs[1]);
-    const f128 u1 = load1f(ptrs[2]);
-    const f128 u3 = load1f(ptrs[3]);
-    const f128 v0 = load1f(ptrs[4]);
-    const f128 v2 = load1f(ptrs[5]);
-    const f128 v1 = load1f(ptrs[6]);
-    const f128 v3 = load1f(ptrs[7]);
-    #else
-    #define extract_float_ptr(reg, index) reinterpret_cast<const float*>(_mm_extract_epi64(reg, index))
-    const f128 u0 = load1f(extract_float_ptr(U02, 0));
-    const f128 u2 = load1f(extract_float_ptr(U02, 1));
-    const f128 u1 = load1f(extract_float_ptr(U13, 0));
-    const f128 u3 = load1f(extract_float_ptr(U13, 1));
-    const f128 v0 = load1f(extract_float_ptr(V02, 0));
-    const f128 v2 = load1f(extract_float_ptr(V02, 1));
-    const f128 v1 = load1f(extract_float_ptr(V13, 0));
-    const f128 v3 = load1f(extract_float_ptr(V13, 1));
-    #undef extract_ptr
-    #endif
-
-    const f128 uv0 = unpacklo4f(u0, v0);
-    const f128 uv1 = unpacklo4f(u1, v1);
-    storeu4f(output, movelh4f(uv0, uv1));
-
-    const f128 uv2 = unpacklo4f(u2, v2);
-    const f128 uv3 = unpacklo4f(u3, v3);
-    storeu4f(output + 4, movelh4f(uv2, uv3));
-  }
-
-#endif
-
-  switch(numIndices & 0x3)
-  {
-  case 3: output[4] = u[indices[i + 2]];
-          output[5] = v[indices[i + 2]];
-  case 2: output[2] = u[indices[i + 1]];
-          output[3] = v[indices[i + 1]];
-  case 1: output[0] = u[indices[i]];
-          output[1] = v[indices[i]];
-  default: break;
-  }
-
-#else
-
-  for(uint32_t i = 0, j = 0; i < numIndices; ++i, j += 2)
-  {
-    output[j] = u[indices[i]];
-    output[j + 1] = v[indices[i]];
-  }
-
-#endif
+  activeMeshKernels().interleaveIndexedUvData(output, u, v, indices, numIndices);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-// Loops through each Colour Set in the mesh writing out a set of non-indexed Colour Values in RGBA format,
-// Writes out faceVarying values only
-// Have a special case for "displayColor" which write as RGB
-// @todo: needs refactoring to handle face/vert/faceVarying correctly, allow separate RGB/A to be written etc.
-static void copyColourSetData(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
+void expandSparseUvIndices(int32_t* indices, const int32_t* polyCounts, const int32_t* uvCounts, const int32_t* uvIds,
+                           const uint32_t numFaces, const int32_t unassignedIndex)
 {
-  UsdPrim prim = mesh.GetPrim();
-  MStringArray colourSetNames;
-  MStatus status = fnMesh.getColorSetNames(colourSetNames);
-  if(status == MS::kSuccess && colourSetNames.length())
+  for(uint32_t i = 0; i < numFaces; ++i)
   {
-    VtArray<GfVec4f> colourValues;
-    MColorArray colours;
-    MIntArray uvCounts, uvIds;
-
-    for (uint32_t i = 0; i < colourSetNames.length(); i++)
+    const int32_t count = polyCounts[i];
+    if(uvCounts[i])
     {
-      MColor defaultColour(1, 0, 0);
-
-      //If we're writing displayColor which is part of the GPrim Schema, we need to force to Vec3.
-      if(colourSetNames[i] ==  "displayColor")
-      {
-        if(fnMesh.getColors(colours, &colourSetNames[i]))
-        {
-          VtArray<GfVec3f> colourValues;
-          colourValues.resize(colours.length());
-          for (uint32_t j = 0; j < colours.length(); j++) {
-            colourValues[j] = GfVec3f(colours[j].r, colours[j].g, colours[j].b);
-          }
-          UsdGeomPrimvar colourSet = mesh.CreatePrimvar(TfToken(colourSetNames[i].asChar()), SdfValueTypeNames->Float3Array, UsdGeomTokens->faceVarying);
-          colourSet.Set(colourValues);
-        }
-      }
-      else
-      {
-        //@todo: This code is duplicated - refactor to handle RGB/Vec3, RGBA/Vec4, RGB/Vec3 + A/Vec1 etc
-        if(fnMesh.getColors(colours, &colourSetNames[i]))
-        {
-          colourValues.resize(colours.length());
-          float* to = (float*)colourValues.data();
-          const float* from = &colours[0].r;
-          memcpy(to, from, sizeof(float) * 4 * colours.length());
-
-          UsdGeomPrimvar colourSet = mesh.CreatePrimvar(TfToken(colourSetNames[i].asChar()), SdfValueTypeNames->Float4Array, UsdGeomTokens->faceVarying);
-          colourSet.Set(colourValues);
-        }
-      }
+      std::memcpy(indices, uvIds, sizeof(int32_t) * count);
+      uvIds += count;
     }
+    else
+    {
+      std::fill(indices, indices + count, unassignedIndex);
+    }
+    indices += count;
   }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-static void copyInvisibleHoles(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
+uint32_t compactSparseUvIndices(int32_t* uvCounts, int32_t* uvIds, const int32_t* indices, const uint32_t numFaces,
+                                const int32_t unassignedIndex)
 {
-  // Holes - we treat InvisibleFaces as holes
-  MUintArray mayaHoles = fnMesh.getInvisibleFaces();
-  const uint32_t count = mayaHoles.length();
-  if (count)
+  const int32_t* const start = uvIds;
+  for(uint32_t i = 0; i < numFaces; ++i)
   {
-    VtArray<int32_t> subdHoles(count);
-    uint32_t* ptr = &mayaHoles[0];
-    memcpy((int32_t*)subdHoles.data(), ptr, count);
-    mesh.GetHoleIndicesAttr().Set(subdHoles);
+    const int32_t count = uvCounts[i];
+    const int32_t* const end = indices + count;
+    if(std::find(indices, end, unassignedIndex) == end)
+    {
+      std::memcpy(uvIds, indices, sizeof(int32_t) * count);
+      uvIds += count;
+    }
+    else
+    {
+      uvCounts[i] = 0;
+    }
+    indices = end;
   }
+  return uint32_t(uvIds - start);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1361,23 +876,6 @@ static void copyAnimalCreaseVertices(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
   }
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-static void copyCreaseVertices(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
-{
-  MUintArray vertIds;
-  MDoubleArray creaseData;
-  MStatus status = fnMesh.getCreaseVertices(vertIds, creaseData);
-  if(status && creaseData.length() && vertIds.length())
-  {
-    VtArray<int> subdCornerIndices(vertIds.length());
-    VtArray<float> subdCornerSharpnesses(creaseData.length());
-    doubleToFloat(subdCornerSharpnesses.data(), &creaseData[0], creaseData.length());
-    memcpy(subdCornerIndices.data(), (uint32_t*)&vertIds[0], vertIds.length() * sizeof(int32_t));
-    mesh.GetCornerIndicesAttr().Set(subdCornerIndices);
-    mesh.GetCornerSharpnessesAttr().Set(subdCornerSharpnesses);
-  }
-}
-
 //----------------------------------------------------------------------------------------------------------------------
 static void copyAnimalCreaseEdges(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
 {
@@ -1413,51 +911,6 @@ static void copyAnimalCreaseEdges(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
   }
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-static void copyCreaseEdges(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
-{
-  MUintArray edgeIds;
-  MDoubleArray creaseData;
-  MStatus status = fnMesh.getCreaseEdges(edgeIds, creaseData);
-  if (status && edgeIds.length() && creaseData.length())
-  {
-    UsdPrim prim = mesh.GetPrim();
-    {
-      VtArray<float> usdCreaseValues;
-      usdCreaseValues.resize(creaseData.length());
-      doubleToFloat(usdCreaseValues.data(), (double*)&creaseData[0], creaseData.length());
-      mesh.GetCreaseSharpnessesAttr().Set(usdCreaseValues);
-    }
-
-    {
-      UsdAttribute creases = mesh.GetCreaseIndicesAttr();
-      VtArray<int32_t> usdCreaseIndices;
-      usdCreaseIndices.resize(edgeIds.length() * 2);
-
-      for(uint32_t i = 0, j = 0; i < edgeIds.length(); ++i, j += 2)
-      {
-        int2 vertexIds;
-        fnMesh.getEdgeVertices(edgeIds[i], vertexIds);
-        usdCreaseIndices[j] = vertexIds[0];
-        usdCreaseIndices[j + 1] = vertexIds[1];
-      }
-
-      creases.Set(usdCreaseIndices);
-    }
-
-    // Note: In the original USD maya bridge, they actually attempt to merge creases.
-    // I'm not doing that at all (to be honest their approach looks to be questionable as to whether it would actually
-    // work all that well, if at all).
-    {
-      UsdAttribute creasesLengths = mesh.GetCreaseLengthsAttr();
-      VtArray<int32_t> lengths;
-      lengths.resize(creaseData.length());
-      std::fill(lengths.begin(), lengths.end(), 2);
-      creasesLengths.Set(lengths);
-    }
-  }
-}
-
 //----------------------------------------------------------------------------------------------------------------------
 
 // Loops through each Colour Set in the mesh writing out a set of non-indexed Colour Values in RGBA format,
@@ -1492,20 +945,381 @@ static void copyAnimalFaceColours(UsdGeomMesh& mesh, const MFnMesh& fnMesh)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void MeshTranslator::copyVertexData(const MFnMesh& fnMesh, const UsdAttribute& pointsAttr, UsdTimeCode time)
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The mesh data exported to USD. The raw data is read from the maya mesh on the main thread (gather), the
+///         conversion into USD arrays is run as a set of independent tasks on the work pool (convert), and the
+///         resulting arrays are then authored on the main thread through the Sdf API, within a single SdfChangeBlock
+///         (commit).
+//----------------------------------------------------------------------------------------------------------------------
+struct MeshExportData
+{
+  /// a UV set read from maya
+  struct UvSet
+  {
+    TfToken name;
+    MFloatArray u, v;
+    MIntArray counts, ids;
+    VtArray<GfVec2f> values;
+    VtArray<int32_t> indices;
+    int32_t unassignedIndex = -1; ///< the index of the UV used by the unmapped faces of a sparse UV set
+    bool valid = false;
+  };
+
+  /// a colour set read from maya
+  struct ColourSet
+  {
+    TfToken name;
+    MColorArray colours;
+    VtArray<GfVec3f> rgb; ///< only used for displayColor
+    VtArray<GfVec4f> rgba;
+    bool isDisplayColour = false;
+    bool valid = false;
+  };
+
+  /// \brief  reads the data from the maya mesh. Must be called on the main thread.
+  /// \param  fnMesh the mesh to read from
+  /// \param  subdivisionData if true, the colour sets and creases are also gathered
+  void gather(const MFnMesh& fnMesh, bool subdivisionData);
+
+  /// \brief  converts the gathered data into USD arrays on the work pool
+  void convert();
+
+  /// \brief  authors the converted data on the USD mesh
+  /// \param  mesh the USD mesh to write into
+  void commit(UsdGeomMesh& mesh);
+
+  MIntArray polyCounts, faceConnects;
+  MUintArray holes;
+  std::vector<UvSet> uvSets;
+  std::vector<ColourSet> colourSets;
+  MUintArray creaseVertexIds;
+  MDoubleArray creaseVertexData;
+  MDoubleArray creaseEdgeData;
+  VtArray<int32_t> creaseIndices;
+
+  VtArray<int32_t> faceVertexCounts, faceVertexIndices, holeIndices;
+  VtArray<int32_t> cornerIndices, creaseLengths;
+  VtArray<float> cornerSharpnesses, creaseSharpnesses;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshExportData::gather(const MFnMesh& fnMesh, const bool subdivisionData)
+{
+  fnMesh.getVertices(polyCounts, faceConnects);
+  holes = fnMesh.getInvisibleFaces();
+
+  MStringArray uvSetNames;
+  if(fnMesh.getUVSetNames(uvSetNames) && uvSetNames.length())
+  {
+    uvSets.resize(uvSetNames.length());
+    for(uint32_t i = 0; i < uvSetNames.length(); ++i)
+    {
+      UvSet& uvSet = uvSets[i];
+      if(fnMesh.getAssignedUVs(uvSet.counts, uvSet.ids, &uvSetNames[i]) &&
+         fnMesh.getUVs(uvSet.u, uvSet.v, &uvSetNames[i]))
+      {
+        uvSet.name = TfToken(uvSetNames[i] == "map1" ? "st" : uvSetNames[i].asChar());
+        uvSet.valid = true;
+      }
+    }
+  }
+
+  if(!subdivisionData)
+    return;
+
+  MStringArray colourSetNames;
+  if(fnMesh.getColorSetNames(colourSetNames) && colourSetNames.length())
+  {
+    colourSets.resize(colourSetNames.length());
+    for(uint32_t i = 0; i < colourSetNames.length(); ++i)
+    {
+      ColourSet& colourSet = colourSets[i];
+      if(fnMesh.getColors(colourSet.colours, &colourSetNames[i]))
+      {
+        colourSet.name = TfToken(colourSetNames[i].asChar());
+        colourSet.isDisplayColour = colourSetNames[i] == "displayColor";
+        colourSet.valid = true;
+      }
+    }
+  }
+
+  if(!fnMesh.getCreaseVertices(creaseVertexIds, creaseVertexData))
+  {
+    creaseVertexIds.clear();
+    creaseVertexData.clear();
+  }
+
+  // the edge vertices have to be queried from the mesh, so the crease indices are built here
+  MUintArray creaseEdgeIds;
+  if(fnMesh.getCreaseEdges(creaseEdgeIds, creaseEdgeData) && creaseEdgeIds.length() && creaseEdgeData.length())
+  {
+    creaseIndices.resize(creaseEdgeIds.length() * 2);
+    for(uint32_t i = 0, j = 0; i < creaseEdgeIds.length(); ++i, j += 2)
+    {
+      int2 vertexIds;
+      fnMesh.getEdgeVertices(creaseEdgeIds[i], vertexIds);
+      creaseIndices[j] = vertexIds[0];
+      creaseIndices[j + 1] = vertexIds[1];
+    }
+  }
+  else
+  {
+    creaseEdgeData.clear();
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshExportData::convert()
+{
+  std::vector<std::function<void()> > tasks;
+
+  tasks.emplace_back([this]()
+  {
+    faceVertexCounts.resize(polyCounts.length());
+    faceVertexIndices.resize(faceConnects.length());
+    if(polyCounts.length())
+      memcpy((int32_t*)faceVertexCounts.data(), &polyCounts[0], sizeof(int32_t) * polyCounts.length());
+    if(faceConnects.length())
+      memcpy((int32_t*)faceVertexIndices.data(), &faceConnects[0], sizeof(int32_t) * faceConnects.length());
+  });
+
+  if(holes.length())
+  {
+    tasks.emplace_back([this]()
+    {
+      holeIndices.resize(holes.length());
+      memcpy((int32_t*)holeIndices.data(), &holes[0], sizeof(int32_t) * holes.length());
+    });
+  }
+
+  for(auto& uvSet : uvSets)
+  {
+    if(!uvSet.valid)
+      continue;
+    tasks.emplace_back([this, &uvSet]()
+    {
+      const uint32_t numUvs = uvSet.u.length();
+      const uint32_t numFaces = uvSet.counts.length();
+      const bool sparse = numFaces && isUvSetDataSparse(&uvSet.counts[0], numFaces);
+
+      uvSet.values.resize(numUvs + (sparse ? 1 : 0));
+      if(numUvs)
+        zipUVs(&uvSet.u[0], &uvSet.v[0], (float*)uvSet.values.data(), numUvs);
+
+      if(sparse)
+      {
+        // Only some of the faces are mapped. The face-vertices of the unmapped faces all index a single (0, 0) UV
+        // appended to the values, rather than padding the values out to a dense faceVarying array.
+        uvSet.unassignedIndex = int32_t(numUvs);
+        uvSet.values[numUvs] = GfVec2f(0.0f);
+        uvSet.indices.resize(faceConnects.length());
+        expandSparseUvIndices(uvSet.indices.data(), &polyCounts[0], &uvSet.counts[0],
+                              uvSet.ids.length() ? &uvSet.ids[0] : nullptr, numFaces, uvSet.unassignedIndex);
+      }
+      else
+      if(uvSet.ids.length())
+      {
+        uvSet.indices.assign(&uvSet.ids[0], &uvSet.ids[0] + uvSet.ids.length());
+      }
+    });
+  }
+
+  for(auto& colourSet : colourSets)
+  {
+    if(!colourSet.valid)
+      continue;
+    tasks.emplace_back([&colourSet]()
+    {
+      const uint32_t numColours = colourSet.colours.length();
+      if(colourSet.isDisplayColour)
+      {
+        // displayColor is part of the GPrim schema, so has to be written as RGB
+        colourSet.rgb.resize(numColours);
+        for(uint32_t i = 0; i < numColours; ++i)
+        {
+          const MColor& colour = colourSet.colours[i];
+          colourSet.rgb[i] = GfVec3f(colour.r, colour.g, colour.b);
+        }
+      }
+      else
+      {
+        colourSet.rgba.resize(numColours);
+        if(numColours)
+          memcpy((float*)colourSet.rgba.data(), &colourSet.colours[0].r, sizeof(float) * 4 * numColours);
+      }
+    });
+  }
+
+  if(creaseVertexIds.length() && creaseVertexData.length())
+  {
+    tasks.emplace_back([this]()
+    {
+      cornerIndices.resize(creaseVertexIds.length());
+      cornerSharpnesses.resize(creaseVertexData.length());
+      doubleToFloat(cornerSharpnesses.data(), &creaseVertexData[0], creaseVertexData.length());
+      memcpy(cornerIndices.data(), &creaseVertexIds[0], creaseVertexIds.length() * sizeof(int32_t));
+    });
+  }
+
+  if(creaseEdgeData.length())
+  {
+    tasks.emplace_back([this]()
+    {
+      creaseSharpnesses.resize(creaseEdgeData.length());
+      doubleToFloat(creaseSharpnesses.data(), &creaseEdgeData[0], creaseEdgeData.length());
+
+      // Note: In the original USD maya bridge, they actually attempt to merge creases.
+      // I'm not doing that at all (to be honest their approach looks to be questionable as to whether it would actually
+      // work all that well, if at all).
+      creaseLengths.resize(creaseEdgeData.length());
+      std::fill(creaseLengths.begin(), creaseLengths.end(), 2);
+    });
+  }
+
+  WorkParallelForN(tasks.size(), [&tasks](size_t begin, size_t end)
+  {
+    for(size_t i = begin; i != end; ++i)
+    {
+      tasks[i]();
+    }
+  });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  a value to author as the default value of an attribute spec
+//----------------------------------------------------------------------------------------------------------------------
+struct AttributeValue
+{
+  AttributeValue(const UsdAttribute& attr, const VtValue& value)
+    : name(attr.GetName()), typeName(attr.GetTypeName()), variability(attr.GetVariability()), custom(attr.IsCustom()),
+      value(value) {}
+  AttributeValue(const TfToken& name, const SdfValueTypeName& typeName, const VtValue& value)
+    : name(name), typeName(typeName), variability(SdfVariabilityVarying), custom(false), value(value) {}
+
+  TfToken name;
+  SdfValueTypeName typeName;
+  SdfVariability variability;
+  bool custom;
+  VtValue value;
+  VtValue customData; ///< the value of the _alusd_unassignedUvIndex custom data, if any
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshExportData::commit(UsdGeomMesh& mesh)
+{
+  // The primvars are created through the schema API first, as that requires the stage to recompose. The type of each
+  // attribute is looked up at the same time, so that the (large) array values can then be authored through the Sdf
+  // API alone, within a single change block.
+  std::vector<AttributeValue> values;
+  values.emplace_back(mesh.GetFaceVertexCountsAttr(), VtValue(faceVertexCounts));
+  values.emplace_back(mesh.GetFaceVertexIndicesAttr(), VtValue(faceVertexIndices));
+
+  // Holes - we treat InvisibleFaces as holes
+  if(!holeIndices.empty())
+  {
+    values.emplace_back(mesh.GetHoleIndicesAttr(), VtValue(holeIndices));
+  }
+
+  for(auto& uvSet : uvSets)
+  {
+    if(!uvSet.valid)
+      continue;
+    /// \todo   Ideally I'd want some form of interpolation scheme such as UsdGeomTokens->faceVaryingIndexed
+    UsdGeomPrimvar primvar = mesh.CreatePrimvar(uvSet.name, SdfValueTypeNames->Float2Array, UsdGeomTokens->faceVarying);
+    values.emplace_back(primvar.GetAttr(), VtValue(uvSet.values));
+    if(uvSet.unassignedIndex >= 0)
+    {
+      values.back().customData = VtValue(uvSet.unassignedIndex);
+    }
+
+    // the attribute UsdGeomPrimvar::SetIndices would author
+    const TfToken indicesName(primvar.GetAttr().GetName().GetString() + ":indices");
+    values.emplace_back(indicesName, SdfValueTypeNames->IntArray, VtValue(uvSet.indices));
+  }
+
+  // Each colour set is written as a set of non-indexed faceVarying values, in RGBA format (other than displayColor).
+  // @todo: needs refactoring to handle face/vert/faceVarying correctly, allow separate RGB/A to be written etc.
+  for(auto& colourSet : colourSets)
+  {
+    if(!colourSet.valid)
+      continue;
+    if(colourSet.isDisplayColour)
+    {
+      UsdGeomPrimvar primvar = mesh.CreatePrimvar(colourSet.name, SdfValueTypeNames->Float3Array, UsdGeomTokens->faceVarying);
+      values.emplace_back(primvar.GetAttr(), VtValue(colourSet.rgb));
+    }
+    else
+    {
+      UsdGeomPrimvar primvar = mesh.CreatePrimvar(colourSet.name, SdfValueTypeNames->Float4Array, UsdGeomTokens->faceVarying);
+      values.emplace_back(primvar.GetAttr(), VtValue(colourSet.rgba));
+    }
+  }
+
+  if(!cornerIndices.empty())
+  {
+    values.emplace_back(mesh.GetCornerIndicesAttr(), VtValue(cornerIndices));
+    values.emplace_back(mesh.GetCornerSharpnessesAttr(), VtValue(cornerSharpnesses));
+  }
+
+  if(!creaseSharpnesses.empty())
+  {
+    values.emplace_back(mesh.GetCreaseSharpnessesAttr(), VtValue(creaseSharpnesses));
+    values.emplace_back(mesh.GetCreaseIndicesAttr(), VtValue(creaseIndices));
+    values.emplace_back(mesh.GetCreaseLengthsAttr(), VtValue(creaseLengths));
+  }
+
+  const UsdEditTarget editTarget = mesh.GetPrim().GetStage()->GetEditTarget();
+  const SdfLayerHandle layer = editTarget.GetLayer();
+  const SdfPath primPath = editTarget.MapToSpecPath(mesh.GetPath());
+
+  SdfChangeBlock changeBlock;
+  SdfPrimSpecHandle primSpec = SdfCreatePrimInLayer(layer, primPath);
+  if(!primSpec)
+  {
+    return;
+  }
+  for(const AttributeValue& value : values)
+  {
+    SdfAttributeSpecHandle attrSpec = layer->GetAttributeAtPath(primPath.AppendProperty(value.name));
+    if(!attrSpec)
+    {
+      attrSpec = SdfAttributeSpec::New(primSpec, value.name, value.typeName, value.variability, value.custom);
+      if(!attrSpec)
+        continue;
+    }
+    attrSpec->SetDefaultValue(value.value);
+    if(!value.customData.IsEmpty())
+    {
+      attrSpec->SetCustomData(_alusd_unassignedUvIndex.GetString(), value.customData);
+    }
+  }
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+bool MeshTranslator::getVertexData(const MFnMesh& fnMesh, VtArray<GfVec3f>& points)
 {
   MStatus status;
   const uint32_t numVertices = fnMesh.numVertices();
-  VtArray<GfVec3f> points(numVertices);
   const float* pointsData = fnMesh.getRawPoints(&status);
   if(status)
   {
+    points.resize(numVertices);
     memcpy((GfVec3f*)points.data(), pointsData, sizeof(float) * 3 * numVertices);
-    pointsAttr.Set(points, time);
+    return true;
   }
-  else
+  MGlobal::displayError(MString("Unable to access mesh vertices on mesh: ") + fnMesh.fullPathName());
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshTranslator::copyVertexData(const MFnMesh& fnMesh, const UsdAttribute& pointsAttr, UsdTimeCode time)
+{
+  VtArray<GfVec3f> points;
+  if(getVertexData(fnMesh, points))
   {
-    MGlobal::displayError(MString("Unable to access mesh vertices on mesh: ") + fnMesh.fullPathName());
+    pointsAttr.Set(points, time);
   }
 }
 
@@ -1524,14 +1338,16 @@ UsdPrim MeshTranslator::exportObject(UsdStageRefPtr stage, MDagPath path, const
   if(status)
   {
     UsdAttribute pointsAttr = mesh.GetPointsAttr();
-    if (params.m_animTranslator && AnimationTranslator::isAnimatedMesh(path))
+    if (params.m_animTranslator && params.m_animTranslator->isMeshAnimated(path))
     {
       params.m_animTranslator->addMesh(path, pointsAttr);
     }
     copyVertexData(fnMesh, pointsAttr);
-    copyFaceConnectsAndPolyCounts(mesh, fnMesh);
-    copyInvisibleHoles(mesh, fnMesh);
-    copyUvSetData(mesh, fnMesh);
+
+    MeshExportData data;
+    data.gather(fnMesh, !params.m_useAnimalSchema);
+    data.convert();
+    data.commit(mesh);
 
     if(params.m_useAnimalSchema)
     {
@@ -1540,12 +1356,6 @@ UsdPrim MeshTranslator::exportObject(UsdStageRefPtr stage, MDagPath path, const
       copyAnimalCreaseEdges(mesh, fnMesh);
       copyGlimpseTesselationAttributes(mesh, fnMesh);
     }
-    else
-    {
-      copyColourSetData(mesh, fnMesh);
-      copyCreaseVertices(mesh, fnMesh);
-      copyCreaseEdges(mesh, fnMesh);
-    }
 
     // pick up any additional attributes attached to the mesh node (these will be added alongside the transform attributes)
     if(params.m_dynamicAttributes)
@@ -1557,6 +1367,61 @@ UsdPrim MeshTranslator::exportObject(UsdStageRefPtr stage, MDagPath path, const
   return mesh.GetPrim();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the MeshAnimDeformer re-opens the root layer of the stage from disk, so it only sees the same mesh if every
+///         opinion on the mesh and its ancestors (including variant selections) comes from a layer that has been saved.
+///         Opinions from the session layer or any other anonymous layer, or from layers with unsaved edits (e.g. made
+///         through the edit target), cannot be reproduced.
+static bool canReopenFromFile(const UsdPrim& meshPrim)
+{
+  for(UsdPrim prim = meshPrim; prim; prim = prim.GetParent())
+  {
+    for(const SdfPrimSpecHandle& spec : prim.GetPrimStack())
+    {
+      const SdfLayerHandle layer = spec->GetLayer();
+      if(layer->IsAnonymous() || layer->IsDirty())
+        return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+static void applyMeshAnimDeformer(const UsdGeomMesh& mesh, const MFnDagNode& fnShape)
+{
+  if(mesh.GetPointsAttr().GetNumTimeSamples() < 2)
+    return;
+
+  // an anonymous (in memory) stage cannot be re-opened by the deformer, so there is nothing to stream the points from
+  const std::string filePath = mesh.GetPrim().GetStage()->GetRootLayer()->GetRealPath();
+  if(filePath.empty())
+    return;
+
+  if(!canReopenFromFile(mesh.GetPrim()))
+  {
+    MGlobal::displayWarning(MString("MeshTranslator: not streaming the points of \"") + mesh.GetPath().GetText() +
+                            "\", as it has opinions in unsaved or anonymous layers that a MeshAnimDeformer cannot read");
+    return;
+  }
+
+  MStringArray result;
+  const MString command = MString("deformer -type ") + nodes::MeshAnimDeformer::kTypeName + " \"" + fnShape.fullPathName() + "\"";
+  if(!MGlobal::executeCommand(command, result) || !result.length())
+  {
+    MGlobal::displayWarning(MString("MeshTranslator: unable to create a MeshAnimDeformer for \"") + fnShape.fullPathName() + "\"");
+    return;
+  }
+
+  MSelectionList sl;
+  MObject deformer;
+  sl.add(result[0]);
+  sl.getDependNode(0, deformer);
+
+  MPlug(deformer, nodes::MeshAnimDeformer::filePath()).setString(filePath.c_str());
+  MPlug(deformer, nodes::MeshAnimDeformer::primPath()).setString(mesh.GetPath().GetText());
+  MGlobal::executeCommand(MString("connectAttr time1.outTime ") + result[0] + ".inTime");
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 MStatus MeshTranslator::registerType()
 {
@@ -1616,6 +1481,11 @@ MObject MeshTranslator::createNode(const UsdPrim& from, MObject parent, const ch
   applyAnimalColourSets(from, fnMesh, counts);
   applyPrimVars(mesh, fnMesh, counts, connects);
 
+  if(params.m_animations)
+  {
+    applyMeshAnimDeformer(mesh, fnDag);
+  }
+
   return polyShape;
 }
 
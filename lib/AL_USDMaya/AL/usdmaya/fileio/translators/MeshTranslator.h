@@ -59,6 +59,12 @@ public:
   /// \param time the timecode to use when setting the data
   static void copyVertexData(const MFnMesh& fnMesh, const UsdAttribute& pointsAttr, UsdTimeCode time = UsdTimeCode::Default());
 
+  /// \brief  reads the vertex data from the maya mesh without writing it to USD
+  /// \param fnMesh the maya mesh to read the data from
+  /// \param points the returned points
+  /// \return true if the vertices could be read
+  static bool getVertexData(const MFnMesh& fnMesh, VtArray<GfVec3f>& points);
+
   /// \brief  exports a mesh to the USD file and returns the created prim
   /// \param  stage  the stage in which to create the prim
   /// \param  mayaPath  the path to the maya curve to export
@@ -78,10 +84,34 @@ void zipUVs(const float* u, const float* v, float* uv, const size_t count);
 void unzipUVs(const float* const uv, float* const u, float* const v, const size_t count);
 void convert3DArrayTo4DArray(const float* const input, float* const output, size_t count);
 void convertFloatVec3ArrayToDoubleVec3Array(const float* const input, double* const output, size_t count);
+void convert3DFloatArrayTo4DDoubleArray(const float* const input, double* const output, size_t count);
 void interleaveIndexedUvData(float* output, const float* u, const float* v, const int32_t* indices, const uint32_t numIndices);
 bool isUvSetDataSparse(const int32_t* uvCounts, const uint32_t count);
 void generateIncrementingIndices(MIntArray& indices, const size_t count);
 
+/// \brief  expands the UV ids of a sparsely mapped UV set (as returned by MFnMesh::getAssignedUVs, where the faces
+///         without UVs have a UV count of zero) into one index per face-vertex, as required by a faceVarying primvar.
+///         The face-vertices of the unmapped faces are given unassignedIndex.
+/// \param  indices the returned face-vertex indices. Must be large enough to hold the sum of the polyCounts.
+/// \param  polyCounts the number of vertices in each face
+/// \param  uvCounts the number of UVs assigned to each face (either zero, or the number of vertices in the face)
+/// \param  uvIds the UV ids of the mapped faces
+/// \param  numFaces the number of faces
+/// \param  unassignedIndex the index given to the face-vertices of the unmapped faces
+void expandSparseUvIndices(int32_t* indices, const int32_t* polyCounts, const int32_t* uvCounts, const int32_t* uvIds,
+                           const uint32_t numFaces, const int32_t unassignedIndex);
+
+/// \brief  the inverse of expandSparseUvIndices. Any face that has a face-vertex with the unassignedIndex is treated as
+///         unmapped.
+/// \param  uvCounts on input, the number of vertices in each face. On output, the number of UVs assigned to each face.
+/// \param  uvIds the returned UV ids of the mapped faces. Must be as large as the face-vertex indices.
+/// \param  indices the face-vertex indices read from the primvar
+/// \param  numFaces the number of faces
+/// \param  unassignedIndex the index used for the face-vertices of the unmapped faces
+/// \return the number of UV ids written
+uint32_t compactSparseUvIndices(int32_t* uvCounts, int32_t* uvIds, const int32_t* indices, const uint32_t numFaces,
+                                const int32_t unassignedIndex);
+
 //----------------------------------------------------------------------------------------------------------------------
 } // translators
 } // fileio
@@ -15,16 +15,22 @@
 //
 #include "AL/usdmaya/fileio/ExportParams.h"
 #include "AL/usdmaya/fileio/ImportParams.h"
+#include "AL/usdmaya/fileio/translators/MeshTranslator.h"
 #include "AL/usdmaya/fileio/translators/NurbsCurveTranslator.h"
 
-#include "maya/MDoubleArray.h"
+#include "maya/MDagModifier.h"
 #include "maya/MDagPath.h"
+#include "maya/MDoubleArray.h"
+#include "maya/MFnDependencyNode.h"
 #include "maya/MFnNurbsCurve.h"
+#include "maya/MFnNurbsCurveData.h"
 #include "maya/MGlobal.h"
 #include "maya/MPointArray.h"
 
 #include "pxr/usd/usdGeom/nurbsCurves.h"
 
+#include <vector>
+
 namespace AL {
 namespace usdmaya {
 namespace fileio {
@@ -33,16 +39,6 @@ namespace translators {
 //----------------------------------------------------------------------------------------------------------------------
 void floatToDouble(double* output, const float* const input, size_t count);
 void doubleToFloat(float* output, const double* const input, size_t count);
-void convert3DFloatArrayTo4DDoubleArray(const float* const input, double* const output, size_t count)
-{
-  for(size_t i = 0, j = 0, n = count * 4; i != n; i += 4, j += 3)
-  {
-    output[i] = input[j];
-    output[i + 1] = input[j + 1];
-    output[i + 2] = input[j + 2];
-    output[i + 3] = 1.0;
-  }
-}
 
 //----------------------------------------------------------------------------------------------------------------------
 MStatus NurbsCurveTranslator::registerType()
@@ -82,34 +78,71 @@ MObject NurbsCurveTranslator::createNode(const UsdPrim& from, MObject parent, co
   if(dataCurveVertexCounts.size() == 0)
     return MObject::kNullObj;
 
-  MPointArray controlVertices;
-  MDoubleArray knotSequences;
+  // make sure the counts do not index beyond the end of the point, order, and knot arrays
+  const size_t ncurves = dataCurveVertexCounts.size();
+  if(dataOrders.size() < ncurves)
+    return MObject::kNullObj;
+  size_t totalPoints = 0;
+  size_t totalKnots = 0;
+  for(size_t i = 0; i < ncurves; ++i)
+  {
+    if(dataCurveVertexCounts[i] < 1 || dataOrders[i] < 2)
+      return MObject::kNullObj;
+    totalPoints += dataCurveVertexCounts[i];
+    totalKnots += dataCurveVertexCounts[i] + dataOrders[i] - 2;
+  }
+  if(totalPoints > dataPoints.size() || totalKnots > dataKnots.size())
+    return MObject::kNullObj;
 
-  size_t currentPointIndex = 0;
-  size_t currentKnotIndex = 0;
+  // convert the control vertices of all of the curves in a single pass
+  MPointArray allControlVertices;
+  allControlVertices.setLength(totalPoints);
+  convert3DFloatArrayTo4DDoubleArray((const float*)dataPoints.cdata(), &allControlVertices[0].x, totalPoints);
 
-  MFnNurbsCurve fnCurve;
+  if(ncurves == 1)
+  {
+    MDoubleArray knotSequences(dataKnots.cdata(), totalKnots);
+    MFnNurbsCurve fnCurve;
+    MObject object = fnCurve.create(allControlVertices, knotSequences, dataOrders[0] - 1, MFnNurbsCurve::kOpen, false, false, parent);
+    AL_MAYA_CHECK_ERROR_RETURN_NULL_MOBJECT(DagNodeTranslator::copyAttributes(from, object, params), "Failed to copy attributes");
+    return object;
+  }
 
-  for(size_t i = 0, ncurves = dataCurveVertexCounts.size(); i < ncurves; ++i)
+  // Groom and hair guide prims can contain tens of thousands of curves. Rather than adding each shape to the DAG in
+  // turn, all of the shapes are created by a single DAG modifier, and the curve data is then assigned to the cached
+  // geometry of each shape with a single DG modifier.
+  MDagModifier dagModifier;
+  std::vector<MObject> shapes(ncurves);
+  for(size_t i = 0; i < ncurves; ++i)
   {
-    const int32_t numPoints = dataCurveVertexCounts[i];
-    controlVertices.setLength(numPoints);
+    shapes[i] = dagModifier.createNode("nurbsCurve", parent);
+  }
+  AL_MAYA_CHECK_ERROR_RETURN_NULL_MOBJECT(dagModifier.doIt(), "NurbsCurveTranslator: failed to create the curve shapes");
 
+  MDGModifier dgModifier;
+  MFnNurbsCurve fnCurve;
+  MFnNurbsCurveData fnData;
+  const MPoint* const cvs = &allControlVertices[0];
+  const double* const knots = dataKnots.cdata();
+  size_t currentPointIndex = 0;
+  size_t currentKnotIndex = 0;
+  for(size_t i = 0; i < ncurves; ++i)
+  {
+    const int32_t numPoints = dataCurveVertexCounts[i];
     const int32_t numKnots = numPoints + dataOrders[i] - 2;
-    knotSequences.setLength(numKnots);
-
-    const float* pstart = (const float*)&dataPoints[currentPointIndex];
-    const double* kstart = &dataKnots[currentKnotIndex];
-    memcpy(&knotSequences[0], kstart, sizeof(double) * numKnots);
 
+    MPointArray controlVertices(cvs + currentPointIndex, numPoints);
+    MDoubleArray knotSequences(knots + currentKnotIndex, numKnots);
     currentPointIndex += numPoints;
     currentKnotIndex += numKnots;
 
-    convert3DFloatArrayTo4DDoubleArray(pstart, (double*)&controlVertices[0], numPoints);
-    fnCurve.create(controlVertices, knotSequences, dataOrders[i] - 1, MFnNurbsCurve::kOpen, false, false, parent);
+    MObject curveData = fnData.create();
+    fnCurve.create(controlVertices, knotSequences, dataOrders[i] - 1, MFnNurbsCurve::kOpen, false, false, curveData);
+    dgModifier.newPlugValue(MFnDependencyNode(shapes[i]).findPlug("cached"), curveData);
   }
+  AL_MAYA_CHECK_ERROR_RETURN_NULL_MOBJECT(dgModifier.doIt(), "NurbsCurveTranslator: failed to set the curve data");
 
-  MObject object = fnCurve.object();
+  MObject object = shapes.back();
   AL_MAYA_CHECK_ERROR_RETURN_NULL_MOBJECT(DagNodeTranslator::copyAttributes(from, object, params), "Failed to copy attributes");
 
   return object;
@@ -553,59 +553,74 @@ MStatus TransformTranslator::processMetaData(const UsdPrim& from, MObject& to, c
   return MS::kSuccess;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  describes how one of the transform attributes is exported as an xform op
+//----------------------------------------------------------------------------------------------------------------------
+struct TransformExportOp
+{
+  const MObject* attribute; ///< the maya attribute the op value is read from
+  TfToken name; ///< the xform op suffix
+  UsdGeomXformOp::Type type; ///< the op type. Rotations are remapped according to the rotate order of the node
+  float scale; ///< conversion factor applied to the maya value
+  GfVec3f defaultValue; ///< the op is only exported if the value differs from this, or the attribute is animated
+  int32_t source; ///< if not -1, the index of an earlier op whose value is negated (e.g. rotatePivotINV)
+};
+
+/// maps MEulerRotation::RotationOrder to the rotation op type
+const UsdGeomXformOp::Type g_rotateOpTypes[] = {
+  UsdGeomXformOp::TypeRotateXYZ,
+  UsdGeomXformOp::TypeRotateYZX,
+  UsdGeomXformOp::TypeRotateZXY,
+  UsdGeomXformOp::TypeRotateXZY,
+  UsdGeomXformOp::TypeRotateYXZ,
+  UsdGeomXformOp::TypeRotateZYX
+};
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 bool animationCheck(AnimationTranslator* animTranslator, MPlug plug)
 {
   if(!animTranslator) return false;
-  return animTranslator->isAnimated(plug, true);
+  return animTranslator->isPlugAnimated(plug, true);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 MStatus TransformTranslator::copyAttributes(const MObject& from, UsdPrim& to, const ExporterParams& params)
 {
-  static const UsdTimeCode usdTime = UsdTimeCode::EarliestTime();
+  // The op names, types and conversion factors are the same for every transform, so they are only computed once
+  // rather than for each exported node.
+  static const float radToDeg = 180.0f / 3.141592654f;
+  static const TransformExportOp exportOps[] = {
+    { &m_translation, TfToken("translate"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), -1 },
+    { &m_rotatePivotTranslate, TfToken("rotatePivotTranslate"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), -1 },
+    { &m_rotatePivot, TfToken("rotatePivot"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), -1 },
+    { &m_rotation, TfToken("rotate"), UsdGeomXformOp::TypeRotateXYZ, radToDeg, GfVec3f(0.0f), -1 },
+    { &m_rotateAxis, TfToken("rotateAxis"), UsdGeomXformOp::TypeRotateXYZ, radToDeg, GfVec3f(0.0f), -1 },
+    { &m_rotatePivot, TfToken("rotatePivotINV"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), 2 },
+    { &m_scalePivotTranslate, TfToken("scalePivotTranslate"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), -1 },
+    { &m_scalePivot, TfToken("scalePivot"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), -1 },
+    { &m_shear, TfToken("shear"), UsdGeomXformOp::TypeTransform, 1.0f, GfVec3f(0.0f), -1 },
+    { &m_scale, TfToken("scale"), UsdGeomXformOp::TypeScale, 1.0f, GfVec3f(1.0f), -1 },
+    { &m_scalePivot, TfToken("scalePivotINV"), UsdGeomXformOp::TypeTranslate, 1.0f, GfVec3f(0.0f), 7 }
+  };
+  static const size_t numExportOps = sizeof(exportOps) / sizeof(TransformExportOp);
+  static const int32_t rotateOp = 3;
+
   UsdGeomXform xformSchema(to);
-  GfVec3f scale;
-  GfVec3f shear;
-  GfVec3f rotation;
-  int32_t rotateOrder;
-  GfVec3f rotateAxis;
-  GfVec3f translation;
-  GfVec3f scalePivot;
-  GfVec3f rotatePivot;
-  GfVec3f scalePivotTranslate;
-  GfVec3f rotatePivotTranslate;
+  AnimationTranslator* animTranslator = params.m_animTranslator;
+
   bool inheritsTransform;
   bool visible;
-
+  int32_t rotateOrder;
   getBool(from, m_inheritsTransform, inheritsTransform);
   getBool(from, m_visible, visible);
-  getVec3(from, m_scale, (float*)&scale);
-  getVec3(from, m_shear, (float*)&shear);
-  getVec3(from, m_rotation, (float*)&rotation);
   getInt32(from, m_rotateOrder, rotateOrder);
-  getVec3(from, m_rotateAxis, (float*)&rotateAxis);
-  getVec3(from, m_translation, (float*)&translation);
-  getVec3(from, m_scalePivot, (float*)&scalePivot);
-  getVec3(from, m_rotatePivot, (float*)&rotatePivot);
-  getVec3(from, m_scalePivotTranslate, (float*)&scalePivotTranslate);
-  getVec3(from, m_rotatePivotTranslate, (float*)&rotatePivotTranslate);
-
-  static const GfVec3f defaultScale(1.0f);
-  static const GfVec3f defaultShear(0.0f);
-  static const GfVec3f defaultRotation(0.0f);
-  static const GfVec3f defaultRotateAxis(0.0f);
-  static const GfVec3f defaultTranslation(0.0f);
-  static const GfVec3f defaultScalePivot(0.0f);
-  static const GfVec3f defaultRotatePivot(0.0f);
-  static const GfVec3f defaultScalePivotTranslate(0.0f);
-  static const GfVec3f defaultRotatePivotTranslate(0.0f);
-  static const bool defaultVisible(true);
-
-  AnimationTranslator* animTranslator = params.m_animTranslator;
 
   xformSchema.SetResetXformStack(!inheritsTransform);
 
+  static const bool defaultVisible(true);
   if (visible != defaultVisible || animationCheck(animTranslator, MPlug(from, m_visible)))
   {
     UsdAttribute visibleAttr = xformSchema.GetVisibilityAttr();
@@ -613,146 +628,72 @@ MStatus TransformTranslator::copyAttributes(const MObject& from, UsdPrim& to, co
     if (animTranslator) animTranslator->addTransformPlug(MPlug(from, m_visible), visibleAttr, true);
   }
 
-  if(translation != defaultTranslation || animationCheck(animTranslator, MPlug(from, m_translation)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("translate"));
-    op.Set(translation);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_translation), op.GetAttr(), true);
-  }
-
-  if(rotatePivotTranslate != defaultRotatePivotTranslate || animationCheck(animTranslator, MPlug(from, m_rotatePivotTranslate)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotatePivotTranslate"));
-    op.Set(rotatePivotTranslate);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotatePivotTranslate), op.GetAttr(), true);
-  }
-
-  if(rotatePivot != defaultRotatePivot || animationCheck(animTranslator, MPlug(from, m_rotatePivot)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotatePivot"));
-    op.Set(rotatePivot);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotatePivot), op.GetAttr(), true);
-  }
-
-  if(rotation != defaultRotation || animationCheck(animTranslator, MPlug(from, m_rotation)))
+  GfVec3f values[numExportOps];
+  bool exported[numExportOps];
+  for(size_t i = 0; i < numExportOps; ++i)
   {
-    const float radToDeg = 180.0f / 3.141592654f;
-    rotation *= radToDeg;
-    switch(rotateOrder)
+    const TransformExportOp& exportOp = exportOps[i];
+    GfVec3f& value = values[i];
+    if(exportOp.source >= 0)
     {
-    case MEulerRotation::kXYZ:
-      {
-        UsdGeomXformOp op = xformSchema.AddRotateXYZOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotate"));
-        op.Set(rotation);
-        if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotation), op.GetAttr(), radToDeg, true);
-      }
-      break;
-
-    case MEulerRotation::kXZY:
-      {
-        UsdGeomXformOp op = xformSchema.AddRotateXZYOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotate"));
-        op.Set(rotation);
-        if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotation), op.GetAttr(), radToDeg, true);
-      }
-      break;
-
-    case MEulerRotation::kYXZ:
-      {
-        UsdGeomXformOp op = xformSchema.AddRotateYXZOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotate"));
-        op.Set(rotation);
-        if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotation), op.GetAttr(), radToDeg, true);
-      }
-      break;
-
-    case MEulerRotation::kYZX:
-      {
-        UsdGeomXformOp op = xformSchema.AddRotateYZXOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotate"));
-        op.Set(rotation);
-        if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotation), op.GetAttr(), radToDeg, true);
-      }
-      break;
-
-    case MEulerRotation::kZXY:
+      // the inverse pivots share the value and animation state of the pivot they undo
+      value = -values[exportOp.source];
+      exported[i] = exported[exportOp.source];
+    }
+    else
+    {
+      getVec3(from, *exportOp.attribute, (float*)&value);
+      if(exportOp.type == UsdGeomXformOp::TypeTransform)
       {
-        UsdGeomXformOp op = xformSchema.AddRotateZXYOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotate"));
-        op.Set(rotation);
-        if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotation), op.GetAttr(), radToDeg, true);
+        // animated shear is not currently exported
+        exported[i] = value != exportOp.defaultValue;
       }
-      break;
-
-    case MEulerRotation::kZYX:
+      else
       {
-        UsdGeomXformOp op = xformSchema.AddRotateZYXOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotate"));
-        op.Set(rotation);
-        if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotation), op.GetAttr(), radToDeg, true);
+        exported[i] = value != exportOp.defaultValue || animationCheck(animTranslator, MPlug(from, *exportOp.attribute));
       }
-      break;
-
-    default:
-      break;
     }
-  }
-
-  if(rotateAxis != defaultRotateAxis || animationCheck(animTranslator, MPlug(from, m_rotateAxis)))
-  {
-    const float radToDeg = 57.295779506f;
-    rotateAxis *= radToDeg;
-    UsdGeomXformOp op = xformSchema.AddRotateXYZOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotateAxis"));
-    op.Set(rotateAxis);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotateAxis), op.GetAttr(), radToDeg, true);
-  }
-
-  if(rotatePivot != defaultRotatePivot || animationCheck(animTranslator, MPlug(from, m_rotatePivot)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("rotatePivotINV"));
-    op.Set(-rotatePivot);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_rotatePivot), op.GetAttr(), true);
-  }
-
-  if(scalePivotTranslate != defaultScalePivotTranslate || animationCheck(animTranslator, MPlug(from, m_scalePivotTranslate)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("scalePivotTranslate"));
-    op.Set(scalePivotTranslate);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_scalePivotTranslate), op.GetAttr(), true);
-  }
-
-  if(scalePivot != defaultScalePivot || animationCheck(animTranslator, MPlug(from, m_scalePivot)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("scalePivot"));
-    op.Set(scalePivot);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_scalePivot), op.GetAttr(), true);
-  }
+    if(!exported[i])
+      continue;
 
-  if(shear != defaultShear)
-  {
-    GfMatrix4d shearMatrix(
-        1.0f, 0.0f, 0.0f, 0.0f,
-        shear[0], 1.0f, 0.0f, 0.0f,
-        shear[1], shear[2], 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f);
-    UsdGeomXformOp op = xformSchema.AddTransformOp(UsdGeomXformOp::PrecisionDouble, TfToken("shear"));
-    op.Set(shearMatrix);
-  }
+    UsdGeomXformOp::Type opType = exportOp.type;
+    if(i == rotateOp)
+    {
+      if(rotateOrder < 0 || rotateOrder >= int32_t(sizeof(g_rotateOpTypes) / sizeof(UsdGeomXformOp::Type)))
+        continue;
+      opType = g_rotateOpTypes[rotateOrder];
+    }
 
-  if(scale != defaultScale || animationCheck(animTranslator, MPlug(from, m_scale)))
-  {
-    UsdGeomXformOp op = xformSchema.AddScaleOp(UsdGeomXformOp::PrecisionFloat, TfToken("scale"));
-    op.Set(scale);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_scale), op.GetAttr(), true);
-  }
+    if(opType == UsdGeomXformOp::TypeTransform)
+    {
+      GfMatrix4d shearMatrix(
+          1.0f, 0.0f, 0.0f, 0.0f,
+          value[0], 1.0f, 0.0f, 0.0f,
+          value[1], value[2], 1.0f, 0.0f,
+          0.0f, 0.0f, 0.0f, 1.0f);
+      UsdGeomXformOp op = xformSchema.AddXformOp(opType, UsdGeomXformOp::PrecisionDouble, exportOp.name);
+      op.Set(shearMatrix);
+      continue;
+    }
 
-  if(scalePivot != defaultScalePivot || animationCheck(animTranslator, MPlug(from, m_scalePivot)))
-  {
-    UsdGeomXformOp op = xformSchema.AddTranslateOp(UsdGeomXformOp::PrecisionFloat, TfToken("scalePivotINV"));
-    op.Set(-scalePivot);
-    if(animTranslator) animTranslator->addPlug(MPlug(from, m_scalePivot), op.GetAttr(), true);
+    UsdGeomXformOp op = xformSchema.AddXformOp(opType, UsdGeomXformOp::PrecisionFloat, exportOp.name);
+    if(exportOp.scale != 1.0f)
+    {
+      op.Set(value * exportOp.scale);
+      if(animTranslator) animTranslator->addPlug(MPlug(from, *exportOp.attribute), op.GetAttr(), exportOp.scale, true);
+    }
+    else
+    {
+      op.Set(value);
+      if(animTranslator) animTranslator->addPlug(MPlug(from, *exportOp.attribute), op.GetAttr(), true);
+    }
   }
 
   return MS::kSuccess;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void TransformTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+bool TransformTranslator::getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& sample)
 {
   MObject node = plug.node();
   MObject attribute = plug.attribute();
@@ -761,8 +702,18 @@ void TransformTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& us
   {
     bool value;
     getBool(node, attribute, value);
-    usdAttr.Set(value ? UsdGeomTokens->inherited : UsdGeomTokens->invisible);
+    sample = value ? UsdGeomTokens->inherited : UsdGeomTokens->invisible;
+    return true;
   }
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void TransformTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+{
+  VtValue sample;
+  if(getAttributeValue(plug, usdAttr, sample))
+    usdAttr.Set(sample, timeCode);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
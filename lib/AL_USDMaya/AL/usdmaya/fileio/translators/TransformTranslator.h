@@ -69,6 +69,13 @@ public:
   /// \param  timeCode the timecode to use when setting the data
   static void copyAttributeValue(const MPlug& attr, UsdAttribute& usdAttr, const UsdTimeCode& timeCode);
 
+  /// \brief  read the current value of the transform plug specified, converted to the type of the usdAttr.
+  /// \param  attr the attribute to be read
+  /// \param  usdAttr the attribute that determines the type of the returned value
+  /// \param  sample the returned value
+  /// \return true if the plug is one handled by the transform translator, and a value was returned
+  static bool getAttributeValue(const MPlug& attr, const UsdAttribute& usdAttr, VtValue& sample);
+
   /// \brief  retrieve the corresponding maya attribute for the transform operation.
   /// \param  operation the transform operation we want the maya attribute handle for
   /// \param  attribute the returned attribute handle
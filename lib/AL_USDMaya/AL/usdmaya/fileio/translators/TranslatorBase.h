@@ -25,6 +25,7 @@
 
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 #include "AL/usdmaya/fileio/translators/TranslatorContext.h"
 
 namespace AL {
@@ -104,6 +105,27 @@ public:
   virtual MStatus import(const UsdPrim& prim, MObject& parent)
     { return MS::kSuccess; }
 
+  /// \brief  override this method and return true if the translator can import many prims in a single pass via
+  ///         importBatch. When true, the post load process collects the prims of this type and imports them after the
+  ///         prims that follow them in the traversal, but before any of their descendants.
+  /// \return true if your plugin supports batched import, false otherwise.
+  virtual bool supportsBatchImport() const
+    { return false; }
+
+  /// \brief  Override this method to import many prims of the translated type in a single pass (e.g. to amortise
+  ///         the cost of MEL round trips or DAG modifications). The default implementation calls import on each prim.
+  /// \param  prims the usd prims to be imported into maya
+  /// \param  parents the AL_usd_Transform node for each prim in prims
+  /// \param  results returns the import status of each prim in prims
+  virtual void importBatch(const std::vector<UsdPrim>& prims, std::vector<MObject>& parents, std::vector<MStatus>& results)
+  {
+    results.resize(prims.size());
+    for(size_t i = 0, n = prims.size(); i < n; ++i)
+    {
+      results[i] = import(prims[i], parents[i]);
+    }
+  }
+
   /// \brief  If your node needs to set up any relationships after import (for example, adding the node to a set, or
   ///         making attribute connections), then all of that work should be performed here.
   /// \param  prim the prim we are importing.
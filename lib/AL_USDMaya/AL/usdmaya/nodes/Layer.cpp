@@ -89,6 +89,7 @@ void Layer::init(ProxyShape* shape, SdfLayerRefPtr handle)
   Trace("Layer::init " << handle->GetIdentifier());
   m_shape = shape;
   m_handle = handle;
+  invalidateLayerGraph();
 
   // If this layer is the current edit target, flag this as true, so that we know to serialize the layer on file save
   if(shape->getUsdStage()->GetEditTarget().GetLayer() == handle)
@@ -121,78 +122,49 @@ void Layer::postConstructor()
 std::vector<Layer*> Layer::getChildLayers()
 {
   Trace("Layer::getChildLayers");
-  MPlug plug(thisMObject(), m_childLayers);
-  std::vector<Layer*> layers;
-
-  // As of Maya 2017, there looks to be a bug in the API where if you save a file containing a message array attribute
-  // that has attribute connections, upon reloading the file, MPlug::numElements() will always return 0.
-  // Strangely though, querying the connections via MEL will work.
-#if 0
-  MFnDependencyNode fn;
-  for(uint32_t i = 0, num = plug.numElements(); i < num; ++i)
+  if(m_shape)
   {
-    MPlugArray plugs;
-    MStatus status;
-    if(plug.elementByLogicalIndex(i).connectedTo(plugs, true, true, &status) && status)
+    const std::vector<Layer*>* layers = m_shape->cachedChildLayers(this);
+    if(layers)
     {
-      if(plugs.length())
-      {
-        if(plugs[0].node().apiType() == MFn::kPluginDependNode)
-        {
-          if(fn.setObject(plugs[0].node()))
-          {
-            if(fn.typeId() == Layer::kTypeId)
-            {
-              layers.push_back((Layer*)fn.userNode());
-            }
-            else
-            {
-              MGlobal::displayError(MString("Invalid connection found on attribute") + plug.elementByLogicalIndex(i).name());
-            }
-          }
-          else
-          {
-            MGlobal::displayError(MString("Invalid connection found on attribute") + plug.elementByLogicalIndex(i).name());
-          }
-        }
-        else
-        {
-          MGlobal::displayError(MString("Invalid connection found on attribute") + plug.elementByLogicalIndex(i).name());
-        }
-      }
+      return *layers;
     }
   }
-#else
-
-  MStringArray result;
-  MGlobal::executeCommand(MString("listConnections -s 1 -d 1 \"") + plug.name() + "\"", result);
-
-  MSelectionList sl;
-  for(int i = 0; i < result.length(); ++i)
-  {
-    sl.add(result[i]);
-  }
+  return queryChildLayers();
+}
 
-  for(int i = 0; i < sl.length(); ++i)
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<Layer*> Layer::getSubLayers()
+{
+  Trace("Layer::getSubLayers");
+  if(m_shape)
   {
-    MObject object;
-    sl.getDependNode(i, object);
-    MFnDependencyNode fn(object);
-    if(fn.typeId() == Layer::kTypeId)
+    const std::vector<Layer*>* layers = m_shape->cachedSubLayers(this);
+    if(layers)
     {
-      layers.push_back((Layer*)fn.userNode());
+      return *layers;
     }
   }
+  return querySubLayers();
+}
 
-#endif
-  return layers;
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<Layer*> Layer::queryChildLayers()
+{
+  return queryConnectedLayers(m_childLayers);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-std::vector<Layer*> Layer::getSubLayers()
+std::vector<Layer*> Layer::querySubLayers()
 {
-  Trace("Layer::getSubLayers");
-  MPlug plug(thisMObject(), m_subLayers);
+  return queryConnectedLayers(m_subLayers);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<Layer*> Layer::queryConnectedLayers(const MObject& attribute)
+{
+  Trace("Layer::queryConnectedLayers");
+  MPlug plug(thisMObject(), attribute);
   std::vector<Layer*> layers;
 
   // As of Maya 2017, there looks to be a bug in the API where if you save a file containing a message array attribute
@@ -772,6 +744,48 @@ bool Layer::setInternalValueInContext(const MPlug& plug, const MDataHandle& data
   return true;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+MStatus Layer::connectionMade(const MPlug& plug, const MPlug& otherPlug, bool asSrc)
+{
+  invalidateLayerGraph(otherPlug.node());
+  return MPxNode::connectionMade(plug, otherPlug, asSrc);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus Layer::connectionBroken(const MPlug& plug, const MPlug& otherPlug, bool asSrc)
+{
+  invalidateLayerGraph(otherPlug.node());
+  return MPxNode::connectionBroken(plug, otherPlug, asSrc);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Layer::invalidateLayerGraph(const MObject& otherNode)
+{
+  if(m_shape)
+  {
+    m_shape->invalidateLayerGraph();
+  }
+
+  // a layer node that has not been initialised yet may be connected to a layer of a proxy shape (or to the proxy
+  // shape itself), in which case it is the graph of that proxy shape that changes.
+  if(!otherNode.isNull())
+  {
+    MFnDependencyNode fn(otherNode);
+    if(fn.typeId() == ProxyShape::kTypeId)
+    {
+      ProxyShape* shape = (ProxyShape*)fn.userNode();
+      if(shape != m_shape)
+        shape->invalidateLayerGraph();
+    }
+    else if(fn.typeId() == Layer::kTypeId)
+    {
+      ProxyShape* shape = ((Layer*)fn.userNode())->getProxyShape();
+      if(shape && shape != m_shape)
+        shape->invalidateLayerGraph();
+    }
+  }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 bool Layer::hasBeenTheEditTarget() const
 {
@@ -791,6 +805,7 @@ void Layer::setLayerAndClearAttribute(SdfLayerHandle handle)
 {
   Trace("Layer::setLayerAndClearAttribute");
   m_handle = handle;
+  invalidateLayerGraph();
   if(m_handle)
   {
     Trace(" - handle valid");
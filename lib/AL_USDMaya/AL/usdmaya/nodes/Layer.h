@@ -64,12 +64,20 @@ public:
   /// Methods to work with sublayers
   //--------------------------------------------------------------------------------------------------------------------
 
-  /// \brief  returns an array of all the sub layers connected to this layer
+  /// \brief  returns an array of all the sub layers connected to this layer. If this layer is part of a proxy shape's
+  ///         layer graph, the cached result from the proxy shape is returned.
   std::vector<Layer*> getSubLayers();
 
-  /// \brief  returns an array of all the child layers connected to this layer (assets essentially)
+  /// \brief  returns an array of all the child layers connected to this layer (assets essentially). If this layer is
+  ///         part of a proxy shape's layer graph, the cached result from the proxy shape is returned.
   std::vector<Layer*> getChildLayers();
 
+  /// \brief  returns an array of all the sub layers connected to this layer, by querying the connections in Maya.
+  std::vector<Layer*> querySubLayers();
+
+  /// \brief  returns an array of all the child layers connected to this layer, by querying the connections in Maya.
+  std::vector<Layer*> queryChildLayers();
+
   /// \brief  constructs the sub layers after a proxy shape has loaded.
   /// \param  pmodifier pointer to a modifier that will record the nodes added (primarily if you need to keep hold of
   ///         information for undo later). doIt() will NOT have been called prior to the function returning.
@@ -177,10 +185,17 @@ public:
 
   // ----------------  API FOR UNIT TESTING ONLY -------------------------
   inline void testing_clearHandle()
-    { m_handle = SdfLayerRefPtr(); }
+    { m_handle = SdfLayerRefPtr(); invalidateLayerGraph(); }
   // ---------------------------------------------------------------------
 
 private:
+  std::vector<Layer*> queryConnectedLayers(const MObject& attribute);
+
+  /// \brief  flags the layer graph of the proxy shape this layer belongs to as out of date, along with the graph of
+  ///         the proxy shape that owns the node on the other end of a connection (if any).
+  /// \param  otherNode the layer node or proxy shape node on the other end of a changed connection
+  void invalidateLayerGraph(const MObject& otherNode = MObject::kNullObj);
+
   SdfLayerRefPtr m_handle; ///< reference to the USD layer
   ProxyShape* m_shape; ///< reference to the proxy shape
 
@@ -191,6 +206,8 @@ private:
   void postConstructor() override;
   bool getInternalValueInContext(const MPlug& plug, MDataHandle& dataHandle, MDGContext& ctx) override;
   bool setInternalValueInContext(const MPlug& plug, const MDataHandle& dataHandle, MDGContext& ctx) override;
+  MStatus connectionMade(const MPlug& plug, const MPlug& otherPlug, bool asSrc) override;
+  MStatus connectionBroken(const MPlug& plug, const MPlug& otherPlug, bool asSrc) override;
 
 
   /// \var    static MObject comment();
@@ -0,0 +1,323 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/TypeIDs.h"
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
+#include "AL/usdmaya/nodes/MeshAnimDeformer.h"
+
+#include "maya/MArrayDataHandle.h"
+#include "maya/MDataBlock.h"
+#include "maya/MFloatPointArray.h"
+#include "maya/MFnMesh.h"
+#include "maya/MGlobal.h"
+#include "maya/MItGeometry.h"
+#include "maya/MPoint.h"
+#include "maya/MTime.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+// printf debugging
+#if 0 || AL_ENABLE_TRACE
+# define Trace(X) std::cerr << X << std::endl;
+#else
+# define Trace(X)
+#endif
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshPointCache::setMesh(const UsdGeomMesh& mesh)
+{
+  clear();
+  m_mesh = mesh;
+  m_animated = false;
+  if(m_mesh)
+  {
+    std::vector<double> times;
+    if(m_mesh.GetPointsAttr().GetTimeSamples(&times) && times.size() > 1)
+    {
+      m_firstSample = times.front();
+      m_lastSample = times.back();
+      m_animated = true;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool MeshPointCache::fetch(UsdTimeCode time, VtArray<GfVec3f>& points)
+{
+  // no prefetches may be in flight whilst frames are evicted
+  m_dispatcher.Wait();
+
+  // if the points are not animated, a single frame (stored at the default time) is all that is needed
+  const UsdTimeCode timeCode = m_animated ? time : UsdTimeCode::Default();
+  const double key = timeCode.GetValue();
+
+  auto it = m_frames.find(key);
+  if(it != m_frames.end())
+  {
+    points = it->second;
+  }
+  else
+  {
+    if(!m_mesh || !m_mesh.GetPointsAttr().Get(&points, timeCode))
+    {
+      return false;
+    }
+    m_frames.emplace(key, points);
+  }
+  evict(key);
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshPointCache::evict(const double time)
+{
+  while(m_frames.size() > m_capacity)
+  {
+    // the frames are ordered by time, so the furthest frame from the current time is at one end or the other
+    auto first = m_frames.begin();
+    auto last = std::prev(m_frames.end());
+    if(std::abs(first->first - time) > std::abs(last->first - time))
+      m_frames.erase(first);
+    else
+      m_frames.erase(last);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshPointCache::prefetch(const std::vector<double>& times)
+{
+  if(!m_animated)
+    return;
+
+  for(const double time : times)
+  {
+    if(time < m_firstSample || time > m_lastSample || contains(time))
+      continue;
+
+    // the dispatcher is waited on before the cache is modified on the calling thread, so capturing 'this' is safe
+    m_dispatcher.Run([this, time]()
+    {
+      VtArray<GfVec3f> points;
+      if(m_mesh.GetPointsAttr().Get(&points, UsdTimeCode(time)))
+      {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_frames.emplace(time, std::move(points));
+      }
+    });
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshPointCache::clear()
+{
+  m_dispatcher.Wait();
+  m_frames.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t MeshPointCache::size() const
+{
+  std::lock_guard<std::mutex> lock(m_lock);
+  return m_frames.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool MeshPointCache::contains(const double time) const
+{
+  std::lock_guard<std::mutex> lock(m_lock);
+  return m_frames.find(time) != m_frames.end();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+AL_MAYA_DEFINE_NODE(MeshAnimDeformer, AL_USDMAYA_MESHANIMDEFORMER, AL_usdmaya);
+
+//----------------------------------------------------------------------------------------------------------------------
+MObject MeshAnimDeformer::m_filePath = MObject::kNullObj;
+MObject MeshAnimDeformer::m_primPath = MObject::kNullObj;
+MObject MeshAnimDeformer::m_inTime = MObject::kNullObj;
+MObject MeshAnimDeformer::m_prefetchFrames = MObject::kNullObj;
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus MeshAnimDeformer::initialise()
+{
+  Trace("MeshAnimDeformer::initialise");
+  const char* const errorString = "MeshAnimDeformer::initialise";
+  try
+  {
+    setNodeType(kTypeName);
+
+    addFrame("USD Mesh Information");
+    m_filePath = addFilePathAttr("filePath", "fp", kCached | kReadable | kWritable | kStorable | kConnectable, kLoad, "USD Files (*.usd*) (*.usd*)");
+    m_primPath = addStringAttr("primPath", "pp", kCached | kReadable | kWritable | kStorable | kConnectable, true);
+
+    addFrame("USD Timing Information");
+    m_inTime = addTimeAttr("inTime", "it", MTime(0.0), kCached | kConnectable | kReadable | kWritable | kStorable);
+    m_prefetchFrames = addInt32Attr("prefetchFrames", "pf", 2, kCached | kReadable | kWritable | kStorable);
+
+    AL_MAYA_CHECK_ERROR(attributeAffects(m_filePath, outputGeom), errorString);
+    AL_MAYA_CHECK_ERROR(attributeAffects(m_primPath, outputGeom), errorString);
+    AL_MAYA_CHECK_ERROR(attributeAffects(m_inTime, outputGeom), errorString);
+  }
+  catch(const MStatus& status)
+  {
+    return status;
+  }
+
+  generateAETemplate();
+
+  return MS::kSuccess;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimDeformer::updateMesh(const MString& filePath, const MString& primPath)
+{
+  if(filePath == m_cachedFilePath && primPath == m_cachedPrimPath)
+    return;
+
+  Trace("MeshAnimDeformer::updateMesh " << filePath << " " << primPath);
+  m_cachedFilePath = filePath;
+  m_cachedPrimPath = primPath;
+
+  // waits for any prefetches reading from the previous stage to complete
+  m_cache.setMesh(UsdGeomMesh());
+  m_stage = UsdStageRefPtr();
+
+  if(!filePath.length() || !primPath.length())
+    return;
+
+  // a private stage is opened (outside of the StageCache), so that loading the payload containing the mesh does not
+  // change the stages of any proxy shapes, and they in turn cannot change the stage being read by the prefetches
+  m_stage = UsdStage::Open(filePath.asChar(), UsdStage::LoadNone);
+  if(!m_stage)
+  {
+    MGlobal::displayWarning(MString("MeshAnimDeformer: failed to open usd file \"") + filePath + "\"");
+    return;
+  }
+
+  const SdfPath path(primPath.asChar());
+  UsdPrim prim = m_stage->GetPrimAtPath(path);
+  if(!prim)
+  {
+    // the mesh lies within (possibly nested) payloads, so load the closest ancestor that currently exists, which
+    // loads every payload beneath it
+    SdfPath ancestor = path.GetParentPath();
+    while(!ancestor.IsEmpty() && !m_stage->GetPrimAtPath(ancestor))
+    {
+      ancestor = ancestor.GetParentPath();
+    }
+    if(!ancestor.IsEmpty())
+    {
+      m_stage->Load(ancestor);
+      prim = m_stage->GetPrimAtPath(path);
+    }
+  }
+
+  UsdGeomMesh mesh(prim);
+  if(!mesh)
+  {
+    MGlobal::displayWarning(MString("MeshAnimDeformer: \"") + primPath + "\" is not a valid mesh in \"" + filePath + "\"");
+    return;
+  }
+  m_cache.setMesh(mesh);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool MeshAnimDeformer::hasPaintedWeights(MDataBlock& dataBlock, unsigned int multiIndex)
+{
+  MStatus status;
+  MArrayDataHandle weightLists = dataBlock.inputArrayValue(weightList, &status);
+  if(!status || !weightLists.jumpToElement(multiIndex))
+    return false;
+  MArrayDataHandle weightsHandle = weightLists.inputValue().child(weights);
+  return weightsHandle.elementCount() != 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus MeshAnimDeformer::deform(MDataBlock& dataBlock, MItGeometry& iter, const MMatrix&, unsigned int multiIndex)
+{
+  Trace("MeshAnimDeformer::deform");
+  const float envelopeValue = inputFloatValue(dataBlock, envelope);
+  if(envelopeValue <= 0.0f)
+    return MS::kSuccess;
+
+  updateMesh(inputStringValue(dataBlock, m_filePath), inputStringValue(dataBlock, m_primPath));
+  if(!m_cache.mesh())
+    return MS::kSuccess;
+
+  const double time = inputTimeValue(dataBlock, m_inTime).as(MTime::uiUnit());
+  const int32_t prefetchFrames = std::max(inputInt32Value(dataBlock, m_prefetchFrames), 0);
+  m_cache.setCapacity(2 * prefetchFrames + 1);
+
+  VtArray<GfVec3f> points;
+  if(m_cache.fetch(UsdTimeCode(time), points) && points.size() == size_t(iter.count()))
+  {
+    MArrayDataHandle outputArray = dataBlock.outputArrayValue(outputGeom);
+    outputArray.jumpToElement(multiIndex);
+    MObject outputMesh = outputArray.outputValue().asMesh();
+
+    if(envelopeValue >= 1.0f && !outputMesh.isNull() && !hasPaintedWeights(dataBlock, multiIndex))
+    {
+      // the common case: the USD points replace the vertices wholesale
+      MFloatPointArray mayaPoints;
+      mayaPoints.setLength(points.size());
+      fileio::translators::activeMeshKernels().convert3DArrayTo4DArray(
+          (const float*)points.cdata(), &mayaPoints[0].x, points.size());
+      MFnMesh fnMesh(outputMesh);
+      fnMesh.setPoints(mayaPoints, MSpace::kObject);
+    }
+    else
+    {
+      const GfVec3f* const usdPoints = points.cdata();
+      for(iter.reset(); !iter.isDone(); iter.next())
+      {
+        const int index = iter.index();
+        const float weight = envelopeValue * weightValue(dataBlock, multiIndex, index);
+        if(weight == 0.0f)
+          continue;
+        const GfVec3f& p = usdPoints[index];
+        MPoint position = iter.position();
+        position += double(weight) * (MPoint(p[0], p[1], p[2]) - position);
+        iter.setPosition(position);
+      }
+    }
+  }
+
+  // read ahead in the direction of playback
+  if(prefetchFrames)
+  {
+    const double step = (time < m_lastTime) ? -1.0 : 1.0;
+    std::vector<double> times(prefetchFrames);
+    for(int32_t i = 0; i < prefetchFrames; ++i)
+    {
+      times[i] = time + step * (i + 1);
+    }
+    m_cache.prefetch(times);
+  }
+  m_lastTime = time;
+
+  return MS::kSuccess;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+#include "AL/usdmaya/Common.h"
+#include "AL/maya/NodeHelper.h"
+
+#include "maya/MPxDeformerNode.h"
+
+#include "pxr/pxr.h"
+#include "pxr/base/work/dispatcher.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/mesh.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A small cache of the points of a UsdGeomMesh, keyed by time code. Frames that are expected to be requested
+///         next can be read ahead of time on worker threads, so that during playback the points for the current frame
+///         are (usually) already in memory by the time they are needed.
+/// \ingroup nodes
+//----------------------------------------------------------------------------------------------------------------------
+class MeshPointCache
+{
+public:
+
+  /// \brief  ctor
+  MeshPointCache() = default;
+
+  /// \brief  dtor. Waits for any outstanding prefetches to complete.
+  ~MeshPointCache()
+    { m_dispatcher.Wait(); }
+
+  /// \brief  sets the mesh the points are read from. Any cached frames are discarded.
+  /// \param  mesh the mesh to read the points from
+  void setMesh(const UsdGeomMesh& mesh);
+
+  /// \brief  returns the mesh the points are read from
+  /// \return the mesh
+  const UsdGeomMesh& mesh() const
+    { return m_mesh; }
+
+  /// \brief  sets the number of frames retained in the cache. Frames furthest from the most recently fetched time
+  ///         are discarded first.
+  /// \param  capacity the maximum number of frames to retain
+  void setCapacity(size_t capacity)
+    { m_capacity = capacity ? capacity : 1; }
+
+  /// \brief  returns the points at the specified time, reading them from the mesh if they are not cached.
+  /// \param  time the time code to retrieve
+  /// \param  points the returned points. This shares its storage with the cached copy, so no data is copied.
+  /// \return true if the points could be read
+  bool fetch(UsdTimeCode time, VtArray<GfVec3f>& points);
+
+  /// \brief  reads the points for the specified time codes on worker threads. Times that are already cached, or lie
+  ///         outside of the range of authored time samples, are ignored. If the points are not animated, this does
+  ///         nothing.
+  /// \param  times the time codes to read ahead of time
+  void prefetch(const std::vector<double>& times);
+
+  /// \brief  waits for outstanding prefetches to complete, and then discards all cached frames
+  void clear();
+
+  /// \brief  returns the number of frames currently cached
+  /// \return the number of cached frames
+  size_t size() const;
+
+  /// \brief  returns true if the specified time is in the cache
+  /// \param  time the time code to test
+  /// \return true if cached
+  bool contains(double time) const;
+
+private:
+  void evict(double time);
+  UsdGeomMesh m_mesh;
+  std::map<double, VtArray<GfVec3f> > m_frames;
+  mutable std::mutex m_lock; ///< guards m_frames while prefetches are in flight
+  WorkDispatcher m_dispatcher;
+  size_t m_capacity = 5;
+  double m_firstSample = 0;
+  double m_lastSample = 0;
+  bool m_animated = false;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A deformer that streams the points of an animated UsdGeomMesh onto a Maya mesh. This allows meshes with
+///         time sampled points (e.g. simulation caches) to be imported into Maya as regular geometry, without having
+///         to bake the animation into Maya, or having to keep the mesh within a proxy shape.
+///
+///         The deformer has the following inputs:
+///          \li \b filePath - the USD file containing the mesh. The deformer opens its own stage (rather than sharing
+///              one via the StageCache) with only the payloads containing the mesh loaded, so that loading the mesh
+///              does not change what the proxy shapes display, and so that the load set of the stage being read by
+///              the prefetch threads is never changed by anything else.
+///          \li \b primPath - the path to the UsdGeomMesh within the stage, e.g. "/root/sim/clothShape"
+///          \li \b inTime - the time to sample the points at. Typically connected from time1.outTime
+///          \li \b prefetchFrames - the number of frames, in the direction of playback, that are read ahead of time
+///              on worker threads. Set to zero to disable prefetching.
+///
+///         If the number of points on the USD mesh at the current time does not match the number of vertices of the
+///         Maya geometry, the geometry is left undeformed. The envelope and any painted weights blend between the
+///         incoming geometry and the USD points.
+/// \ingroup nodes
+//----------------------------------------------------------------------------------------------------------------------
+class MeshAnimDeformer
+  : public MPxDeformerNode,
+    public maya::NodeHelper
+{
+public:
+
+  /// \brief  ctor
+  inline MeshAnimDeformer()
+    : MPxDeformerNode(), NodeHelper() {}
+
+  //--------------------------------------------------------------------------------------------------------------------
+  // Type Info & Registration
+  //--------------------------------------------------------------------------------------------------------------------
+  AL_MAYA_DECLARE_NODE();
+
+  //--------------------------------------------------------------------------------------------------------------------
+  // Input Attributes
+  //--------------------------------------------------------------------------------------------------------------------
+  AL_DECL_ATTRIBUTE(filePath);
+  AL_DECL_ATTRIBUTE(primPath);
+  AL_DECL_ATTRIBUTE(inTime);
+  AL_DECL_ATTRIBUTE(prefetchFrames);
+
+  //--------------------------------------------------------------------------------------------------------------------
+  /// \name Methods
+  //--------------------------------------------------------------------------------------------------------------------
+
+  /// \brief  returns the cache of points read from the USD mesh
+  /// \return the point cache
+  const MeshPointCache& pointCache() const
+    { return m_cache; }
+
+private:
+
+  //--------------------------------------------------------------------------------------------------------------------
+  /// virtual overrides
+  //--------------------------------------------------------------------------------------------------------------------
+
+  MStatus deform(MDataBlock& dataBlock, MItGeometry& iter, const MMatrix& localToWorld, unsigned int multiIndex) override;
+
+private:
+  void updateMesh(const MString& filePath, const MString& primPath);
+  bool hasPaintedWeights(MDataBlock& dataBlock, unsigned int multiIndex);
+
+  // the stage is declared before the cache, so that the cache (which waits for the prefetches reading the stage) is
+  // destroyed first
+  UsdStageRefPtr m_stage;
+  MeshPointCache m_cache;
+  MString m_cachedFilePath;
+  MString m_cachedPrimPath;
+  double m_lastTime = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -23,9 +23,16 @@
 #include "maya/MFnDagNode.h"
 #include "maya/MBoundingBox.h"
 #include "maya/MDrawContext.h"
+#include "maya/MMatrix.h"
 #include "maya/MPoint.h"
+#include "maya/MNodeMessage.h"
+#include "maya/MObjectHandle.h"
+#include "maya/MViewport2Renderer.h"
 #include "maya/M3dView.h"
 
+#include <utility>
+#include <vector>
+
 // printf debugging
 #if 0 || AL_ENABLE_TRACE
 # define Trace(X) std::cerr << X << std::endl;
@@ -38,7 +45,8 @@ namespace usdmaya {
 namespace nodes {
 namespace {
 //----------------------------------------------------------------------------------------------------------------------
-/// \brief  user data struct - holds the info needed to render the scene
+/// \brief  user data struct - holds the info needed to render the scene. The data is retained between frames (Maya
+///         hands it back to prepareForDraw as the old data), so it is not deleted after use.
 //----------------------------------------------------------------------------------------------------------------------
 class RenderUserData
   : public MUserData
@@ -47,7 +55,7 @@ public:
 
   // Constructor to use when shape is drawn but no bounding box.
   RenderUserData()
-    : MUserData(true)
+    : MUserData(false)
     {}
 
   // Make sure everything gets freed!
@@ -56,11 +64,331 @@ public:
 
   UsdImagingGLEngine::RenderParams m_params;
   UsdPrim m_rootPrim;
-  UsdImagingGLHdEngine* m_engine = 0;
   ProxyShape* m_shape = 0;
+
+  /// the engine is shared by every instance of the shape, so the camera and root transform are applied in draw
+  GfMatrix4d m_viewMatrix;
+  GfMatrix4d m_projectionMatrix;
+  GfMatrix4d m_rootTransform;
+  GfVec4d m_viewport;
+
+  /// the light generation and material that were last passed to SetLightingState
+  mutable uint64_t m_lightingGeneration = 0;
+  mutable GlfSimpleMaterial m_material;
 };
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Caches the lights extracted from the draw context. The lights are the same for every proxy shape drawn in a
+///         frame, and walking the light parameters is comparatively expensive, so they are only rebuilt when something
+///         that affects them has changed. MDrawContext does not expose a light-change counter, so one is maintained
+///         here by a node dirty callback on each light that has been seen. This is combined with a signature of the
+///         per-light information from the draw context, which catches lights being added or removed, and camera-space
+///         lights following the camera. The signature also includes the shadow matrix (which for a directional light
+///         is fitted to the view, so changes without the light changing) and the world matrix of each light (which
+///         changes without dirtying the light when a parent transform is moved).
+///
+///         Building the signature still walks every light, so it is only done by the first proxy shape drawn in each
+///         render of a viewport (as signalled by a begin render notification). The other proxy shapes drawn in the same
+///         render reuse the generation.
+//----------------------------------------------------------------------------------------------------------------------
+class LightingCache
+{
+public:
+
+  /// \brief  rebuilds the lights if they have changed since the last call
+  /// \param  context the current draw context
+  /// \param  filter the light filter to apply
+  /// \return the generation of the lights, which changes each time the lights are rebuilt
+  uint64_t update(const MHWRender::MDrawContext& context, MHWRender::MDrawContext::LightFilter filter);
+
+  /// \brief  returns the lights built by the last call to update
+  const GlfSimpleLightVector& lights() const
+    { return m_lights; }
+
+  /// \brief  removes the dirty callbacks from all of the lights being tracked, and the begin render notification
+  void removeCallbacks();
+
+private:
+  struct LightInfo
+  {
+    MFloatPointArray positions;
+    MFloatVector direction;
+    float intensity;
+    MColor color;
+    bool hasDirection;
+    bool hasPosition;
+  };
+  void buildLight(const MHWRender::MDrawContext& context, MHWRender::MDrawContext::LightFilter filter, uint32_t index);
+  void trackLight(const MDagPath& lightPath);
+  void appendToSignature(const MMatrix& matrix)
+  {
+    for(uint32_t i = 0; i < 4; ++i)
+      for(uint32_t j = 0; j < 4; ++j)
+        m_newSignature.push_back(float(matrix.matrix[i][j]));
+  }
+  static void onLightDirty(MObject& node, void* clientData)
+    { ++static_cast<LightingCache*>(clientData)->m_changeCount; }
+  static void onBeginRender(MHWRender::MDrawContext& context, void* clientData)
+    { ++static_cast<LightingCache*>(clientData)->m_render; }
+
+  GlfSimpleLightVector m_lights;
+  std::vector<LightInfo> m_info;
+  std::vector<float> m_signature;
+  std::vector<float> m_newSignature;
+  std::vector<std::pair<MObjectHandle, MCallbackId> > m_callbacks;
+  uint64_t m_changeCount = 0;
+  uint64_t m_builtAtChange = 0;
+  uint64_t m_generation = 0;
+  uint64_t m_render = 0;
+  uint64_t m_updatedInRender = 0;
+  bool m_hasRenderNotification = false;
+};
+
+const MString kBeginRenderNotification("AL_usdmaya_LightingCache");
+
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t LightingCache::update(const MHWRender::MDrawContext& context, MHWRender::MDrawContext::LightFilter filter)
+{
+  if(!m_hasRenderNotification)
+  {
+    MHWRender::MRenderer* renderer = MHWRender::MRenderer::theRenderer();
+    m_hasRenderNotification = renderer && renderer->addNotification(onBeginRender, kBeginRenderNotification,
+                                                                    MHWRender::MPassContext::kBeginRenderSemantic, this);
+  }
+
+  // the lights have already been checked by a proxy shape drawn earlier in this render
+  if(m_hasRenderNotification && m_generation && m_updatedInRender == m_render)
+  {
+    return m_generation;
+  }
+  m_updatedInRender = m_render;
+
+  const uint32_t numLights = context.numberOfActiveLights(filter);
+  m_info.resize(numLights);
+  m_newSignature.clear();
+  for(uint32_t i = 0; i < numLights; ++i)
+  {
+    LightInfo& info = m_info[i];
+    info.positions.clear();
+    context.getLightInformation(i, info.positions, info.direction, info.intensity, info.color, info.hasDirection, info.hasPosition, filter);
+
+    m_newSignature.push_back(float(info.positions.length()));
+    for(uint32_t j = 0, n = info.positions.length(); j < n; ++j)
+    {
+      m_newSignature.insert(m_newSignature.end(), { info.positions[j].x, info.positions[j].y, info.positions[j].z, info.positions[j].w });
+    }
+    m_newSignature.insert(m_newSignature.end(), {
+        info.direction.x, info.direction.y, info.direction.z, info.intensity,
+        info.color.r, info.color.g, info.color.b, info.color.a,
+        float(info.hasDirection), float(info.hasPosition) });
+
+    MHWRender::MLightParameterInformation* lightParam = context.getLightParameterInformation(i, filter);
+    if(lightParam)
+    {
+      MMatrix shadowMatrix;
+      if(lightParam->getParameter(MHWRender::MLightParameterInformation::kShadowViewProj, shadowMatrix))
+      {
+        appendToSignature(shadowMatrix);
+      }
+      MStatus status;
+      MDagPath lightPath = lightParam->lightPath(&status);
+      if(status)
+      {
+        appendToSignature(lightPath.inclusiveMatrix());
+      }
+    }
+  }
+
+  if(m_generation && m_changeCount == m_builtAtChange && m_newSignature == m_signature)
+  {
+    return m_generation;
+  }
+
+  Trace("LightingCache::update rebuilding " << numLights << " lights");
+  m_signature.swap(m_newSignature);
+  m_builtAtChange = m_changeCount;
+
+  // stop tracking any lights that have since been deleted
+  for(auto it = m_callbacks.begin(); it != m_callbacks.end(); )
+  {
+    if(!it->first.isValid())
+    {
+      MMessage::removeCallback(it->second);
+      it = m_callbacks.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  m_lights.clear();
+  m_lights.reserve(numLights);
+  for(uint32_t i = 0; i < numLights; ++i)
+  {
+    buildLight(context, filter, i);
+  }
+  return ++m_generation;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void LightingCache::buildLight(const MHWRender::MDrawContext& context, MHWRender::MDrawContext::LightFilter filter, uint32_t index)
+{
+  const LightInfo& info = m_info[index];
+  GlfSimpleLight light;
+  if(info.hasPosition)
+  {
+    const MFloatPointArray& positions = info.positions;
+    if(positions.length() == 1)
+    {
+      GfVec4f pos(positions[0].x, positions[0].y, positions[0].z, positions[0].w);
+      light.SetPosition(pos);
+    }
+    else
+    {
+      MFloatPoint fp(0,0,0);
+      for(int j = 0; j < positions.length(); ++j)
+      {
+        fp += positions[j];
+      }
+      float value = (1.0f / positions.length());
+      fp.x*=value;fp.y*=value;fp.z*=value;
+      light.SetPosition(GfVec4f(fp.x, fp.y, fp.z, 1.0f));
+    }
+  }
+  if(info.hasDirection)
+  {
+    GfVec3f dir(info.direction.x, info.direction.y, info.direction.z);
+    light.SetSpotDirection(dir);
+  }
+
+  MHWRender::MLightParameterInformation* lightParam = context.getLightParameterInformation(index, filter);
+  if(!lightParam)
+  {
+    return;
+  }
+
+  // only the parameters that are passed through to the GlfSimpleLight are queried
+  MStringArray paramNames;
+  lightParam->parameterList(paramNames);
+  for(uint32_t i = 0, n = paramNames.length(); i != n; ++i)
+  {
+    auto semantic = lightParam->parameterSemantic(paramNames[i]);
+    switch(semantic)
+    {
+    case MHWRender::MLightParameterInformation::kColor:
+      {
+        MFloatArray fa;
+        lightParam->getParameter(paramNames[i], fa);
+        if(fa.length() == 3)
+        {
+          GfVec4f c(info.intensity * fa[0], info.intensity * fa[1], info.intensity * fa[2], 1.0f);
+          light.SetDiffuse(c);
+          light.SetSpecular(c);
+        }
+      }
+      break;
+    case MHWRender::MLightParameterInformation::kCosConeAngle:
+      {
+        MFloatArray fa;
+        lightParam->getParameter(paramNames[i], fa);
+        light.SetSpotCutoff(fa[0]);
+        light.SetSpotFalloff(fa[1]);
+      }
+      break;
+    case MHWRender::MLightParameterInformation::kShadowMapSize:
+    case MHWRender::MLightParameterInformation::kShadowViewProj:
+      {
+        MMatrix value;
+        lightParam->getParameter(paramNames[i], value);
+        GfMatrix4d m(value.matrix);
+        light.SetShadowMatrix(m);
+      }
+      break;
+    case MHWRender::MLightParameterInformation::kGlobalShadowOn:
+    case MHWRender::MLightParameterInformation::kShadowOn:
+      {
+        MIntArray ia;
+        lightParam->getParameter(paramNames[i], ia);
+        if(ia.length())
+          light.SetHasShadow(ia[0]);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  MStatus status;
+  MDagPath lightPath = lightParam->lightPath(&status);
+  if(status)
+  {
+    MMatrix wsm = lightPath.inclusiveMatrix();
+    light.SetIsCameraSpaceLight(false);
+    GfMatrix4d tm(wsm.inverse().matrix);
+    light.SetTransform(tm);
+    trackLight(lightPath);
+  }
+  else
+  {
+    light.SetIsCameraSpaceLight(true);
+  }
+  m_lights.push_back(light);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void LightingCache::trackLight(const MDagPath& lightPath)
+{
+  MObject node = lightPath.node();
+  for(auto& tracked : m_callbacks)
+  {
+    if(tracked.first == node)
+      return;
+  }
+  MStatus status;
+  MCallbackId id = MNodeMessage::addNodeDirtyCallback(node, onLightDirty, this, &status);
+  if(status)
+  {
+    m_callbacks.emplace_back(MObjectHandle(node), id);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void LightingCache::removeCallbacks()
+{
+  for(auto& tracked : m_callbacks)
+  {
+    MMessage::removeCallback(tracked.second);
+  }
+  m_callbacks.clear();
+
+  if(m_hasRenderNotification)
+  {
+    MHWRender::MRenderer* renderer = MHWRender::MRenderer::theRenderer();
+    if(renderer)
+    {
+      renderer->removeNotification(kBeginRenderNotification, MHWRender::MPassContext::kBeginRenderSemantic);
+    }
+    m_hasRenderNotification = false;
+  }
+
+  // without the callbacks, the cached lights can no longer be trusted
+  ++m_changeCount;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool sameMaterial(const GlfSimpleMaterial& a, const GlfSimpleMaterial& b)
+{
+  return a.GetAmbient() == b.GetAmbient() &&
+         a.GetDiffuse() == b.GetDiffuse() &&
+         a.GetSpecular() == b.GetSpecular() &&
+         a.GetEmission() == b.GetEmission() &&
+         a.GetShininess() == b.GetShininess();
+}
+
+LightingCache g_lightingCache;
+} // anon
+
 //----------------------------------------------------------------------------------------------------------------------
 MString ProxyDrawOverride::kDrawDbClassification("drawdb/geometry/AL_usdmaya");
 MString ProxyDrawOverride::kDrawRegistrantId("pxrUsd");
@@ -117,22 +445,35 @@ MUserData* ProxyDrawOverride::prepareForDraw(
   Trace("ProxyDrawOverride::prepareForDraw");
   MFnDagNode fn(objPath);
 
-  RenderUserData* data = new RenderUserData;
+  // reuse the data from the previous draw of this object where possible
+  RenderUserData* data = dynamic_cast<RenderUserData*>(userData);
+  if(!data)
+  {
+    data = new RenderUserData;
+  }
 
+  // until the shape has been successfully prepared, there is nothing to draw
+  data->m_rootPrim = UsdPrim();
   data->m_shape = (ProxyShape*)fn.userNode();
+  ProxyShape* shape = data->m_shape;
+  if(!shape)
+  {
+    return data;
+  }
 
-  auto engine = data->m_shape->engine();
+  auto engine = shape->engine();
   if(!engine)
   {
-    data->m_shape->constructGLImagingEngine();
-    engine = data->m_shape->engine();
+    shape->constructGLImagingEngine();
+    engine = shape->engine();
     if(!engine)
       return data;
   }
 
-  if(!data->m_shape || !data->m_shape->getRenderAttris(&data->m_params, frameContext, objPath))
+  data->m_params = UsdImagingGLEngine::RenderParams();
+  if(!shape->getRenderAttris(&data->m_params, frameContext, objPath))
   {
-    return NULL;
+    return data;
   }
 
   MMatrix viewproj = frameContext.getMatrix(MHWRender::MFrameContext::kViewProjMtx);
@@ -146,17 +487,17 @@ MUserData* ProxyDrawOverride::prepareForDraw(
   GfMatrix4d mm;
   glGetDoublev(GL_PROJECTION_MATRIX, (double*)&mm);
 
-  engine->SetCameraState(
-      GfMatrix4d(frameContext.getMatrix(MHWRender::MFrameContext::kViewMtx).matrix),
-      mm,
-      GfVec4d(originX, originY, width, height));
+  data->m_viewMatrix = GfMatrix4d(frameContext.getMatrix(MHWRender::MFrameContext::kViewMtx).matrix);
+  data->m_projectionMatrix = mm;
+  data->m_viewport = GfVec4d(originX, originY, width, height);
+  data->m_rootTransform = GfMatrix4d(objPath.inclusiveMatrix().matrix);
 
-  engine->SetRootTransform(GfMatrix4d(objPath.inclusiveMatrix().matrix));
+  // payloads are streamed by distance from the camera, so moving the camera may need another round of streaming
+  shape->checkStreamingCamera(frameContext.getCurrentCameraPath());
 
   data->m_params.showGuides = data->m_shape->displayGuidesPlug().asBool();
   data->m_params.showRender = data->m_shape->displayRenderGuidesPlug().asBool();
   data->m_rootPrim = data->m_shape->getRootPrim();
-  data->m_engine = engine;
 
   return data;
 }
@@ -169,7 +510,9 @@ void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUser
   glGetFloatv(GL_COLOR_CLEAR_VALUE, clearCol);
 
   const RenderUserData* ptr = (const RenderUserData*)data;
-  if(ptr && ptr->m_rootPrim)
+
+  UsdImagingGLHdEngine* engine = (ptr && ptr->m_rootPrim) ? ptr->m_shape->engine() : 0;
+  if(engine)
   {
     MHWRender::MStateManager* stateManager = context.getStateManager();
     MHWRender::MDepthStencilStateDesc depthDesc;
@@ -183,157 +526,7 @@ void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUser
 
     MHWRender::MDrawContext::LightFilter considerAllSceneLights = MHWRender::MDrawContext::kFilteredToLightLimit;
 
-    uint32_t numLights = context.numberOfActiveLights(considerAllSceneLights);
-
-    GlfSimpleLightVector lights;
-    lights.reserve(numLights);
-    for(uint32_t i = 0; i < numLights; ++i)
-    {
-      MFloatPointArray positions;
-      MFloatVector direction;
-      float intensity;
-      MColor color;
-      bool hasDirection;
-      bool hasPosition;
-      context.getLightInformation(i, positions, direction, intensity, color, hasDirection, hasPosition, considerAllSceneLights);
-      GlfSimpleLight light;
-      if(hasPosition)
-      {
-        if(positions.length() == 1)
-        {
-          GfVec4f pos(positions[0].x, positions[0].y, positions[0].z, positions[0].w);
-          light.SetPosition(pos);
-        }
-        else
-        {
-          MFloatPoint fp(0,0,0);
-          for(int j = 0; j < positions.length(); ++j)
-          {
-            fp += positions[j];
-          }
-          float value = (1.0f / positions.length());
-          fp.x*=value;fp.y*=value;fp.z*=value;
-          light.SetPosition(GfVec4f(fp.x, fp.y, fp.z, 1.0f));
-        }
-      }
-      if(hasDirection)
-      {
-        GfVec3f dir(direction.x, direction.y, direction.z);
-        light.SetSpotDirection(dir);
-      }
-
-      MHWRender::MLightParameterInformation* lightParam = context.getLightParameterInformation(i, considerAllSceneLights);
-      if(lightParam)
-      {
-        MStringArray paramNames;
-        lightParam->parameterList(paramNames);
-        for(uint32_t i = 0, n = paramNames.length(); i != n; ++i)
-        {
-          auto semantic = lightParam->parameterSemantic(paramNames[i]);
-          switch(semantic)
-          {
-          case MHWRender::MLightParameterInformation::kIntensity:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-            }
-            break;
-
-          case MHWRender::MLightParameterInformation::kColor:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-              if(fa.length() == 3)
-              {
-                GfVec4f c(intensity * fa[0], intensity * fa[1], intensity * fa[2], 1.0f);
-                light.SetDiffuse(c);
-                light.SetSpecular(c);
-              }
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kEmitsDiffuse:
-          case MHWRender::MLightParameterInformation::kEmitsSpecular:
-            {
-              MIntArray ia;
-              lightParam->getParameter(paramNames[i], ia);
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kDecayRate:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kDropoff:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kCosConeAngle:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-              light.SetSpotCutoff(fa[0]);
-              light.SetSpotFalloff(fa[1]);
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kStartShadowParameters:
-          case MHWRender::MLightParameterInformation::kShadowBias:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kShadowMapSize:
-          case MHWRender::MLightParameterInformation::kShadowViewProj:
-            {
-              MMatrix value;
-              lightParam->getParameter(paramNames[i], value);
-              GfMatrix4d m(value.matrix);
-              light.SetShadowMatrix(m);
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kShadowColor:
-            {
-              MFloatArray fa;
-              lightParam->getParameter(paramNames[i], fa);
-              if(fa.length() == 3)
-              {
-                GfVec4f c(fa[0], fa[1], fa[2], 1.0f);
-              }
-            }
-            break;
-          case MHWRender::MLightParameterInformation::kGlobalShadowOn:
-          case MHWRender::MLightParameterInformation::kShadowOn:
-            {
-              MIntArray ia;
-              lightParam->getParameter(paramNames[i], ia);
-              if(ia.length())
-                light.SetHasShadow(ia[0]);
-            }
-            break;
-          default:
-            break;
-          }
-        }
-
-        MStatus status;
-        MDagPath lightPath = lightParam->lightPath(&status);
-        if(status)
-        {
-          MMatrix wsm = lightPath.inclusiveMatrix();
-          light.SetIsCameraSpaceLight(false);
-          GfMatrix4d tm(wsm.inverse().matrix);
-          light.SetTransform(tm);
-        }
-        else
-        {
-          light.SetIsCameraSpaceLight(true);
-        }
-        lights.push_back(light);
-      }
-    }
+    const uint64_t lightingGeneration = g_lightingCache.update(context, considerAllSceneLights);
 
     auto getColour = [] (const MPlug& p) {
       GfVec4f col(0, 0, 0, 1.0f);
@@ -357,11 +550,22 @@ void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUser
     GLint uboBinding = -1;
     glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, 4, &uboBinding);
 
-    ptr->m_engine->SetLightingState(lights, material, GfVec4f(0.05f));
-    glDepthFunc(GL_LESS);
-    ptr->m_engine->Render(ptr->m_rootPrim, ptr->m_params);
+    engine->SetCameraState(ptr->m_viewMatrix, ptr->m_projectionMatrix, ptr->m_viewport);
+    engine->SetRootTransform(ptr->m_rootTransform);
 
-    auto view = M3dView::active3dView();
+    // the engine retains its lighting state between draws, so it only needs updating when the lights or material change,
+    // or when the engine is new (or the VP1 draw has applied its own lighting to it)
+    const bool engineClaimed = ptr->m_shape->claimEngineLighting(&g_lightingCache);
+    if(engineClaimed ||
+       ptr->m_lightingGeneration != lightingGeneration ||
+       !sameMaterial(ptr->m_material, material))
+    {
+      engine->SetLightingState(g_lightingCache.lights(), material, GfVec4f(0.05f));
+      ptr->m_lightingGeneration = lightingGeneration;
+      ptr->m_material = material;
+    }
+
+    // the selection is set before rendering, so that the highlighting is not that of the previous draw
     const SdfPathVector& paths1 = ptr->m_shape->selectedPaths();
     const SdfPathVector& paths2 = ptr->m_shape->selectionList().paths();
     SdfPathVector combined;
@@ -369,8 +573,11 @@ void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUser
     combined.insert(combined.end(), paths1.begin(), paths1.end());
     combined.insert(combined.end(), paths2.begin(), paths2.end());
 
-    ptr->m_engine->SetSelected(combined);
-    ptr->m_engine->SetSelectionColor(GfVec4f(1.0f, 2.0f/3.0f, 0.0f, 1.0f));
+    engine->SetSelected(combined);
+    engine->SetSelectionColor(GfVec4f(1.0f, 2.0f/3.0f, 0.0f, 1.0f));
+
+    glDepthFunc(GL_LESS);
+    engine->Render(ptr->m_rootPrim, ptr->m_params);
 
     if(combined.size())
     {
@@ -379,7 +586,7 @@ void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUser
       MColor colour = M3dView::leadColor();
       params.wireframeColor = GfVec4f(colour.r, colour.g, colour.b, 1.0f);
       glDepthFunc(GL_LEQUAL);
-      ptr->m_engine->RenderBatch(combined, params);
+      engine->RenderBatch(combined, params);
     }
 
     // HACK (michaelq): Maya doesn't restore this ONE buffer binding after our override is done so we have to do it for them.
@@ -391,6 +598,12 @@ void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUser
   glClearColor(clearCol[0], clearCol[1], clearCol[2], clearCol[3]);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyDrawOverride::removeCallbacks()
+{
+  g_lightingCache.removeCallbacks();
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 ProxyShape* ProxyDrawOverride::getShape(const MDagPath& objPath)
 {
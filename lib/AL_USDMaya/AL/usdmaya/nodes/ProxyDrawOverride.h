@@ -97,6 +97,9 @@ public:
   /// \return returns a pointer to the proxy shape node at the path (or null if not found)
   static ProxyShape* getShape(const MDagPath& objPath);
 
+  /// \brief  removes the callbacks used to track changes to the scene lights. Called when the plugin is unloaded.
+  static void removeCallbacks();
+
   /// \brief  We support the legacy and VP2 core profile rendering.
   /// \return MHWRender::kOpenGL | MHWRender::kOpenGLCoreProfile
   MHWRender::DrawAPI supportedDrawAPIs() const override
@@ -35,6 +35,7 @@
 #include "AL/usdmaya/nodes/Transform.h"
 #include "AL/usdmaya/nodes/TransformationMatrix.h"
 
+#include "maya/M3dView.h"
 #include "maya/MFileIO.h"
 #include "maya/MFnPluginData.h"
 #include "maya/MHWGeometryUtilities.h"
@@ -45,6 +46,9 @@
 #include "pxr/base/tf/fileUtils.h"
 #include "pxr/usd/ar/resolver.h"
 #include "pxr/usd/usd/stageCacheContext.h"
+#include "pxr/usd/usdGeom/xformCache.h"
+
+#include <functional>
 
 // printf debugging
 #if 0 || AL_ENABLE_TRACE
@@ -87,6 +91,8 @@ static void beforeSaveScene(void* clientData)
 
   if(stage)
   {
+    proxyShape->writeMayaPathsToSessionLayer();
+
     std::string serializeSessionLayerStr;
     stage->GetSessionLayer()->ExportToString(&serializeSessionLayerStr);
 
@@ -132,6 +138,10 @@ MObject ProxyShape::m_serializedSessionLayer = MObject::kNullObj;
 MObject ProxyShape::m_serializedArCtx = MObject::kNullObj;
 MObject ProxyShape::m_serializedTrCtx = MObject::kNullObj;
 MObject ProxyShape::m_unloaded = MObject::kNullObj;
+MObject ProxyShape::m_streamPayloads = MObject::kNullObj;
+MObject ProxyShape::m_streamingBudget = MObject::kNullObj;
+MObject ProxyShape::m_streamingPriorityPaths = MObject::kNullObj;
+MObject ProxyShape::m_streamingCameraDistance = MObject::kNullObj;
 MObject ProxyShape::m_drivenPrimPaths = MObject::kNullObj;
 MObject ProxyShape::m_drivenTranslate = MObject::kNullObj;
 MObject ProxyShape::m_drivenScale = MObject::kNullObj;
@@ -185,6 +195,75 @@ Layer* ProxyShape::getLayer()
   return 0;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::updateLayerGraph()
+{
+  if(m_layerGraph.m_generation == m_layerGraphGeneration)
+  {
+    return;
+  }
+  Trace("ProxyShape::updateLayerGraph");
+
+  m_layerGraph.m_layers.clear();
+  m_layerGraph.m_subLayers.clear();
+  m_layerGraph.m_childLayers.clear();
+
+  // walk the layers in the same order as Layer::findLayer, so that the first node found for a handle is the same
+  std::function<void(Layer*)> visit = [this, &visit](Layer* layer)
+  {
+    if(m_layerGraph.m_subLayers.count(layer))
+      return;
+
+    std::vector<Layer*>& subLayers = m_layerGraph.m_subLayers[layer];
+    subLayers = layer->querySubLayers();
+    std::vector<Layer*>& childLayers = m_layerGraph.m_childLayers[layer];
+    childLayers = layer->queryChildLayers();
+
+    SdfLayerHandle handle = layer->getHandle();
+    if(handle)
+    {
+      m_layerGraph.m_layers.emplace(handle, layer);
+    }
+
+    // (references to the elements of an unordered_map remain valid as the map grows)
+    for(Layer* subLayer : subLayers)
+    {
+      if(subLayer)
+        visit(subLayer);
+    }
+    for(Layer* childLayer : childLayers)
+    {
+      if(childLayer)
+        visit(childLayer);
+    }
+  };
+
+  Layer* root = getLayer();
+  if(root)
+  {
+    visit(root);
+  }
+
+  // querying the connections does not modify them, so the graph is valid for the current generation
+  m_layerGraph.m_generation = m_layerGraphGeneration;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<Layer*>* ProxyShape::cachedSubLayers(const Layer* layer)
+{
+  updateLayerGraph();
+  auto it = m_layerGraph.m_subLayers.find(layer);
+  return it != m_layerGraph.m_subLayers.end() ? &it->second : nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<Layer*>* ProxyShape::cachedChildLayers(const Layer* layer)
+{
+  updateLayerGraph();
+  auto it = m_layerGraph.m_childLayers.find(layer);
+  return it != m_layerGraph.m_childLayers.end() ? &it->second : nullptr;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 Layer* ProxyShape::findLayer(SdfLayerHandle handle)
 {
@@ -192,13 +271,13 @@ Layer* ProxyShape::findLayer(SdfLayerHandle handle)
   if(handle)
   {
     Trace("ProxyShape::findLayer: " << handle->GetIdentifier());
-    Layer* layer = getLayer();
-    if(layer)
+    updateLayerGraph();
+    auto it = m_layerGraph.m_layers.find(handle);
+    if(it != m_layerGraph.m_layers.end())
     {
-      return layer->findLayer(handle);
+      return it->second;
     }
   }
-  // we shouldn't really be able to get here!
   return 0;
 }
 
@@ -238,13 +317,9 @@ UsdPrim ProxyShape::getUsdPrim(MDataBlock& dataBlock) const
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-SdfPathVector ProxyShape::getExcludePrimPaths() const
+static SdfPathVector parsePathList(const MString& paths)
 {
-  Trace("ProxyShape::getExcludePrimPaths");
-
   SdfPathVector result;
-
-  MString paths = excludePrimPathsPlug().asString();
   if(paths.length())
   {
     const char* begin = paths.asChar();
@@ -261,6 +336,13 @@ SdfPathVector ProxyShape::getExcludePrimPaths() const
   return result;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+SdfPathVector ProxyShape::getExcludePrimPaths() const
+{
+  Trace("ProxyShape::getExcludePrimPaths");
+  return parsePathList(excludePrimPathsPlug().asString());
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 void ProxyShape::constructGLImagingEngine()
 {
@@ -275,6 +357,7 @@ void ProxyShape::constructGLImagingEngine()
         m_engine->InvalidateBuffers();
         delete m_engine;
       }
+      m_engineLightingUser = 0;
 
       // combine the excluded paths
       SdfPathVector excludedGeometryPaths;
@@ -288,7 +371,6 @@ void ProxyShape::constructGLImagingEngine()
   }
 }
 
-
 //----------------------------------------------------------------------------------------------------------------------
 MStatus ProxyShape::setDependentsDirty(const MPlug& plugBeingDirtied, MPlugArray& plugs)
 {
@@ -471,6 +553,12 @@ MStatus ProxyShape::initialise()
     m_unloaded = addBoolAttr("unloaded", "ul", false, kCached | kKeyable | kWritable | kAffectsAppearance | kStorable);
     m_serializedTrCtx = addStringAttr("serializedTrCtx", "srtc", kReadable|kWritable|kStorable|kHidden);
 
+    addFrame("USD Payload Streaming");
+    m_streamPayloads = addBoolAttr("streamPayloads", "spl", false, kCached | kReadable | kWritable | kStorable);
+    m_streamingBudget = addInt32Attr("streamingBudget", "stb", 0, kCached | kReadable | kWritable | kStorable);
+    m_streamingPriorityPaths = addStringAttr("streamingPriorityPaths", "stpp", kCached | kReadable | kWritable | kStorable);
+    m_streamingCameraDistance = addDoubleAttr("streamingCameraDistance", "stcd", 10.0, kCached | kReadable | kWritable | kStorable);
+
     addFrame("USD Timing Information");
     m_time = addTimeAttr("time", "tm", MTime(0.0), kCached | kConnectable | kReadable | kWritable | kStorable | kAffectsAppearance);
     m_timeOffset = addTimeAttr("timeOffset", "tmo", MTime(0.0), kCached | kConnectable | kReadable | kWritable | kStorable | kAffectsAppearance);
@@ -737,6 +825,7 @@ void ProxyShape::reloadStage(MPlug& plug)
 
   maya::Profiler::clearAll();
   AL_BEGIN_PROFILE_SECTION(ReloadStage);
+  AL_PROFILE_SECTION_ARGUMENT(proxyShape, MFnDependencyNode(thisMObject()).name().asChar());
   MDataBlock dataBlock = forceCache();
   m_stage = UsdStageRefPtr();
 
@@ -795,6 +884,9 @@ void ProxyShape::reloadStage(MPlug& plug)
       AL_END_PROFILE_SECTION();
 
       AL_BEGIN_PROFILE_SECTION(OpenRootLayer);
+      AL_PROFILE_SECTION_ARGUMENT(file, fileString);
+        // do not reuse a layer retained from a previous scene if its file has since been modified
+        StageCache::refreshLayerCache();
         SdfLayerRefPtr rootLayer = SdfLayer::FindOrOpen(fileString);
       AL_END_PROFILE_SECTION();
 
@@ -803,7 +895,8 @@ void ProxyShape::reloadStage(MPlug& plug)
         AL_BEGIN_PROFILE_SECTION(UsdStageOpen);
         UsdStageCacheContext ctx(StageCache::Get());
 
-        bool unloadedFlag = inputBoolValue(dataBlock, m_unloaded);
+        // when streaming, the payloads are loaded (within the budget) once the stage has been opened
+        bool unloadedFlag = inputBoolValue(dataBlock, m_unloaded) || inputBoolValue(dataBlock, m_streamPayloads);
         UsdStage::InitialLoadSet loadOperation = unloadedFlag ? UsdStage::LoadNone : UsdStage::LoadAll;
 
         if (sessionLayer)
@@ -855,6 +948,12 @@ void ProxyShape::reloadStage(MPlug& plug)
     m_path = rootPath;
   }
 
+  m_payloadStreamer.setStage(m_stage);
+  if(m_stage && inputBoolValue(dataBlock, m_streamPayloads))
+  {
+    queuePayloadStreaming();
+  }
+
   if(m_stage && !MFileIO::isOpeningFile())
   {
     AL_BEGIN_PROFILE_SECTION(PostLoadProcess);
@@ -929,7 +1028,153 @@ void ProxyShape::onAttributeChanged(MNodeMessage::AttributeMessage msg, MPlug& p
         proxy->constructExcludedPrims();
       }
     }
+    else
+    if(plug == m_streamPayloads || plug == m_streamingBudget || plug == m_streamingPriorityPaths)
+    {
+      if(proxy->m_stage && proxy->streamPayloadsPlug().asBool())
+      {
+        proxy->queuePayloadStreaming();
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::queuePayloadStreaming()
+{
+  if(m_payloadStreamingQueued)
+    return;
+  m_payloadStreamingQueued = true;
+  const MString uuid = MFnDependencyNode(thisMObject()).uuid().asString();
+  MGlobal::executeCommandOnIdle(MString("AL_usdmaya_ProxyShapeStreamPayloads -uuid \"") + uuid + "\"");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ProxyShape::activeCameraPosition(GfVec3d& position)
+{
+  // the position of the camera of the active view, in the space of the stage
+  MDagPath shapePath, cameraPath;
+  if(MGlobal::mayaState() == MGlobal::kInteractive &&
+     MDagPath::getAPathTo(thisMObject(), shapePath) &&
+     M3dView::active3dView().getCamera(cameraPath))
+  {
+    const MMatrix cameraToStage = cameraPath.inclusiveMatrix() * shapePath.inclusiveMatrixInverse();
+    position = GfVec3d(cameraToStage[3][0], cameraToStage[3][1], cameraToStage[3][2]);
+    return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::checkStreamingCamera(const MDagPath& cameraPath)
+{
+  if(!m_stage || m_payloadStreamingQueued || !streamPayloadsPlug().asBool())
+    return;
+
+  // only the camera of the active view is used to prioritise the payloads, so draws in other views are ignored (they
+  // would otherwise keep queueing rounds that stream for the active view)
+  MDagPath activeCameraPath;
+  if(!M3dView::active3dView().getCamera(activeCameraPath) || !(activeCameraPath == cameraPath))
+    return;
+
+  GfVec3d position;
+  if(!activeCameraPosition(position))
+    return;
+  if(m_hasStreamedCameraPosition &&
+     (position - m_streamedCameraPosition).GetLength() < streamingCameraDistancePlug().asDouble())
+    return;
+  queuePayloadStreaming();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ProxyShape::streamPayloadRound()
+{
+  Trace("ProxyShape::streamPayloadRound");
+  m_payloadStreamingQueued = false;
+  if(!m_stage || !streamPayloadsPlug().asBool())
+    return false;
+
+  // the StageCache may hand the same stage to more than one proxy shape, in which case the payloads loaded by one are
+  // loaded for all of them, and a budget applied on behalf of one would unload payloads the others rely on
+  {
+    MFnDependencyNode fn;
+    MItDependencyNodes iter(MFn::kPluginShape);
+    for(; !iter.isDone(); iter.next())
+    {
+      fn.setObject(iter.item());
+      if(fn.typeId() == ProxyShape::kTypeId && fn.userNode() != this && ((ProxyShape*)fn.userNode())->m_stage == m_stage)
+      {
+        MGlobal::displayWarning(MString("Payload streaming is disabled on \"") + name() + "\", as its stage is shared with \"" +
+                                fn.name() + "\"");
+        return false;
+      }
+    }
+  }
+
+  m_payloadStreamer.setBudget(size_t(std::max(streamingBudgetPlug().asInt(), 0)) * 1024 * 1024);
+
+  const SdfPathVector priorityPaths = parsePathList(streamingPriorityPathsPlug().asString());
+  SdfPathVector selected = selectedPaths();
+  const SdfPathVector& selectedPrims = selectionList().paths();
+  selected.insert(selected.end(), selectedPrims.begin(), selectedPrims.end());
+
+  GfVec3d cameraPosition(0.0);
+  const bool hasCamera = activeCameraPosition(cameraPosition);
+  if(hasCamera)
+  {
+    m_streamedCameraPosition = cameraPosition;
+    m_hasStreamedCameraPosition = true;
   }
+
+  // the distance from the camera gives a priority in the range (0, 1]. Being selected adds 1, and being under one of
+  // the priority paths adds 2, so that those always take precedence.
+  UsdGeomXformCache xformCache(UsdTimeCode(outTimePlug().asMTime().as(MTime::uiUnit())));
+  const SdfPathSet loadable = m_stage->FindLoadable(m_path);
+  PayloadStreamer::Priorities priorities;
+  priorities.reserve(loadable.size());
+  for(const SdfPath& path : loadable)
+  {
+    double priority = 0.0;
+    if(hasCamera)
+    {
+      UsdPrim prim = m_stage->GetPrimAtPath(path);
+      if(prim)
+      {
+        const GfVec3d position = xformCache.GetLocalToWorldTransform(prim).ExtractTranslation();
+        priority = 1.0 / (1.0 + (position - cameraPosition).GetLength());
+      }
+    }
+    for(const SdfPath& selectedPath : selected)
+    {
+      if(selectedPath.HasPrefix(path) || path.HasPrefix(selectedPath))
+      {
+        priority += 1.0;
+        break;
+      }
+    }
+    for(const SdfPath& priorityPath : priorityPaths)
+    {
+      if(path.HasPrefix(priorityPath))
+      {
+        priority += 2.0;
+        break;
+      }
+    }
+    priorities.emplace_back(path, priority);
+  }
+
+  if(!m_payloadStreamer.update(priorities))
+    return false;
+
+  // the bounds change as payloads are loaded and unloaded
+  m_boundingBoxCache.clear();
+  MHWRender::MRenderer::setGeometryDrawDirty(thisMObject(), true);
+
+  // the cost predictions have improved with the payloads just loaded, so there may be room for more (or, if they
+  // turned out larger than predicted, too little). The costs of payloads are remembered once measured, so the rounds
+  // settle once every payload that was predicted to fit has been loaded.
+  queuePayloadStreaming();
+  return true;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
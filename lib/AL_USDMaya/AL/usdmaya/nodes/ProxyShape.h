@@ -17,6 +17,7 @@
 #include "AL/usdmaya/Common.h"
 #include "AL/maya/NodeHelper.h"
 #include "AL/usdmaya/DrivenTransformsData.h"
+#include "AL/usdmaya/PayloadStreamer.h"
 #include "AL/usdmaya/fileio/translators/TranslatorBase.h"
 #include "AL/usdmaya/fileio/translators/TranslatorContext.h"
 #include "AL/usdmaya/fileio/translators/TransformTranslator.h"
@@ -29,14 +30,18 @@
 #include "maya/MEvaluationNode.h"
 #include "maya/MDagModifier.h"
 #include "maya/MSelectionList.h"
+#include "maya/MObjectHandle.h"
 #include "pxr/pxr.h"
+#include "pxr/base/gf/vec3d.h"
 #include "pxr/usd/usd/prim.h"
 #include "pxr/usd/usd/timeCode.h"
 #include "pxr/usd/sdf/path.h"
+#include "pxr/base/tf/hash.h"
 #include "pxr/base/tf/weakBase.h"
 #include "pxr/usd/usd/notice.h"
 #include "pxr/usd/sdf/notice.h"
 #include <stack>
+#include <unordered_map>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
@@ -209,6 +214,24 @@ public:
   /// \return the root layer, or NULL if stage is invalid
   Layer* getLayer();
 
+  /// \brief  returns the sub layers of a layer node from the cached layer graph of this proxy shape. The layer graph
+  ///         is rebuilt from the connections in Maya whenever a layer connection has changed.
+  /// \param  layer the layer node
+  /// \return the sub layers of the node, or NULL if the layer node is not part of this proxy shape's layer graph
+  const std::vector<Layer*>* cachedSubLayers(const Layer* layer);
+
+  /// \brief  returns the child layers of a layer node from the cached layer graph of this proxy shape. The layer
+  ///         graph is rebuilt from the connections in Maya whenever a layer connection has changed.
+  /// \param  layer the layer node
+  /// \return the child layers of the node, or NULL if the layer node is not part of this proxy shape's layer graph
+  const std::vector<Layer*>* cachedChildLayers(const Layer* layer);
+
+  /// \brief  flags the cached layer graph of this proxy shape as out of date. This is called by the layer nodes of
+  ///         this proxy shape when their connections or layer handles change, and by the commands that add or remove
+  ///         sub layers and child layers.
+  inline void invalidateLayerGraph()
+    { ++m_layerGraphGeneration; }
+
   //--------------------------------------------------------------------------------------------------------------------
   /// \name   Input Attributes
   //--------------------------------------------------------------------------------------------------------------------
@@ -259,6 +282,20 @@ public:
   /// Open the stage unloaded.
   AL_DECL_ATTRIBUTE(unloaded);
 
+  /// Stream the payloads of the stage in and out of memory, rather than loading all of them. The stage is opened
+  /// unloaded, and the payloads are loaded in priority order within the streaming budget.
+  AL_DECL_ATTRIBUTE(streamPayloads);
+
+  /// the memory budget (in MB) for the loaded payloads when streaming. Zero loads every payload.
+  AL_DECL_ATTRIBUTE(streamingBudget);
+
+  /// a comma seperated list of prims whose payloads should be streamed in before any others.
+  AL_DECL_ATTRIBUTE(streamingPriorityPaths);
+
+  /// the distance the camera of the active view has to move (in the space of the stage) before the payloads are
+  /// streamed again.
+  AL_DECL_ATTRIBUTE(streamingCameraDistance);
+
   /// an array of strings that represent the paths to be driven
   AL_DECL_ATTRIBUTE(drivenPrimPaths);
 
@@ -366,6 +403,26 @@ public:
       return MObject::kNullObj;
     }
 
+  /// \brief  records that the maya node was created to represent the prim at the path specified. The mapping is held
+  ///         in memory, and is only written into the session layer (as MayaPath customData) when the scene is saved.
+  /// \param  path the path of the prim
+  /// \param  node the maya node created for the prim
+  void mapPrimToMayaNode(const SdfPath& path, const MObject& node);
+
+  /// \brief  returns the maya node created for the prim at the path specified
+  /// \param  path the path of the prim
+  /// \return the maya node, or MObject::kNullObj if no node has been created for the prim (or it has been deleted)
+  MObject primToMayaNode(const SdfPath& path) const;
+
+  /// \brief  returns the path of the prim that the maya node was created for
+  /// \param  node the maya node
+  /// \return the path of the prim, or an empty path if the node was not created by this proxy shape
+  SdfPath mayaNodeToPrim(const MObject& node) const;
+
+  /// \brief  writes the maya path of each node in the prim to node index into the session layer as MayaPath
+  ///         customData on its prim, for consumers outside of this process. Called prior to the scene being saved.
+  void writeMayaPathsToSessionLayer();
+
   /// \brief  traverses the UsdStage looking for the prims that are going to be handled by custom transformer
   ///         plug-ins.
   /// \param  proxyTransformPath the DAG path of the proxy shape
@@ -449,7 +506,11 @@ public:
 
   /// \brief  destroys all internal transform references
   void destroyTransformReferences()
-    { m_requiredPaths.clear(); }
+    {
+      m_requiredPaths.clear();
+      m_primNodeIndex.m_nodes.clear();
+      m_primNodeIndex.m_prims.clear();
+    }
 
   MObjectToPrim filterUpdatablePrims(std::vector<UsdPrim>& variantPrimsToSwitch);
 
@@ -493,11 +554,53 @@ public:
   /// \brief  constructs the USD imaging engine for this shape
   void constructGLImagingEngine();
 
-  /// \brief  returns the usd imaging engine for this proxy shape
+  /// \brief  returns the usd imaging engine for this proxy shape. Each proxy shape has its own engine, even when drawing
+  ///         the same stage as another: UsdImagingGLHdEngine owns its render index and delegate (and bakes in the root
+  ///         and excluded paths), so sharing a render index between shapes would need a custom engine.
   /// \return the imagine engin instance for this shape (shared between draw override and shape ui)
   inline UsdImagingGLHdEngine* engine() const
     { return m_engine; }
 
+  /// \brief  records that the specified caller (i.e. the VP2 draw override, or the VP1 shape UI) is about to apply its
+  ///         lighting to the engine, which otherwise retains its lighting state between draws.
+  /// \param  user an identifier for the caller
+  /// \return true if the lighting must be applied, because the engine is new or another caller has since applied its own
+  bool claimEngineLighting(const void* user)
+  {
+    const bool changed = m_engineLightingUser != user;
+    m_engineLightingUser = user;
+    return changed;
+  }
+
+  //--------------------------------------------------------------------------------------------------------------------
+  /// \name   Payload Streaming
+  //--------------------------------------------------------------------------------------------------------------------
+
+  /// \brief  performs one round of payload streaming. Every payload of the stage is given a priority, highest first:
+  ///         those under the streamingPriorityPaths, those containing (or within) the selected prims, and then by
+  ///         distance from the camera of the active view. The payloads are then loaded and unloaded within the
+  ///         streamingBudget, in a single call to UsdStage::LoadAndUnload. If anything changed, another round is queued
+  ///         (as the cost predictions improve with each payload loaded), until the loaded payloads settle. Does
+  ///         nothing if streamPayloads is off, or if the stage is also used by another proxy shape (the streamer would
+  ///         unload payloads the other shape relies on).
+  /// \return true if any payloads were loaded or unloaded
+  bool streamPayloadRound();
+
+  /// \brief  queues a round of payload streaming to run when Maya is next idle (loading payloads from within an
+  ///         attribute or selection callback is not safe). Only one round is queued at a time. The shape is found by
+  ///         its UUID when the round runs, so renaming or reparenting it in the meantime is safe.
+  void queuePayloadStreaming();
+
+  /// \brief  called when the shape is drawn. If the camera is that of the active view, and it has moved further than
+  ///         streamingCameraDistance since the last round of payload streaming, another round is queued.
+  /// \param  cameraPath the camera the shape is being drawn with
+  void checkStreamingCamera(const MDagPath& cameraPath);
+
+  /// \brief  returns the payload streamer for this shape
+  /// \return the payload streamer
+  PayloadStreamer& payloadStreamer()
+    { return m_payloadStreamer; }
+
   //--------------------------------------------------------------------------------------------------------------------
   /// \name   Miscellaneous
   //--------------------------------------------------------------------------------------------------------------------
@@ -725,7 +828,24 @@ private:
                              std::vector<UsdPrim>& drivenPrims, const DrivenTransforms& drivenTransforms);
   void updateDrivenTransforms(std::vector<UsdPrim>& drivenPrims, const DrivenTransforms& drivenTransforms, const MTime&);
   void updateDrivenVisibility(std::vector<UsdPrim>& drivenPrims, const DrivenTransforms& drivenTransforms, const MTime&);
+  void updateLayerGraph();
+
+  /// the layer nodes connected to this proxy shape, indexed by layer handle, along with the sub/child layer nodes
+  /// connected to each layer node.
+  struct LayerGraph
+  {
+    std::unordered_map<SdfLayerHandle, Layer*, TfHash> m_layers;
+    std::unordered_map<const Layer*, std::vector<Layer*> > m_subLayers;
+    std::unordered_map<const Layer*, std::vector<Layer*> > m_childLayers;
+    uint64_t m_generation = ~uint64_t(0); ///< the m_layerGraphGeneration the graph was built for
+  };
 
+  /// the maya nodes created for prims, indexed in both directions
+  struct PrimNodeIndex
+  {
+    std::unordered_map<SdfPath, MObjectHandle, SdfPath::Hash> m_nodes;
+    std::unordered_multimap<uint32_t, SdfPath> m_prims; ///< keyed by MObjectHandle::hashCode()
+  };
 
 private:
   SelectionList m_selectionList;
@@ -749,8 +869,16 @@ private:
   SchemaNodeRefDB m_schemaNodeDB;
   SdfPath m_variantChangePath;
   SdfPathVector m_variantSwitchedPrims;
+  LayerGraph m_layerGraph;
+  uint64_t m_layerGraphGeneration = 0;
+  PrimNodeIndex m_primNodeIndex;
   UsdImagingGLHdEngine* m_engine = 0;
-  uint32_t m_engineRefCount = 0;
+  const void* m_engineLightingUser = 0;
+  bool activeCameraPosition(GfVec3d& position);
+  PayloadStreamer m_payloadStreamer;
+  GfVec3d m_streamedCameraPosition = GfVec3d(0.0); ///< the camera position the payloads were last streamed for
+  bool m_hasStreamedCameraPosition = false;
+  bool m_payloadStreamingQueued = false;
   bool m_compositionHasChanged = false;
   bool m_drivenTransformsDirty = false;
   bool m_pleaseIgnoreSelection = false;
@@ -23,6 +23,9 @@
 #include "maya/MFnDagNode.h"
 #include "maya/MPxCommand.h"
 
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/sdf/primSpec.h"
+
 #include <set>
 #include <algorithm>
 
@@ -49,6 +52,13 @@ void ProxyShape::onSelectionChanged(void* ptr)
 {
   Trace("ProxyShapeSelection::onSelectionChanged " << MGlobal::isUndoing());
 
+  // the selection affects the priority of the payloads being streamed
+  {
+    ProxyShape* proxy = (ProxyShape*)ptr;
+    if(proxy && proxy->m_stage && proxy->streamPayloadsPlug().asBool())
+      proxy->queuePayloadStreaming();
+  }
+
   const int selectionMode = MGlobal::optionVarIntValue("AL_usdmaya_selectMode");
   if(selectionMode)
   {
@@ -303,6 +313,103 @@ void ProxyShape::makeTransformReference(const SdfPath& path, const MObject& node
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::mapPrimToMayaNode(const SdfPath& path, const MObject& node)
+{
+  MObjectHandle handle(node);
+  auto inserted = m_primNodeIndex.m_nodes.emplace(path, handle);
+  if(!inserted.second)
+  {
+    if(inserted.first->second == handle)
+      return;
+    inserted.first->second = handle;
+  }
+  // any stale entry left behind for a previous node of this prim is ignored by mayaNodeToPrim, and pruned when the
+  // index is next written to the session layer
+  m_primNodeIndex.m_prims.emplace(handle.hashCode(), path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MObject ProxyShape::primToMayaNode(const SdfPath& path) const
+{
+  auto it = m_primNodeIndex.m_nodes.find(path);
+  if(it != m_primNodeIndex.m_nodes.end() && it->second.isValid())
+  {
+    return it->second.object();
+  }
+  return MObject::kNullObj;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+SdfPath ProxyShape::mayaNodeToPrim(const MObject& node) const
+{
+  MObjectHandle handle(node);
+  auto range = m_primNodeIndex.m_prims.equal_range(handle.hashCode());
+  for(auto it = range.first; it != range.second; ++it)
+  {
+    auto nodeIt = m_primNodeIndex.m_nodes.find(it->second);
+    if(nodeIt != m_primNodeIndex.m_nodes.end() && nodeIt->second == handle)
+    {
+      return it->second;
+    }
+  }
+  return SdfPath();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::writeMayaPathsToSessionLayer()
+{
+  Trace("ProxyShapeSelection::writeMayaPathsToSessionLayer");
+  static const TfToken mayaPathKey("MayaPath");
+
+  // drop the nodes that have since been deleted, and rebuild the reverse lookup without the stale entries
+  m_primNodeIndex.m_prims.clear();
+  for(auto it = m_primNodeIndex.m_nodes.begin(); it != m_primNodeIndex.m_nodes.end(); )
+  {
+    if(!it->second.isValid())
+    {
+      it = m_primNodeIndex.m_nodes.erase(it);
+      continue;
+    }
+    m_primNodeIndex.m_prims.emplace(it->second.hashCode(), it->first);
+    ++it;
+  }
+
+  if(!m_stage || m_primNodeIndex.m_nodes.empty())
+    return;
+
+  // find the paths that have changed through the composed stage first, and then author them on the session layer
+  // through the Sdf API, which (unlike UsdPrim::SetCustomDataByKey) is safe to call within an SdfChangeBlock.
+  std::vector<std::pair<SdfPath, VtValue> > changed;
+  MDagPath dagPath;
+  for(const auto& entry : m_primNodeIndex.m_nodes)
+  {
+    UsdPrim prim = m_stage->GetPrimAtPath(entry.first);
+    if(!prim || !MDagPath::getAPathTo(entry.second.object(), dagPath))
+      continue;
+
+    VtValue mayaPath(convert(dagPath.fullPathName()));
+    if(prim.GetCustomDataByKey(mayaPathKey) != mayaPath)
+    {
+      changed.emplace_back(entry.first, mayaPath);
+    }
+  }
+
+  if(changed.empty())
+    return;
+
+  SdfLayerHandle sessionLayer = m_stage->GetSessionLayer();
+  SdfChangeBlock changeBlock;
+  for(const auto& entry : changed)
+  {
+    SdfPrimSpecHandle primSpec = SdfCreatePrimInLayer(sessionLayer, entry.first);
+    if(primSpec)
+    {
+      primSpec->SetCustomData(mayaPathKey.GetString(), entry.second);
+    }
+  }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 inline void ProxyShape::prepSelect()
 {
@@ -488,15 +595,16 @@ MObject ProxyShape::makeUsdTransformChain(
   fn.setObject(node);
   fn.setName(convert(usdPrim.GetName().GetString()));
 
-  //Retrieve the proxy shapes transform path which will be used in the UsdPrim->MayaNode mapping in the case where there is delayed node creation.
-  MFnDagNode shapeFn(thisMObject());
-  const MObject shapeParent = shapeFn.parent(0);
-  MDagPath mayaPath;
-  MDagPath::getAPathTo(shapeParent, mayaPath);
+  mapPrimToMayaNode(usdPrim.GetPath(), node);
   if(resultingPath)
-    *resultingPath = mapUsdPrimToMayaNode(usdPrim, node, &mayaPath);
-  else
-    mapUsdPrimToMayaNode(usdPrim, node, &mayaPath);
+  {
+    //Retrieve the proxy shapes transform path which will be used to build the maya path in the case where there is delayed node creation.
+    MFnDagNode shapeFn(thisMObject());
+    const MObject shapeParent = shapeFn.parent(0);
+    MDagPath mayaPath;
+    MDagPath::getAPathTo(shapeParent, mayaPath);
+    *resultingPath = mayaPathForUsdPrim(usdPrim, node, &mayaPath);
+  }
 
   if(isUsdTransform)
   {
@@ -119,6 +119,13 @@ void ProxyShapeUI::draw(const MDrawRequest& request, M3dView& view) const
   MMatrix invViewMatrix = viewMatrix.inverse();
   engine->SetRootTransform(GfMatrix4d(model.matrix));
 
+  // payloads are streamed by distance from the camera, so moving the camera may need another round of streaming
+  MDagPath cameraPath;
+  if(view.getCamera(cameraPath))
+  {
+    shape->checkStreamingCamera(cameraPath);
+  }
+
   unsigned int x, y, w, h;
   view.viewport(x, y, w, h);
   engine->SetCameraState(
@@ -228,6 +235,9 @@ void ProxyShapeUI::draw(const MDrawRequest& request, M3dView& view) const
 
   #endif
 
+  // the lighting has been set directly, so the draw override must reapply its own the next time it draws with the engine
+  shape->claimEngineLighting(this);
+
   auto paths = shape->selectedPaths();
   engine->SetSelected(paths);
   engine->SetSelectionColor(GfVec4f(1.0f, 2.0f/3.0f, 0.0f, 1.0f));
@@ -283,7 +293,10 @@ bool ProxyShapeUI::select(MSelectInfo& selectInfo, MSelectionList& selectionList
   MDagPath selectPath = selectInfo.selectPath();
   MMatrix invMatrix = selectPath.inclusiveMatrixInverse();
 
+  ProxyShape* proxyShape = (ProxyShape*)surfaceShape();
+
   UsdImagingGLEngine::RenderParams params;
+  params.frame = UsdTimeCode(proxyShape->outTimePlug().asMTime().as(MTime::uiUnit()));
   MMatrix viewMatrix, projectionMatrix;
   GfMatrix4d worldToLocalSpace(invMatrix.matrix);
 
@@ -293,8 +306,11 @@ bool ProxyShapeUI::select(MSelectInfo& selectInfo, MSelectionList& selectionList
   glGetDoublev(GL_PROJECTION_MATRIX, projectionMatrix[0]);
   view.endSelect();
 
-  ProxyShape* proxyShape = (ProxyShape*)surfaceShape();
+  // the engine is shared by every instance of the shape, so pick with the transform of the instance being selected
   auto engine = proxyShape->engine();
+  if(!engine)
+    return false;
+  engine->SetRootTransform(GfMatrix4d(selectPath.inclusiveMatrix().matrix));
   proxyShape->m_pleaseIgnoreSelection = true;
 
   UsdPrim root = proxyShape->getUsdStage()->GetPseudoRoot();
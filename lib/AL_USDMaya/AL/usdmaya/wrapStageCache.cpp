@@ -34,5 +34,15 @@ void wrapStageCache()
        boost::python::return_value_policy<boost::python::reference_existing_object>())
     .staticmethod("Get")
     .def("Clear", &AL::usdmaya::StageCache::Clear)
-    .staticmethod("Clear");
+    .staticmethod("Clear")
+    .def("SetLayerCacheBudget", &AL::usdmaya::StageCache::setLayerCacheBudget)
+    .staticmethod("SetLayerCacheBudget")
+    .def("GetLayerCacheBudget", &AL::usdmaya::StageCache::layerCacheBudget)
+    .staticmethod("GetLayerCacheBudget")
+    .def("GetLayerCacheSize", &AL::usdmaya::StageCache::layerCacheSize)
+    .staticmethod("GetLayerCacheSize")
+    .def("ClearLayerCache", &AL::usdmaya::StageCache::clearLayerCache)
+    .staticmethod("ClearLayerCache")
+    .def("RefreshLayerCache", &AL::usdmaya::StageCache::refreshLayerCache)
+    .staticmethod("RefreshLayerCache");
 }
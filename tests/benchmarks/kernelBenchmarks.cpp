@@ -0,0 +1,323 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//----------------------------------------------------------------------------------------------------------------------
+/// \file   kernelBenchmarks.cpp
+/// \brief  A standalone benchmark of the pure data kernels used by the mesh translator and the half float conversions.
+///         It does not need maya (or a maya licence) to run. Each kernel is timed for every SIMD level compiled into
+///         the build that the host CPU can run, on synthetic data sized like a heavy production mesh, and the output
+///         of each level is checked against the scalar kernels.
+///
+///         usage: AL_USDMayaKernelBenchmarks [--iterations N] [--points N] [--faceVertices N]
+//----------------------------------------------------------------------------------------------------------------------
+#include "AL/maya/ALHalf.h"
+#include "AL/maya/CpuFeatures.h"
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+using AL::maya::SimdLevel;
+using AL::maya::HalfConversionKernels;
+using AL::usdmaya::fileio::translators::MeshKernels;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+struct BenchmarkOptions
+{
+  uint32_t iterations = 20;
+  uint32_t points = 1u << 20;
+  uint32_t faceVertices = 1u << 22;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  runs the function the specified number of times, and returns the fastest time in seconds
+double timeBest(const std::function<void()>& func, const uint32_t iterations)
+{
+  double best = 1e30;
+  for(uint32_t i = 0; i < iterations; ++i)
+  {
+    const auto start = std::chrono::high_resolution_clock::now();
+    func();
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    if(seconds < best)
+      best = seconds;
+  }
+  return best;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  prints a line of the results table
+/// \param  kernel the name of the kernel
+/// \param  level the SIMD level the kernel was compiled for
+/// \param  elements the number of elements processed in one call
+/// \param  bytes the number of bytes read and written in one call
+/// \param  seconds the fastest time for one call
+/// \param  matches true if the output matches the scalar kernel
+void report(const char* kernel, SimdLevel level, size_t elements, size_t bytes, double seconds, bool matches)
+{
+  std::printf("%-40s %-8s %10.3f ms %10.1f Melem/s %8.2f GB/s%s\n",
+      kernel,
+      AL::maya::simdLevelName(level),
+      seconds * 1e3,
+      elements / seconds * 1e-6,
+      bytes / seconds * 1e-9,
+      matches ? "" : "   MISMATCH");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool equal(const std::vector<T>& a, const std::vector<T>& b)
+{
+  return a.size() == b.size() && !std::memcmp(a.data(), b.data(), a.size() * sizeof(T));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the synthetic data the kernels are run against
+struct BenchmarkData
+{
+  BenchmarkData(const BenchmarkOptions& options)
+  {
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<float> values(-100.0f, 100.0f);
+
+    // a point for each vertex, along with a UV for each vertex (the usual ratio when UV shells are mostly welded)
+    points.resize(size_t(options.points) * 3);
+    for(auto& value : points)
+      value = values(rng);
+
+    u.resize(options.points);
+    v.resize(options.points);
+    for(uint32_t i = 0; i < options.points; ++i)
+    {
+      u[i] = values(rng);
+      v[i] = values(rng);
+    }
+
+    // the per face-vertex UV indices, and a quad mesh's worth of per face UV counts, none of which are zero so that
+    // the sparse check has to scan the full array.
+    std::uniform_int_distribution<int32_t> index(0, int32_t(options.points) - 1);
+    uvIndices.resize(options.faceVertices);
+    for(auto& i : uvIndices)
+      i = index(rng);
+    uvCounts.assign(options.faceVertices / 4, 4);
+
+    // face-varying data, zipped into UV pairs
+    faceVaryingU.resize(options.faceVertices);
+    faceVaryingV.resize(options.faceVertices);
+    for(uint32_t i = 0; i < options.faceVertices; ++i)
+    {
+      faceVaryingU[i] = values(rng);
+      faceVaryingV[i] = values(rng);
+    }
+
+    halfFloats.resize(options.faceVertices);
+    halfDoubles.resize(options.faceVertices);
+    for(uint32_t i = 0; i < options.faceVertices; ++i)
+    {
+      halfFloats[i] = values(rng);
+      halfDoubles[i] = halfFloats[i];
+    }
+    halves.resize(options.faceVertices);
+    for(uint32_t i = 0; i < options.faceVertices; ++i)
+      halves[i] = GfHalf(halfFloats[i]);
+  }
+
+  std::vector<float> points;
+  std::vector<float> u;
+  std::vector<float> v;
+  std::vector<int32_t> uvIndices;
+  std::vector<int32_t> uvCounts;
+  std::vector<float> faceVaryingU;
+  std::vector<float> faceVaryingV;
+  std::vector<float> halfFloats;
+  std::vector<double> halfDoubles;
+  std::vector<GfHalf> halves;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+void benchmarkMeshKernels(const MeshKernels& kernels, const MeshKernels& scalar, const BenchmarkData& data,
+                          const BenchmarkOptions& options)
+{
+  const size_t points = options.points;
+  const size_t faceVertices = options.faceVertices;
+
+  {
+    std::vector<float> result(points * 4), expected(points * 4);
+    scalar.convert3DArrayTo4DArray(data.points.data(), expected.data(), points);
+    const double seconds = timeBest([&] { kernels.convert3DArrayTo4DArray(data.points.data(), result.data(), points); }, options.iterations);
+    report("convert3DArrayTo4DArray", kernels.level, points, points * 7 * sizeof(float), seconds, equal(result, expected));
+  }
+  {
+    std::vector<double> result(points * 3), expected(points * 3);
+    scalar.convertFloatVec3ArrayToDoubleVec3Array(data.points.data(), expected.data(), points);
+    const double seconds = timeBest([&] { kernels.convertFloatVec3ArrayToDoubleVec3Array(data.points.data(), result.data(), points); }, options.iterations);
+    report("convertFloatVec3ArrayToDoubleVec3Array", kernels.level, points, points * 3 * (sizeof(float) + sizeof(double)), seconds, equal(result, expected));
+  }
+  {
+    std::vector<float> result(faceVertices * 2), expected(faceVertices * 2);
+    scalar.zipUVs(data.faceVaryingU.data(), data.faceVaryingV.data(), expected.data(), faceVertices);
+    const double seconds = timeBest([&] { kernels.zipUVs(data.faceVaryingU.data(), data.faceVaryingV.data(), result.data(), faceVertices); }, options.iterations);
+    report("zipUVs", kernels.level, faceVertices, faceVertices * 4 * sizeof(float), seconds, equal(result, expected));
+
+    std::vector<float> u(faceVertices), v(faceVertices);
+    const double unzipSeconds = timeBest([&] { kernels.unzipUVs(expected.data(), u.data(), v.data(), faceVertices); }, options.iterations);
+    report("unzipUVs", kernels.level, faceVertices, faceVertices * 4 * sizeof(float), unzipSeconds, equal(u, data.faceVaryingU) && equal(v, data.faceVaryingV));
+  }
+  {
+    std::vector<float> result(faceVertices * 2), expected(faceVertices * 2);
+    scalar.interleaveIndexedUvData(expected.data(), data.u.data(), data.v.data(), data.uvIndices.data(), faceVertices);
+    const double seconds = timeBest([&] { kernels.interleaveIndexedUvData(result.data(), data.u.data(), data.v.data(), data.uvIndices.data(), faceVertices); }, options.iterations);
+    report("interleaveIndexedUvData", kernels.level, faceVertices, faceVertices * (sizeof(int32_t) + 4 * sizeof(float)), seconds, equal(result, expected));
+  }
+  {
+    const uint32_t count = uint32_t(data.uvCounts.size());
+    bool sparse = false;
+    const double seconds = timeBest([&] { sparse = kernels.isUvSetDataSparse(data.uvCounts.data(), count); }, options.iterations);
+    report("isUvSetDataSparse", kernels.level, count, count * sizeof(int32_t), seconds, !sparse);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void benchmarkHalfKernels(const HalfConversionKernels& kernels, const HalfConversionKernels& scalar, SimdLevel level,
+                          const BenchmarkData& data, const BenchmarkOptions& options)
+{
+  // the conversions process 8 values at a time, with a 4 wide conversion for the remainder (as DgNodeHelper does)
+  const size_t count = options.faceVertices & ~size_t(7);
+
+  auto toFloat = [count](const HalfConversionKernels& k, const GfHalf* input, float* output)
+  {
+    for(size_t i = 0; i < count; i += 8)
+      k.half2float_8f(input + i, output + i);
+  };
+  auto toDouble = [count](const HalfConversionKernels& k, const GfHalf* input, double* output)
+  {
+    for(size_t i = 0; i < count; i += 8)
+      k.half2double_8f(input + i, output + i);
+  };
+  auto fromFloat = [count](const HalfConversionKernels& k, const float* input, GfHalf* output)
+  {
+    for(size_t i = 0; i < count; i += 8)
+      k.float2half_8f(input + i, output + i);
+  };
+  auto fromDouble = [count](const HalfConversionKernels& k, const double* input, GfHalf* output)
+  {
+    for(size_t i = 0; i < count; i += 8)
+      k.double2half_8f(input + i, output + i);
+  };
+
+  {
+    std::vector<float> result(count), expected(count);
+    toFloat(scalar, data.halves.data(), expected.data());
+    const double seconds = timeBest([&] { toFloat(kernels, data.halves.data(), result.data()); }, options.iterations);
+    report("half2float", level, count, count * (sizeof(GfHalf) + sizeof(float)), seconds, equal(result, expected));
+  }
+  {
+    std::vector<double> result(count), expected(count);
+    toDouble(scalar, data.halves.data(), expected.data());
+    const double seconds = timeBest([&] { toDouble(kernels, data.halves.data(), result.data()); }, options.iterations);
+    report("half2double", level, count, count * (sizeof(GfHalf) + sizeof(double)), seconds, equal(result, expected));
+  }
+  {
+    std::vector<GfHalf> result(count), expected(count);
+    fromFloat(scalar, data.halfFloats.data(), expected.data());
+    const double seconds = timeBest([&] { fromFloat(kernels, data.halfFloats.data(), result.data()); }, options.iterations);
+    report("float2half", level, count, count * (sizeof(GfHalf) + sizeof(float)), seconds, equal(result, expected));
+  }
+  {
+    std::vector<GfHalf> result(count), expected(count);
+    fromDouble(scalar, data.halfDoubles.data(), expected.data());
+    const double seconds = timeBest([&] { fromDouble(kernels, data.halfDoubles.data(), result.data()); }, options.iterations);
+    report("double2half", level, count, count * (sizeof(GfHalf) + sizeof(double)), seconds, equal(result, expected));
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool parseOptions(int argc, char** argv, BenchmarkOptions& options)
+{
+  for(int i = 1; i < argc; ++i)
+  {
+    uint32_t* value = nullptr;
+    if(!std::strcmp(argv[i], "--iterations"))
+      value = &options.iterations;
+    else
+    if(!std::strcmp(argv[i], "--points"))
+      value = &options.points;
+    else
+    if(!std::strcmp(argv[i], "--faceVertices"))
+      value = &options.faceVertices;
+
+    if(!value || i + 1 == argc)
+    {
+      std::fprintf(stderr, "usage: %s [--iterations N] [--points N] [--faceVertices N]\n", argv[0]);
+      return false;
+    }
+    *value = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+  }
+  if(!options.iterations || !options.points || !options.faceVertices)
+  {
+    std::fprintf(stderr, "the iterations, points and faceVertices must all be greater than zero\n");
+    return false;
+  }
+  return true;
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  BenchmarkOptions options;
+  if(!parseOptions(argc, argv, options))
+    return 1;
+
+  const AL::maya::CpuFeatures& features = AL::maya::hostCpuFeatures();
+  const SimdLevel hostLevel = AL::maya::hostSimdLevel();
+  std::printf("host: %s (sse3 %d, sse4.1 %d, avx %d, avx2 %d, fma %d, f16c %d, avx512f %d)\n",
+      AL::maya::simdLevelName(hostLevel),
+      features.sse3, features.sse41, features.avx, features.avx2, features.fma, features.f16c, features.avx512f);
+  std::printf("points: %u, face vertices: %u, iterations: %u (fastest reported)\n\n",
+      options.points, options.faceVertices, options.iterations);
+
+  const BenchmarkData data(options);
+
+  const MeshKernels& scalarMesh = *AL::usdmaya::fileio::translators::meshKernels(SimdLevel::kScalar);
+  const HalfConversionKernels& scalarHalf = *AL::maya::halfConversionKernels(SimdLevel::kScalar);
+  for(uint32_t level = uint32_t(SimdLevel::kScalar); level <= uint32_t(hostLevel); ++level)
+  {
+    if(const MeshKernels* kernels = AL::usdmaya::fileio::translators::meshKernels(SimdLevel(level)))
+    {
+      benchmarkMeshKernels(*kernels, scalarMesh, data, options);
+    }
+  }
+  std::printf("\n");
+
+  for(uint32_t level = uint32_t(SimdLevel::kScalar); level <= uint32_t(hostLevel); ++level)
+  {
+    if(const HalfConversionKernels* kernels = AL::maya::halfConversionKernels(SimdLevel(level)))
+    {
+      if(SimdLevel(level) == SimdLevel::kAVX2 && !(features.avx && features.f16c))
+        continue;
+      benchmarkHalfKernels(*kernels, scalarHalf, SimdLevel(level), data, options);
+    }
+  }
+  return 0;
+}
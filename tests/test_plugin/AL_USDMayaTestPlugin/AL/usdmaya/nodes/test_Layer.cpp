@@ -33,6 +33,9 @@
 #include "pxr/usd/usdGeom/xformCommonAPI.h"
 #include "pxr/usd/sdf/layer.h"
 
+#include <algorithm>
+#include <fstream>
+
 //#define TEST(X, Y) void X##Y()
 
 //  Layer();
@@ -331,6 +334,63 @@ TEST(Layer, addRemoveSublayersLayers)
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that the layer tree is built from the external references of each layer, whether a layer is referred
+///         to by its display name (a relative asset path) or by its full path
+//----------------------------------------------------------------------------------------------------------------------
+TEST(Layer, layerTreeResolvesReferences)
+{
+  MFileIO::newFile(true);
+
+  const std::string relativeRefPath = "/tmp/AL_USDMayaTests_layerTree_relativeRef.usda";
+  const std::string absoluteRefPath = "/tmp/AL_USDMayaTests_layerTree_absoluteRef.usda";
+  const std::string subLayerPath = "/tmp/AL_USDMayaTests_layerTree_sub.usda";
+  const std::string rootLayerPath = "/tmp/AL_USDMayaTests_layerTree_root.usda";
+  {
+    std::ofstream(relativeRefPath.c_str()) << "#usda 1.0\n\ndef Xform \"model\"\n{\n}\n";
+    std::ofstream(absoluteRefPath.c_str()) << "#usda 1.0\n\ndef Xform \"model\"\n{\n}\n";
+    std::ofstream(subLayerPath.c_str())
+        << "#usda 1.0\n\ndef Xform \"relative\" (\n    references = @AL_USDMayaTests_layerTree_relativeRef.usda@</model>\n)\n{\n}\n";
+    std::ofstream(rootLayerPath.c_str())
+        << "#usda 1.0\n(\n    subLayers = [\n        @" << subLayerPath << "@\n    ]\n)\n\n"
+        << "def Xform \"absolute\" (\n    references = @" << absoluteRefPath << "@</model>\n)\n{\n}\n";
+  }
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+
+  // force the stage to load
+  proxy->filePathPlug().setString(rootLayerPath.c_str());
+  auto stage = proxy->getUsdStage();
+  ASSERT_TRUE(stage);
+  ASSERT_TRUE(stage->GetPrimAtPath(SdfPath("/relative")));
+  ASSERT_TRUE(stage->GetPrimAtPath(SdfPath("/absolute")));
+
+  AL::usdmaya::nodes::Layer* root = proxy->findLayer(stage->GetRootLayer());
+  AL::usdmaya::nodes::Layer* sub = proxy->findLayer(SdfLayer::Find(subLayerPath));
+  AL::usdmaya::nodes::Layer* relativeRef = proxy->findLayer(SdfLayer::Find(relativeRefPath));
+  AL::usdmaya::nodes::Layer* absoluteRef = proxy->findLayer(SdfLayer::Find(absoluteRefPath));
+  ASSERT_TRUE(root != nullptr);
+  ASSERT_TRUE(sub != nullptr);
+  ASSERT_TRUE(relativeRef != nullptr);
+  ASSERT_TRUE(absoluteRef != nullptr);
+
+  // each referenced layer is a child of the layer that references it
+  EXPECT_TRUE(sub->getParentLayer() == root);
+  EXPECT_TRUE(relativeRef->getParentLayer() == sub);
+  EXPECT_TRUE(absoluteRef->getParentLayer() == root);
+
+  auto children = root->getChildLayers();
+  EXPECT_TRUE(std::find(children.begin(), children.end(), absoluteRef) != children.end());
+  children = sub->getChildLayers();
+  ASSERT_EQ(1u, children.size());
+  EXPECT_TRUE(children[0] == relativeRef);
+
+  MFileIO::newFile(true);
+}
+
 //  static MString toMayaNodeName(std::string name);
 TEST(Layer, toMayaNodeName)
 {
@@ -0,0 +1,136 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+
+#include "maya/MFileIO.h"
+#include "maya/MFloatPointArray.h"
+#include "maya/MFnMesh.h"
+#include "maya/MGlobal.h"
+#include "maya/MIntArray.h"
+#include "maya/MPlug.h"
+#include "maya/MSelectionList.h"
+#include "maya/MStringArray.h"
+#include "maya/MTime.h"
+
+#include "AL/usdmaya/nodes/MeshAnimDeformer.h"
+
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/mesh.h"
+
+namespace {
+// a single triangle, translated along the x axis by the time code
+UsdStageRefPtr constructAnimatedTriangle(const double startTime, const double endTime)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomMesh mesh = UsdGeomMesh::Define(stage, SdfPath("/triangle"));
+
+  VtArray<int> counts(1, 3);
+  VtArray<int> indices(3);
+  indices[0] = 0;
+  indices[1] = 1;
+  indices[2] = 2;
+  mesh.GetFaceVertexCountsAttr().Set(counts);
+  mesh.GetFaceVertexIndicesAttr().Set(indices);
+
+  UsdAttribute pointsAttr = mesh.GetPointsAttr();
+  for(double t = startTime; t <= endTime; t += 1.0)
+  {
+    VtArray<GfVec3f> points(3);
+    points[0] = GfVec3f(t, 0, 0);
+    points[1] = GfVec3f(t + 1.0f, 0, 0);
+    points[2] = GfVec3f(t, 1.0f, 0);
+    pointsAttr.Set(points, UsdTimeCode(t));
+  }
+  return stage;
+}
+} // anon
+
+TEST(MeshAnimDeformer, pointCache)
+{
+  UsdStageRefPtr stage = constructAnimatedTriangle(1.0, 10.0);
+  AL::usdmaya::nodes::MeshPointCache cache;
+  cache.setCapacity(3);
+  cache.setMesh(UsdGeomMesh(stage->GetPrimAtPath(SdfPath("/triangle"))));
+
+  VtArray<GfVec3f> points;
+  EXPECT_TRUE(cache.fetch(UsdTimeCode(2.0), points));
+  ASSERT_EQ(3u, points.size());
+  EXPECT_EQ(GfVec3f(2.0f, 0, 0), points[0]);
+  EXPECT_EQ(1u, cache.size());
+
+  // prefetched frames outside of the authored range are ignored
+  cache.prefetch({3.0, 4.0, 11.0});
+  EXPECT_TRUE(cache.fetch(UsdTimeCode(3.0), points));
+  EXPECT_EQ(GfVec3f(3.0f, 0, 0), points[0]);
+  EXPECT_TRUE(cache.contains(4.0));
+  EXPECT_FALSE(cache.contains(11.0));
+
+  // the frame furthest from the current time is the first to be evicted
+  EXPECT_TRUE(cache.fetch(UsdTimeCode(5.0), points));
+  EXPECT_EQ(GfVec3f(5.0f, 0, 0), points[0]);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_FALSE(cache.contains(2.0));
+  EXPECT_TRUE(cache.contains(3.0));
+  EXPECT_TRUE(cache.contains(4.0));
+
+  cache.clear();
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(MeshAnimDeformer, deformMesh)
+{
+  MFileIO::newFile(true);
+
+  const std::string temp_path = "/tmp/AL_USDMayaTests_meshAnimDeformer.usda";
+  constructAnimatedTriangle(1.0, 10.0)->Export(temp_path, false);
+
+  MFloatPointArray points;
+  points.append(MFloatPoint(0, 0, 0));
+  points.append(MFloatPoint(1, 0, 0));
+  points.append(MFloatPoint(0, 1, 0));
+  MIntArray counts(1, 3);
+  MIntArray connects;
+  connects.append(0);
+  connects.append(1);
+  connects.append(2);
+
+  MFnMesh fnMesh;
+  MObject shape = fnMesh.create(3, 1, points, counts, connects);
+  ASSERT_FALSE(shape.isNull());
+
+  MStringArray result;
+  ASSERT_TRUE(MGlobal::executeCommand(MString("deformer -type AL_usdmaya_MeshAnimDeformer ") + fnMesh.fullPathName(), result));
+  ASSERT_EQ(1u, result.length());
+
+  MSelectionList sl;
+  MObject deformer;
+  sl.add(result[0]);
+  sl.getDependNode(0, deformer);
+  MPlug(deformer, AL::usdmaya::nodes::MeshAnimDeformer::filePath()).setString(temp_path.c_str());
+  MPlug(deformer, AL::usdmaya::nodes::MeshAnimDeformer::primPath()).setString("/triangle");
+
+  MPlug timePlug(deformer, AL::usdmaya::nodes::MeshAnimDeformer::inTime());
+  for(double t = 1.0; t <= 4.0; t += 1.0)
+  {
+    timePlug.setMTime(MTime(t, MTime::uiUnit()));
+    MFloatPointArray deformed;
+    fnMesh.getPoints(deformed);
+    ASSERT_EQ(3u, deformed.length());
+    EXPECT_NEAR(t, deformed[0].x, 1e-5f);
+    EXPECT_NEAR(t + 1.0, deformed[1].x, 1e-5f);
+    EXPECT_NEAR(1.0, deformed[2].y, 1e-5f);
+  }
+}
@@ -997,6 +997,60 @@ TEST(ProxyShape, basicTransformChainOperations2)
   }
 }
 
+// void mapPrimToMayaNode(const SdfPath& path, const MObject& node);
+// MObject primToMayaNode(const SdfPath& path) const;
+// SdfPath mayaNodeToPrim(const MObject& node) const;
+// void writeMayaPathsToSessionLayer();
+TEST(ProxyShape, primToMayaNodeIndex)
+{
+  MFileIO::newFile(true);
+  const std::string temp_path = "/tmp/AL_USDMayaTests_primToMayaNodeIndex.usda";
+  {
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    UsdGeomXform::Define(stage, SdfPath("/root/hip1"));
+    UsdGeomXform::Define(stage, SdfPath("/root/hip1/knee1"));
+    stage->Export(temp_path, false);
+  }
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+  proxy->filePathPlug().setString(temp_path.c_str());
+  auto stage = proxy->getUsdStage();
+
+  const SdfPath kneePath("/root/hip1/knee1");
+  UsdPrim kneePrim = stage->GetPrimAtPath(kneePath);
+  const TfToken mayaPathKey("MayaPath");
+
+  MDagModifier modifier1;
+  MDGModifier modifier2;
+  MObject leafNode = proxy->makeUsdTransforms(kneePrim, modifier1, AL::usdmaya::nodes::ProxyShape::kRequested, &modifier2);
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier1.doIt());
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier2.doIt());
+
+  // the mapping is held in memory, so the session layer should not have been modified
+  EXPECT_TRUE(proxy->primToMayaNode(kneePath) == leafNode);
+  EXPECT_EQ(kneePath, proxy->mayaNodeToPrim(leafNode));
+  EXPECT_TRUE(proxy->mayaNodeToPrim(xform).IsEmpty());
+  EXPECT_TRUE(kneePrim.GetCustomDataByKey(mayaPathKey).IsEmpty());
+
+  // which only happens on demand (i.e. before a save)
+  proxy->writeMayaPathsToSessionLayer();
+  MFnDagNode fnLeaf(leafNode);
+  VtValue mayaPath = kneePrim.GetCustomDataByKey(mayaPathKey);
+  EXPECT_TRUE(mayaPath.IsHolding<std::string>());
+  EXPECT_EQ(std::string(fnLeaf.fullPathName().asChar()), mayaPath.Get<std::string>());
+  EXPECT_TRUE(stage->GetSessionLayer()->GetPrimAtPath(kneePath));
+
+  // once the nodes have been deleted, they should no longer be found
+  MDagModifier modifier3;
+  proxy->removeUsdTransforms(kneePrim, modifier3, AL::usdmaya::nodes::ProxyShape::kRequested);
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier3.doIt());
+  EXPECT_TRUE(proxy->primToMayaNode(kneePath).isNull());
+}
+
 // void destroyTransformReferences()
 TEST(ProxyShape, destroyTransformReferences)
 {
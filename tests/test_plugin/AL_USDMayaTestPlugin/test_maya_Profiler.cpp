@@ -0,0 +1,189 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+
+#include "AL/maya/CodeTimings.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using AL::maya::Profiler;
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  reads the trace file, and returns the events it contains (each event is written on its own line)
+std::vector<std::string> readTraceEvents(const std::string& filePath, std::string* contents = 0)
+{
+  std::ifstream file(filePath.c_str());
+  std::stringstream ss;
+  ss << file.rdbuf();
+  if(contents)
+    *contents = ss.str();
+
+  std::vector<std::string> events;
+  std::string line;
+  while(std::getline(ss, line))
+  {
+    if(!line.empty() && line[0] == '{' && line.find("\"ph\":") != std::string::npos)
+    {
+      if(line.back() == ',')
+        line.pop_back();
+      events.push_back(line);
+    }
+  }
+  return events;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the numeric value of the specified field of a trace event
+double numericField(const std::string& event, const std::string& field)
+{
+  const std::string key = "\"" + field + "\":";
+  const size_t pos = event.find(key);
+  return pos == std::string::npos ? -1.0 : std::atof(event.c_str() + pos + key.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::string* findEvent(const std::vector<std::string>& events, const std::string& name)
+{
+  const std::string key = "{\"name\":\"" + name + "\"";
+  for(const std::string& event : events)
+  {
+    if(event.compare(0, key.size(), key) == 0)
+      return &event;
+  }
+  return nullptr;
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that the trace is written as a Chrome trace JSON file containing a complete event for each section
+//----------------------------------------------------------------------------------------------------------------------
+TEST(maya_Profiler, chromeTraceFormat)
+{
+  const std::string filePath = "/tmp/AL_USDMayaTests_profilerTrace.json";
+  std::remove(filePath.c_str());
+
+  Profiler::beginTrace();
+  EXPECT_TRUE(Profiler::isTracing());
+  AL_BEGIN_PROFILE_SECTION(ProfilerTestOuter);
+  AL_BEGIN_PROFILE_SECTION(ProfilerTestInner);
+  AL_PROFILE_SECTION_ARGUMENT(primPath, std::string("/root/\"quoted\"\tprim"));
+  AL_END_PROFILE_SECTION();
+  AL_END_PROFILE_SECTION();
+  EXPECT_TRUE(Profiler::endTrace(filePath));
+  EXPECT_FALSE(Profiler::isTracing());
+
+  std::string contents;
+  const std::vector<std::string> events = readTraceEvents(filePath, &contents);
+  EXPECT_EQ(0u, contents.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_EQ(contents.size() - 4, contents.rfind("\n]}\n"));
+  ASSERT_EQ(2u, events.size());
+
+  const std::string* outer = findEvent(events, "ProfilerTestOuter");
+  const std::string* inner = findEvent(events, "ProfilerTestInner");
+  ASSERT_TRUE(outer != nullptr);
+  ASSERT_TRUE(inner != nullptr);
+  for(const std::string* event : { outer, inner })
+  {
+    EXPECT_NE(std::string::npos, event->find("\"cat\":\"AL_USDMaya\",\"ph\":\"X\",\"pid\":1,"));
+    EXPECT_EQ('}', event->back());
+  }
+
+  // the argument is only attached to the inner section, and is escaped
+  EXPECT_EQ(std::string::npos, outer->find("\"args\""));
+  EXPECT_NE(std::string::npos, inner->find("\"args\":{\"primPath\":\"/root/\\\"quoted\\\"\\tprim\"}"));
+
+  // both sections ran on this thread, and the inner section lies within the outer one (times are in microseconds)
+  EXPECT_EQ(numericField(*outer, "tid"), numericField(*inner, "tid"));
+  EXPECT_LE(0.0, numericField(*outer, "ts"));
+  EXPECT_LE(numericField(*outer, "ts"), numericField(*inner, "ts"));
+  EXPECT_LE(numericField(*inner, "ts") + numericField(*inner, "dur"),
+            numericField(*outer, "ts") + numericField(*outer, "dur") + 0.002);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that the events recorded by each thread are merged into the trace, with a distinct tid per thread
+//----------------------------------------------------------------------------------------------------------------------
+TEST(maya_Profiler, traceMergesThreads)
+{
+  const std::string filePath = "/tmp/AL_USDMayaTests_profilerThreads.json";
+  const uint32_t numThreads = 4;
+  const uint32_t numSections = 100;
+
+  Profiler::beginTrace();
+  std::vector<std::thread> threads;
+  for(uint32_t i = 0; i < numThreads; ++i)
+  {
+    threads.emplace_back([]()
+    {
+      for(uint32_t j = 0; j < numSections; ++j)
+      {
+        AL_BEGIN_PROFILE_SECTION(ProfilerTestThread);
+        AL_END_PROFILE_SECTION();
+      }
+    });
+  }
+  for(auto& thread : threads)
+    thread.join();
+  EXPECT_TRUE(Profiler::endTrace(filePath));
+
+  const std::vector<std::string> events = readTraceEvents(filePath);
+  EXPECT_EQ(numThreads * numSections, events.size());
+  std::set<double> threadIds;
+  for(const std::string& event : events)
+    threadIds.insert(numericField(event, "tid"));
+  EXPECT_EQ(numThreads, threadIds.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that ending a trace that is not being recorded does not write a file, and that sections executed
+///         before the trace was started (or after it was cancelled) are not recorded.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(maya_Profiler, endWithoutTrace)
+{
+  const std::string filePath = "/tmp/AL_USDMayaTests_profilerNoTrace.json";
+  std::remove(filePath.c_str());
+
+  ASSERT_FALSE(Profiler::isTracing());
+  EXPECT_FALSE(Profiler::endTrace(filePath));
+  EXPECT_FALSE(std::ifstream(filePath.c_str()).good());
+
+  // cancelling discards the recorded events, so there is then nothing left to write
+  Profiler::beginTrace();
+  AL_BEGIN_PROFILE_SECTION(ProfilerTestCancelled);
+  AL_END_PROFILE_SECTION();
+  EXPECT_TRUE(Profiler::endTrace(std::string()));
+  EXPECT_FALSE(Profiler::endTrace(filePath));
+  EXPECT_FALSE(std::ifstream(filePath.c_str()).good());
+
+  // a section that was started before the trace is not part of it
+  AL_BEGIN_PROFILE_SECTION(ProfilerTestBeforeTrace);
+  Profiler::beginTrace();
+  AL_BEGIN_PROFILE_SECTION(ProfilerTestDuringTrace);
+  AL_END_PROFILE_SECTION();
+  AL_END_PROFILE_SECTION();
+  EXPECT_TRUE(Profiler::endTrace(filePath));
+
+  const std::vector<std::string> events = readTraceEvents(filePath);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_TRUE(findEvent(events, "ProfilerTestDuringTrace") != nullptr);
+}
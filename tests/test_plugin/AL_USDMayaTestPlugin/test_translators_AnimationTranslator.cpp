@@ -16,6 +16,7 @@
 #include "test_usdmaya.h"
 
 #include "AL/usdmaya/fileio/AnimationTranslator.h"
+#include "AL/usdmaya/fileio/ExportParams.h"
 
 #include "maya/MDGModifier.h"
 #include "maya/MDoubleArray.h"
@@ -28,7 +29,15 @@
 #include "maya/MPointArray.h"
 #include "maya/MSelectionList.h"
 
+#include "pxr/usd/sdf/attributeSpec.h"
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/xform.h"
+
 using AL::usdmaya::fileio::AnimationTranslator;
+using AL::usdmaya::fileio::ExporterParams;
+using AL::usdmaya::fileio::SampleFilter;
+using AL::usdmaya::fileio::UpstreamAnimationCache;
 
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  Test USD to attribute enum mappings
@@ -225,6 +234,62 @@ TEST(translators_AnimationTranslator, animationDrivenIndirectPlug)
   mod.doIt();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, sharedUpstreamCache)
+{
+  MFileIO::newFile(true);
+  setUp();
+  MStatus status;
+
+  // an animated network, and a static network, each shared by two plugs
+  MFnDependencyNode fnAnimated, fnStatic, fnb, fnc, fnd, fne;
+  MObject animatedSource = fnAnimated.create("addDoubleLinear", &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  MObject staticSource = fnStatic.create("addDoubleLinear", &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  MObject addDoubleLinearB = fnb.create("addDoubleLinear", &status);
+  MObject addDoubleLinearC = fnc.create("addDoubleLinear", &status);
+  MObject addDoubleLinearD = fnd.create("addDoubleLinear", &status);
+  MObject addDoubleLinearE = fne.create("addDoubleLinear", &status);
+
+  MFnAnimCurve fna;
+  MObject animCurve = fna.create(fnAnimated.findPlug("input1"), MFnAnimCurve::kAnimCurveTL, 0, &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fna.addKey(MTime(0.0), 1.0);
+  fna.addKey(MTime(2.0), 2.0);
+
+  MDGModifier mod;
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(m_outTime, fna.findPlug("input")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(fnAnimated.findPlug("output"), fnb.findPlug("input1")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(fnAnimated.findPlug("output"), fnc.findPlug("input1")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(fnStatic.findPlug("output"), fnd.findPlug("input1")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(fnStatic.findPlug("output"), fne.findPlug("input1")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.doIt());
+
+  UpstreamAnimationCache cache;
+  EXPECT_TRUE(AnimationTranslator::isAnimated(fnb.findPlug("input1"), true, &cache));
+  EXPECT_TRUE(AnimationTranslator::isAnimated(fnc.findPlug("input1"), true, &cache));
+  EXPECT_EQ(UpstreamAnimationCache::kAnimated, cache.find(animatedSource, UpstreamAnimationCache::kTimeOrExpression, true));
+
+  EXPECT_FALSE(AnimationTranslator::isAnimated(fnd.findPlug("input1"), true, &cache));
+  EXPECT_EQ(UpstreamAnimationCache::kStatic, cache.find(staticSource, UpstreamAnimationCache::kTimeOrExpression, true));
+  EXPECT_FALSE(AnimationTranslator::isAnimated(fne.findPlug("input1"), true, &cache));
+
+  // the queries are memoised independently
+  EXPECT_EQ(UpstreamAnimationCache::kUnknown, cache.find(staticSource, UpstreamAnimationCache::kTime, true));
+  cache.clear();
+  EXPECT_EQ(UpstreamAnimationCache::kUnknown, cache.find(staticSource, UpstreamAnimationCache::kTimeOrExpression, true));
+
+  mod.deleteNode(addDoubleLinearE);
+  mod.deleteNode(addDoubleLinearD);
+  mod.deleteNode(addDoubleLinearC);
+  mod.deleteNode(addDoubleLinearB);
+  mod.deleteNode(staticSource);
+  mod.deleteNode(animatedSource);
+  mod.deleteNode(animCurve);
+  mod.doIt();
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 TEST(translators_AnimationTranslator, expressionDrivenPlug)
 {
@@ -334,3 +399,247 @@ TEST(translators_AnimationTranslator, expressionDrivenIndirectPlugNoTimeInput)
   mod.deleteNode(expression);
   mod.doIt();
 }
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, sampleFilterRemovesConstantRuns)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/hello")).GetPrim();
+  UsdAttribute attr = prim.CreateAttribute(TfToken("value"), SdfValueTypeNames->Float);
+
+  // 0, 0, 0, 1, 2, 2, 2, 2
+  const float values[] = { 0.0f, 0.0f, 0.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f };
+  SampleFilter filter;
+  for(int i = 0; i < 8; ++i)
+  {
+    filter.addSample(attr, VtValue(values[i]), double(i));
+  }
+  filter.finish(attr);
+
+  // expect the first + last sample of the first run, the single sample at frame 3, and the start of the last run
+  std::vector<double> times;
+  attr.GetTimeSamples(&times);
+  ASSERT_EQ(4u, times.size());
+  EXPECT_EQ(0.0, times[0]);
+  EXPECT_EQ(2.0, times[1]);
+  EXPECT_EQ(3.0, times[2]);
+  EXPECT_EQ(4.0, times[3]);
+  for(int i = 0; i < 8; ++i)
+  {
+    float value;
+    EXPECT_TRUE(attr.Get(&value, double(i)));
+    EXPECT_EQ(values[i], value);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, sampleFilterCollapsesToDefault)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/hello")).GetPrim();
+  UsdAttribute attr = prim.CreateAttribute(TfToken("value"), SdfValueTypeNames->Float3);
+
+  // values that differ by less than the tolerance should be treated as constant
+  SampleFilter filter(true, 1e-3);
+  for(int i = 0; i < 8; ++i)
+  {
+    filter.addSample(attr, VtValue(GfVec3f(1.0f + i * 1e-5f, 2.0f, 3.0f)), double(i));
+  }
+  filter.finish(attr);
+
+  EXPECT_EQ(0u, attr.GetNumTimeSamples());
+  GfVec3f value;
+  EXPECT_TRUE(attr.Get(&value));
+  EXPECT_EQ(GfVec3f(1.0f, 2.0f, 3.0f), value);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that samples written within a change block are authored on the edit target, even when the attribute
+///         was defined in another layer, and that they are cast to the type of the attribute
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, sampleFilterAuthorsSpecInEditTarget)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/hello")).GetPrim();
+  UsdAttribute attr = prim.CreateAttribute(TfToken("value"), SdfValueTypeNames->Float);
+  stage->SetEditTarget(stage->GetSessionLayer());
+
+  SampleFilter filter;
+  {
+    SdfChangeBlock changeBlock;
+    for(int i = 0; i < 4; ++i)
+    {
+      filter.addSample(attr, VtValue(double(i)), double(i));
+    }
+    filter.finish(attr);
+  }
+
+  SdfAttributeSpecHandle spec = stage->GetSessionLayer()->GetAttributeAtPath(attr.GetPath());
+  ASSERT_TRUE(spec);
+  EXPECT_EQ(4u, stage->GetSessionLayer()->GetNumTimeSamplesForPath(attr.GetPath()));
+  EXPECT_EQ(0u, stage->GetRootLayer()->GetNumTimeSamplesForPath(attr.GetPath()));
+  for(int i = 0; i < 4; ++i)
+  {
+    float value;
+    EXPECT_TRUE(attr.Get(&value, double(i)));
+    EXPECT_EQ(float(i), value);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that plugs sampled directly from their anim curves export the same values as plugs sampled by changing
+///         the current time
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, curveSampledMatchesTimeStepped)
+{
+  MFileIO::newFile(true);
+  setUp();
+  MStatus status;
+
+  // transform A is driven directly by anim curves, and so is sampled from the curves. Transform B is driven by
+  // transform A, and so has to be sampled by changing the current time.
+  MFnTransform fnA, fnB;
+  MObject transformA = fnA.create();
+  MObject transformB = fnB.create();
+
+  MFnAnimCurve fnRotate;
+  MObject rotateCurve = fnRotate.create(fnA.findPlug("rx"), MFnAnimCurve::kAnimCurveTA, 0, &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fnRotate.addKey(MTime(0.0), 0.0);
+  fnRotate.addKey(MTime(5.0), 1.5);
+
+  MFnAnimCurve fnTranslate;
+  MObject translateCurve = fnTranslate.create(fnA.findPlug("ty"), MFnAnimCurve::kAnimCurveTL, 0, &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fnTranslate.addKey(MTime(0.0), -2.0);
+  fnTranslate.addKey(MTime(3.0), 4.0);
+  fnTranslate.addKey(MTime(5.0), 1.0);
+
+  // the other translate components are static
+  fnA.findPlug("tx").setValue(3.0);
+  fnA.findPlug("tz").setValue(-1.0);
+
+  MDGModifier mod;
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(m_outTime, fnRotate.findPlug("input")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(m_outTime, fnTranslate.findPlug("input")));
+  for(const char* name : { "rx", "tx", "ty", "tz" })
+  {
+    EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(fnA.findPlug(name), fnB.findPlug(name)));
+  }
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.doIt());
+
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/hello")).GetPrim();
+  UsdAttribute rotateA = prim.CreateAttribute(TfToken("rotateA"), SdfValueTypeNames->Float);
+  UsdAttribute rotateB = prim.CreateAttribute(TfToken("rotateB"), SdfValueTypeNames->Float);
+  UsdAttribute translateYA = prim.CreateAttribute(TfToken("translateYA"), SdfValueTypeNames->Double);
+  UsdAttribute translateYB = prim.CreateAttribute(TfToken("translateYB"), SdfValueTypeNames->Double);
+  UsdAttribute translateA = prim.CreateAttribute(TfToken("translateA"), SdfValueTypeNames->Float3);
+  UsdAttribute translateB = prim.CreateAttribute(TfToken("translateB"), SdfValueTypeNames->Float3);
+
+  const float radToDeg = 180.0f / 3.141592654f;
+  AnimationTranslator translator;
+  translator.addPlug(fnA.findPlug("rx"), rotateA, radToDeg, true);
+  translator.addPlug(fnB.findPlug("rx"), rotateB, radToDeg, true);
+  translator.addPlug(fnA.findPlug("ty"), translateYA, true);
+  translator.addPlug(fnB.findPlug("ty"), translateYB, true);
+  translator.addPlug(fnA.findPlug("t"), translateA, true);
+  translator.addPlug(fnB.findPlug("t"), translateB, true);
+
+  ExporterParams params;
+  params.m_minFrame = 0.0;
+  params.m_maxFrame = 5.0;
+  translator.exportAnimation(params);
+
+  for(int frame = 0; frame <= 5; ++frame)
+  {
+    const UsdTimeCode time(frame);
+    float fa = 0, fb = 0;
+    EXPECT_TRUE(rotateA.Get(&fa, time));
+    EXPECT_TRUE(rotateB.Get(&fb, time));
+    EXPECT_NEAR(fb, fa, 1e-4f);
+
+    double da = 0, db = 0;
+    EXPECT_TRUE(translateYA.Get(&da, time));
+    EXPECT_TRUE(translateYB.Get(&db, time));
+    EXPECT_NEAR(db, da, 1e-6);
+
+    GfVec3f va, vb;
+    EXPECT_TRUE(translateA.Get(&va, time));
+    EXPECT_TRUE(translateB.Get(&vb, time));
+    EXPECT_NEAR(vb[0], va[0], 1e-5f);
+    EXPECT_NEAR(vb[1], va[1], 1e-5f);
+    EXPECT_NEAR(vb[2], va[2], 1e-5f);
+  }
+
+  // and the values sampled from the curves are in the exported units
+  float rotate = 0;
+  EXPECT_TRUE(rotateA.Get(&rotate, UsdTimeCode(5.0)));
+  EXPECT_NEAR(1.5f * radToDeg, rotate, 1e-4f);
+  GfVec3f translate;
+  EXPECT_TRUE(translateA.Get(&translate, UsdTimeCode(3.0)));
+  EXPECT_NEAR(3.0f, translate[0], 1e-5f);
+  EXPECT_NEAR(4.0f, translate[1], 1e-5f);
+  EXPECT_NEAR(-1.0f, translate[2], 1e-5f);
+
+  mod.deleteNode(rotateCurve);
+  mod.deleteNode(translateCurve);
+  mod.deleteNode(transformB);
+  mod.deleteNode(transformA);
+  mod.doIt();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that a curve driven by a time node other than time1 (which may be offset from the current time) is
+///         not sampled directly from the curve
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, curveDrivenByOtherTimeNode)
+{
+  MFileIO::newFile(true);
+  setUp();
+  MStatus status;
+
+  MFnDependencyNode fnAdd;
+  MObject addDoubleLinear1 = fnAdd.create("addDoubleLinear", &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+
+  MFnDependencyNode fnTime;
+  MObject otherTime = fnTime.create("time", &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fnTime.findPlug("outTime").setValue(MTime(4.0));
+
+  MFnAnimCurve fna;
+  MObject animCurve = fna.create(fnAdd.findPlug("input1"), MFnAnimCurve::kAnimCurveTL, 0, &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fna.addKey(MTime(0.0), 0.0);
+  fna.addKey(MTime(4.0), 8.0);
+
+  MDGModifier mod;
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.connect(fnTime.findPlug("outTime"), fna.findPlug("input")));
+  EXPECT_EQ(MStatus(MS::kSuccess), mod.doIt());
+
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/hello")).GetPrim();
+  UsdAttribute attr = prim.CreateAttribute(TfToken("value"), SdfValueTypeNames->Double);
+
+  AnimationTranslator translator;
+  translator.addPlug(fnAdd.findPlug("input1"), attr, true);
+
+  ExporterParams params;
+  params.m_minFrame = 0.0;
+  params.m_maxFrame = 2.0;
+  translator.exportAnimation(params);
+
+  // the curve is evaluated at the time of the other time node, not at the exported frame
+  for(int frame = 0; frame <= 2; ++frame)
+  {
+    double value = 0;
+    EXPECT_TRUE(attr.Get(&value, UsdTimeCode(frame)));
+    EXPECT_NEAR(fnAdd.findPlug("input1").asDouble(), value, 1e-6);
+  }
+
+  mod.deleteNode(animCurve);
+  mod.deleteNode(otherTime);
+  mod.deleteNode(addDoubleLinear1);
+  mod.doIt();
+}
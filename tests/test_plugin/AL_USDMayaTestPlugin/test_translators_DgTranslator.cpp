@@ -20,6 +20,7 @@
 #include "AL/usdmaya/fileio/translators/DgNodeTranslator.h"
 
 #include "maya/MAngle.h"
+#include "maya/MDoubleArray.h"
 #include "maya/MDGModifier.h"
 #include "maya/MFloatMatrix.h"
 #include "maya/MFloatPoint.h"
@@ -27,14 +28,17 @@
 #include "maya/MFnAttribute.h"
 #include "maya/MFnData.h"
 #include "maya/MFnDependencyNode.h"
+#include "maya/MFnDoubleArrayData.h"
 #include "maya/MFnMatrixAttribute.h"
 #include "maya/MFnMatrixData.h"
 #include "maya/MFnNumericAttribute.h"
 #include "maya/MFnNumericData.h"
 #include "maya/MFnTypedAttribute.h"
 #include "maya/MFnUnitAttribute.h"
+#include "maya/MFnAnimCurve.h"
 #include "maya/MLibrary.h"
 #include "maya/MMatrix.h"
+#include "maya/MPlugArray.h"
 #include "maya/MPoint.h"
 #include "maya/MStatus.h"
 #include "maya/MTime.h"
@@ -42,6 +46,7 @@
 
 #include "pxr/usd/sdf/types.h"
 #include "pxr/usd/usd/attribute.h"
+#include "pxr/usd/usd/stage.h"
 #include "pxr/usd/usdGeom/xform.h"
 #include "pxr/usd/usdGeom/xformCommonAPI.h"
 
@@ -1732,6 +1737,53 @@ TEST(translators_DgNodeTranslator, quatd_test)
   EXPECT_EQ(orig[3], result[3]);
 }
 
+TEST(translators_DgNodeTranslator, typedArrayDataTest)
+{
+  setUp();
+  MFnDependencyNode fn;
+  MObject node = fn.create("transform");
+
+  MDoubleArray orig;
+  for(uint32_t i = 0; i < SIZE; ++i)
+  {
+    orig.append(randDouble());
+  }
+  MFnDoubleArrayData fnData;
+  MObject data = fnData.create(orig);
+  MFnTypedAttribute fnAttr;
+  MObject attr = fnAttr.create("typedDoubleArray", "tda", MFnData::kDoubleArray, data);
+  EXPECT_EQ(MStatus(MS::kSuccess), fn.addAttribute(attr));
+
+  // the typed array should be exported as a single array attribute
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/typed")).GetPrim();
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::copyDynamicAttributes(node, prim));
+  UsdAttribute usdAttr = prim.GetAttribute(TfToken("typedDoubleArray"));
+  EXPECT_TRUE(usdAttr.IsValid());
+  EXPECT_TRUE(usdAttr.IsCustom());
+  EXPECT_EQ(SdfValueTypeNames->DoubleArray, usdAttr.GetTypeName());
+  VtArray<double> value;
+  EXPECT_TRUE(usdAttr.Get(&value));
+  EXPECT_EQ(orig.length(), value.size());
+  for(uint32_t i = 0; i < value.size(); ++i)
+  {
+    EXPECT_EQ(orig[i], value[i]);
+  }
+
+  // ... and be set back onto the typed attribute in one go
+  MPlug plug(node, attr);
+  EXPECT_EQ(MStatus(MS::kSuccess), plug.setValue(MFnDoubleArrayData().create(MDoubleArray())));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setArrayMayaValue(node, attr, usdAttr, AL::usdmaya::UsdDataType::kDouble));
+  MDoubleArray result = MFnDoubleArrayData(plug.asMObject()).array();
+  EXPECT_EQ(orig.length(), result.length());
+  for(uint32_t i = 0; i < result.length(); ++i)
+  {
+    EXPECT_EQ(orig[i], result[i]);
+  }
+
+  MGlobal::deleteNode(node);
+}
+
 // !!! THIS TEST MUST BE EXECUTED LAST !!!
 TEST(translators_DgNodeTranslator, dynamicAttributesTest)
 {
@@ -1799,5 +1851,46 @@ TEST(translators_DgNodeTranslator, dynamicAttributesTest)
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_DgNodeTranslator, setFloatAttrAnim)
+{
+  setUp();
+  const char* const longName = "longAnimFloatName";
+  const char* const shortName = "lafn";
+  const uint32_t flags = kCached | kReadable | kWritable | kStorable | kConnectable | kKeyable;
+  EXPECT_EQ(MStatus(MS::kSuccess), NodeHelper::addFloatAttr(m_node, longName, shortName, 0.0f, flags));
+
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = stage->DefinePrim(SdfPath("/node"));
+  UsdAttribute usdAttr = prim.CreateAttribute(TfToken("value"), SdfValueTypeNames->Float);
+  const uint32_t numFrames = 100;
+  for(uint32_t i = 0; i < numFrames; ++i)
+  {
+    usdAttr.Set(float(i) * 0.5f, UsdTimeCode(i + 1));
+  }
+
+  // a double attribute should be cast on read
+  UsdAttribute usdDoubleAttr = prim.CreateAttribute(TfToken("doubleValue"), SdfValueTypeNames->Double);
+  usdDoubleAttr.Set(2.0, UsdTimeCode(1.0));
+  usdDoubleAttr.Set(4.0, UsdTimeCode(2.0));
+  MTimeArray times;
+  std::vector<float> values;
+  EXPECT_TRUE(DgNodeTranslator::readTimeSamples(usdDoubleAttr, times, values));
+  ASSERT_EQ(2u, times.length());
+  ASSERT_EQ(2u, values.size());
+  EXPECT_EQ(2.0f, values[0]);
+  EXPECT_EQ(4.0f, values[1]);
 
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setFloatAttrAnim(m_node, findAttribute(longName), usdAttr, 2.0));
 
+  MPlugArray connections;
+  MPlug(m_node, findAttribute(longName)).connectedTo(connections, true, false);
+  ASSERT_EQ(1u, connections.length());
+  MFnAnimCurve fnCurve(connections[0].node());
+  ASSERT_EQ(numFrames, fnCurve.numKeys());
+  for(uint32_t i = 0; i < numFrames; ++i)
+  {
+    EXPECT_NEAR(double(i + 1), fnCurve.time(i).as(MTime::kFilm), 1e-5);
+    EXPECT_NEAR(double(i), fnCurve.value(i), 1e-5);
+  }
+}
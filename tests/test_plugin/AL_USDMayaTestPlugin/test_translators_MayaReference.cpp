@@ -0,0 +1,166 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+#include "AL/usdmaya/nodes/ProxyShape.h"
+
+#include "maya/MFileIO.h"
+#include "maya/MFnDagNode.h"
+#include "maya/MGlobal.h"
+#include "maya/MSelectionList.h"
+#include "maya/MStringArray.h"
+
+#include <fstream>
+
+namespace {
+const char* const g_batchedReferences =
+"#usda 1.0\n"
+"\n"
+"def Xform \"root\"\n"
+"{\n"
+"    def ALMayaReference \"rigA\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"batchA\"\n"
+"    }\n"
+"    def ALMayaReference \"rigB\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"batchB\"\n"
+"    }\n"
+"    def ALMayaReference \"rigC\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"batchC\"\n"
+"    }\n"
+"}\n";
+
+const char* const g_failedReference =
+"#usda 1.0\n"
+"\n"
+"def Xform \"root\"\n"
+"{\n"
+"    def ALMayaReference \"broken\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_broken.ma\"\n"
+"      string mayaNamespace = \"broken\"\n"
+"    }\n"
+"    def ALMayaReference \"good\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"good\"\n"
+"    }\n"
+"}\n";
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  writes out the maya files referenced by the tests, and a usda file containing the ALMayaReference prims
+void writeTestFiles(const char* const usdaPath, const char* const usdaContents)
+{
+  MFileIO::newFile(true);
+
+  // pCube1, pCubeShape1, polyCube1
+  MGlobal::executeCommand("polyCube -w 1 -h 1 -d 1 -sd 1 -sh 1 -sw 1", false, false);
+  MFileIO::saveAs("/tmp/AL_usdmaya_test_cube.ma", 0, true);
+  MFileIO::newFile(true);
+
+  // a maya file that errors as it is read
+  {
+    std::ofstream os("/tmp/AL_usdmaya_test_broken.ma");
+    os << "//Maya ASCII 2017 scene\n"
+          "error \"AL_usdmaya_test_broken.ma cannot be loaded\";\n";
+  }
+  {
+    std::ofstream os(usdaPath);
+    os << usdaContents;
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns true if the node specified is a child of the transform created for the prim
+bool isChildOfPrim(AL::usdmaya::nodes::ProxyShape* proxy, const char* const nodeName, const char* const primPath)
+{
+  MSelectionList sl;
+  MDagPath path;
+  if(!sl.add(nodeName) || !sl.getDagPath(0, path))
+    return false;
+  MObject primTransform = proxy->findRequiredPath(SdfPath(primPath));
+  return !primTransform.isNull() && MFnDagNode(path).parent(0) == primTransform;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the number of temporary reference groups left in the scene
+uint32_t countTempGroups()
+{
+  MStringArray tempGroups;
+  MGlobal::executeCommand("ls \"__temp_reference_group_*\"", tempGroups);
+  return tempGroups.length();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+AL::usdmaya::nodes::ProxyShape* createProxyShape(const char* const usdaPath)
+{
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+
+  // force the stage to load
+  proxy->filePathPlug().setString(usdaPath);
+  return proxy;
+}
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that the references of a batch of ALMayaReference prims are all loaded, and that the contents of each
+///         reference end up beneath the transform of its own prim
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_MayaReference, batchedReferences)
+{
+  writeTestFiles("/tmp/AL_usdmaya_batchedReferences.usda", g_batchedReferences);
+  AL::usdmaya::nodes::ProxyShape* proxy = createProxyShape("/tmp/AL_usdmaya_batchedReferences.usda");
+  ASSERT_TRUE(proxy->getUsdStage());
+
+  EXPECT_TRUE(isChildOfPrim(proxy, "batchA:pCube1", "/root/rigA"));
+  EXPECT_TRUE(isChildOfPrim(proxy, "batchB:pCube1", "/root/rigB"));
+  EXPECT_TRUE(isChildOfPrim(proxy, "batchC:pCube1", "/root/rigC"));
+
+  MStringArray references;
+  MGlobal::executeCommand("file -q -reference", references);
+  EXPECT_EQ(3u, references.length());
+  EXPECT_EQ(0u, countTempGroups());
+
+  MFileIO::newFile(true);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that a reference that fails to load does not prevent the other references in the batch from loading,
+///         and that it is removed from the scene rather than left behind
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_MayaReference, failedReferenceIsRemoved)
+{
+  writeTestFiles("/tmp/AL_usdmaya_failedReference.usda", g_failedReference);
+  AL::usdmaya::nodes::ProxyShape* proxy = createProxyShape("/tmp/AL_usdmaya_failedReference.usda");
+  ASSERT_TRUE(proxy->getUsdStage());
+
+  EXPECT_TRUE(isChildOfPrim(proxy, "good:pCube1", "/root/good"));
+
+  MStringArray references;
+  MGlobal::executeCommand("file -q -reference", references);
+  ASSERT_EQ(1u, references.length());
+  EXPECT_NE(-1, references[0].indexW("AL_usdmaya_test_cube.ma"));
+  EXPECT_EQ(0u, countTempGroups());
+
+  MFileIO::newFile(true);
+}
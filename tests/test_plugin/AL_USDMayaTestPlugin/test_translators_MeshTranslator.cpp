@@ -17,6 +17,7 @@
 
 #include "AL/maya/NodeHelper.h"
 #include "AL/usdmaya/fileio/ImportParams.h"
+#include "AL/usdmaya/fileio/translators/MeshKernels.h"
 #include "AL/usdmaya/fileio/translators/MeshTranslator.h"
 
 
@@ -130,6 +131,26 @@ TEST(translators_MeshTranslator, isUvSetDataSparse)
   EXPECT_TRUE(isUvSetDataSparse(uvCounts.data(), uvCounts.size()));
 }
 
+TEST(translators_MeshTranslator, sparseUvIndices)
+{
+  // a triangle, an unmapped quad, a quad, and an unmapped triangle
+  const std::vector<int32_t> polyCounts = { 3, 4, 4, 3 };
+  const std::vector<int32_t> uvCounts = { 3, 0, 4, 0 };
+  const std::vector<int32_t> uvIds = { 0, 1, 2, 3, 4, 5, 6 };
+  const int32_t unassigned = 7;
+
+  std::vector<int32_t> indices(14);
+  expandSparseUvIndices(indices.data(), polyCounts.data(), uvCounts.data(), uvIds.data(), 4, unassigned);
+  const std::vector<int32_t> expected = { 0, 1, 2, 7, 7, 7, 7, 3, 4, 5, 6, 7, 7, 7 };
+  EXPECT_EQ(expected, indices);
+
+  std::vector<int32_t> counts(polyCounts), ids(indices.size());
+  EXPECT_EQ(7u, compactSparseUvIndices(counts.data(), ids.data(), indices.data(), 4, unassigned));
+  EXPECT_EQ(uvCounts, counts);
+  ids.resize(7);
+  EXPECT_EQ(uvIds, ids);
+}
+
 TEST(translators_MeshTranslator, generateIncrementingIndices)
 {
   MIntArray indices;
@@ -141,3 +162,71 @@ TEST(translators_MeshTranslator, generateIncrementingIndices)
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Each of the SIMD kernel tables compiled into the plugin (and runnable on this CPU) must match the scalar
+///         kernels, for all of the remainder cases.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_MeshTranslator, simdKernelsMatchScalar)
+{
+  using AL::maya::SimdLevel;
+  const MeshKernels* scalar = meshKernels(SimdLevel::kScalar);
+  ASSERT_TRUE(scalar != nullptr);
+
+  for(uint32_t level = uint32_t(SimdLevel::kSSE3); level <= uint32_t(AL::maya::hostSimdLevel()); ++level)
+  {
+    const MeshKernels* kernels = meshKernels(SimdLevel(level));
+    if(!kernels)
+      continue;
+
+    for(uint32_t count = 0; count < 35; ++count)
+    {
+      std::vector<float> points(count * 3), u(count), v(count);
+      std::vector<int32_t> indices(count), uvCounts(count, 1);
+      for(uint32_t i = 0; i < count; ++i)
+      {
+        points[i * 3] = float(i);
+        points[i * 3 + 1] = float(i) + 0.25f;
+        points[i * 3 + 2] = float(i) + 0.5f;
+        u[i] = float(i) * 2.0f;
+        v[i] = float(i) * 2.0f + 1.0f;
+        indices[i] = (i * 7) % count;
+      }
+
+      std::vector<float> expected4(count * 4), result4(count * 4);
+      scalar->convert3DArrayTo4DArray(points.data(), expected4.data(), count);
+      kernels->convert3DArrayTo4DArray(points.data(), result4.data(), count);
+      EXPECT_EQ(expected4, result4);
+
+      std::vector<double> expectedDouble(count * 3), resultDouble(count * 3);
+      scalar->convertFloatVec3ArrayToDoubleVec3Array(points.data(), expectedDouble.data(), count);
+      kernels->convertFloatVec3ArrayToDoubleVec3Array(points.data(), resultDouble.data(), count);
+      EXPECT_EQ(expectedDouble, resultDouble);
+
+      std::vector<double> expectedDouble4(count * 4), resultDouble4(count * 4);
+      scalar->convert3DFloatArrayTo4DDoubleArray(points.data(), expectedDouble4.data(), count);
+      kernels->convert3DFloatArrayTo4DDoubleArray(points.data(), resultDouble4.data(), count);
+      EXPECT_EQ(expectedDouble4, resultDouble4);
+
+      std::vector<float> expectedUV(count * 2), resultUV(count * 2), u2(count), v2(count);
+      scalar->zipUVs(u.data(), v.data(), expectedUV.data(), count);
+      kernels->zipUVs(u.data(), v.data(), resultUV.data(), count);
+      EXPECT_EQ(expectedUV, resultUV);
+
+      kernels->unzipUVs(resultUV.data(), u2.data(), v2.data(), count);
+      EXPECT_EQ(u, u2);
+      EXPECT_EQ(v, v2);
+
+      scalar->interleaveIndexedUvData(expectedUV.data(), u.data(), v.data(), indices.data(), count);
+      kernels->interleaveIndexedUvData(resultUV.data(), u.data(), v.data(), indices.data(), count);
+      EXPECT_EQ(expectedUV, resultUV);
+
+      EXPECT_FALSE(kernels->isUvSetDataSparse(uvCounts.data(), count));
+      for(uint32_t i = 0; i < count; ++i)
+      {
+        uvCounts[i] = 0;
+        EXPECT_TRUE(kernels->isUvSetDataSparse(uvCounts.data(), count));
+        uvCounts[i] = 1;
+      }
+    }
+  }
+}
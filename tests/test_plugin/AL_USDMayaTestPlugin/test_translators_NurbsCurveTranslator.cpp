@@ -23,6 +23,7 @@
 
 #include "maya/MDagModifier.h"
 #include "maya/MDoubleArray.h"
+#include "maya/MFileIO.h"
 #include "maya/MFnDagNode.h"
 #include "maya/MFnNurbsCurve.h"
 #include "maya/MFnTransform.h"
@@ -30,6 +31,7 @@
 
 #include "pxr/usd/usd/attribute.h"
 #include "pxr/usd/usdGeom/camera.h"
+#include "pxr/usd/usdGeom/nurbsCurves.h"
 
 using AL::usdmaya::fileio::ExporterParams;
 using AL::usdmaya::fileio::ImporterParams;
@@ -218,3 +220,60 @@ TEST(translators_NurbsCurveTranslator, test_io)
   }
 }
 #endif
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that a prim containing many curves is imported as one shape per curve
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_NurbsCurveTranslator, multipleCurves)
+{
+  MFileIO::newFile(true);
+
+  const uint32_t numCurves = 50;
+  const int32_t numPoints = 6;
+  const int32_t order = 4;
+  const int32_t numKnots = numPoints + order - 2;
+
+  VtArray<int32_t> counts(numCurves, numPoints);
+  VtArray<int32_t> orders(numCurves, order);
+  VtArray<GfVec3f> points(numCurves * numPoints);
+  VtArray<double> knots(numCurves * numKnots);
+  for(uint32_t i = 0; i < numCurves; ++i)
+  {
+    for(int32_t j = 0; j < numPoints; ++j)
+    {
+      points[i * numPoints + j] = GfVec3f(float(i), float(j), float(i + j));
+    }
+    const double curveKnots[numKnots] = { 0, 0, 0, 1, 2, 3, 3, 3 };
+    std::copy(curveKnots, curveKnots + numKnots, knots.data() + i * numKnots);
+  }
+
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomNurbsCurves curves = UsdGeomNurbsCurves::Define(stage, SdfPath("/guides"));
+  curves.GetCurveVertexCountsAttr().Set(counts);
+  curves.GetOrderAttr().Set(orders);
+  curves.GetPointsAttr().Set(points);
+  curves.GetKnotsAttr().Set(knots);
+
+  MFnTransform fnx;
+  MObject xform = fnx.create();
+
+  ImporterParams params;
+  NurbsCurveTranslator xlator;
+  EXPECT_TRUE(MObject::kNullObj != xlator.createNode(curves.GetPrim(), xform, "nurbsCurve", params));
+
+  ASSERT_EQ(numCurves, fnx.childCount());
+  for(uint32_t i = 0; i < numCurves; ++i)
+  {
+    MFnNurbsCurve fnCurve(fnx.child(i));
+    EXPECT_EQ(order - 1, fnCurve.degree());
+    MPointArray cvs;
+    fnCurve.getCVs(cvs);
+    ASSERT_EQ(uint32_t(numPoints), cvs.length());
+    for(int32_t j = 0; j < numPoints; ++j)
+    {
+      EXPECT_NEAR(points[i * numPoints + j][0], cvs[j].x, 1e-5);
+      EXPECT_NEAR(points[i * numPoints + j][1], cvs[j].y, 1e-5);
+      EXPECT_NEAR(points[i * numPoints + j][2], cvs[j].z, 1e-5);
+    }
+  }
+}
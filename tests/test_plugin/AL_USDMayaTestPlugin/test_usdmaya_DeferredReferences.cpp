@@ -0,0 +1,137 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+#include "AL/usdmaya/DeferredReferences.h"
+#include "AL/usdmaya/nodes/ProxyShape.h"
+
+#include "maya/MFileIO.h"
+#include "maya/MFnDagNode.h"
+#include "maya/MGlobal.h"
+#include "maya/MSelectionList.h"
+
+#include "pxr/base/arch/fileSystem.h"
+
+#include <fstream>
+
+using AL::usdmaya::DeferredReferences;
+
+namespace {
+const char* const g_deferredReferences =
+"#usda 1.0\n"
+"\n"
+"def Xform \"root\"\n"
+"{\n"
+"    def ALMayaReference \"rigA\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"deferredA\"\n"
+"    }\n"
+"    def ALMayaReference \"rigB\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"deferredB\"\n"
+"    }\n"
+"    def ALMayaReference \"rigC\"\n"
+"    {\n"
+"      asset mayaReference = \"/tmp/AL_usdmaya_test_cube.ma\"\n"
+"      string mayaNamespace = \"deferredC\"\n"
+"    }\n"
+"}\n";
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that deferred references are created unloaded, that the least recently used references are unloaded
+///         to keep within the memory budget, and that references loaded or unloaded outside of DeferredReferences are
+///         accounted for.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_DeferredReferences, memoryBudget)
+{
+  MFileIO::newFile(true);
+
+  // pCube1, pCubeShape1, polyCube1
+  MGlobal::executeCommand("polyCube -w 1 -h 1 -d 1 -sd 1 -sh 1 -sw 1", false, false);
+  MFileIO::saveAs("/tmp/AL_usdmaya_test_cube.ma", 0, true);
+  MFileIO::newFile(true);
+  {
+    std::ofstream os("/tmp/AL_usdmaya_deferredReferences.usda");
+    os << g_deferredReferences;
+  }
+  const size_t referenceSize = size_t(ArchGetFileLength("/tmp/AL_usdmaya_test_cube.ma"));
+  ASSERT_TRUE(referenceSize > 0);
+
+  const bool wasEnabled = DeferredReferences::enabled();
+  const size_t previousBudget = DeferredReferences::memoryBudget();
+  DeferredReferences::setEnabled(true);
+  DeferredReferences::setMemoryBudget(0);
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+  proxy->filePathPlug().setString("/tmp/AL_usdmaya_deferredReferences.usda");
+  ASSERT_TRUE(proxy->getUsdStage());
+
+  const MObject rigA = proxy->findRequiredPath(SdfPath("/root/rigA"));
+  const MObject rigB = proxy->findRequiredPath(SdfPath("/root/rigB"));
+  const MObject rigC = proxy->findRequiredPath(SdfPath("/root/rigC"));
+  ASSERT_TRUE(DeferredReferences::isTracked(rigA));
+  ASSERT_TRUE(DeferredReferences::isTracked(rigB));
+  ASSERT_TRUE(DeferredReferences::isTracked(rigC));
+
+  // nothing is loaded until it is needed
+  EXPECT_FALSE(DeferredReferences::isLoaded(rigA));
+  EXPECT_FALSE(DeferredReferences::isLoaded(rigB));
+  EXPECT_FALSE(DeferredReferences::isLoaded(rigC));
+  EXPECT_EQ(0u, DeferredReferences::loadedSize());
+
+  // a budget that fits a single reference
+  DeferredReferences::setMemoryBudget(referenceSize);
+  EXPECT_EQ(MS::kSuccess, DeferredReferences::load(rigA));
+  EXPECT_TRUE(DeferredReferences::isLoaded(rigA));
+  EXPECT_EQ(referenceSize, DeferredReferences::loadedSize());
+
+  // loading a second reference unloads the least recently used one
+  EXPECT_EQ(MS::kSuccess, DeferredReferences::load(rigB));
+  EXPECT_FALSE(DeferredReferences::isLoaded(rigA));
+  EXPECT_TRUE(DeferredReferences::isLoaded(rigB));
+  EXPECT_EQ(referenceSize, DeferredReferences::loadedSize());
+
+  // a reference loaded directly (e.g. from the reference editor) is still charged against the budget
+  MSelectionList sl;
+  MObject referenceA;
+  ASSERT_TRUE(sl.add("deferredARN"));
+  ASSERT_TRUE(sl.getDependNode(0, referenceA));
+  MStatus status;
+  MFileIO::loadReferenceByNode(referenceA, &status);
+  ASSERT_TRUE(status);
+  EXPECT_TRUE(DeferredReferences::isLoaded(rigA));
+  EXPECT_EQ(2 * referenceSize, DeferredReferences::loadedSize());
+
+  // it is also the most recently used, so trimming to the budget unloads the other reference
+  DeferredReferences::trimToBudget();
+  EXPECT_TRUE(DeferredReferences::isLoaded(rigA));
+  EXPECT_FALSE(DeferredReferences::isLoaded(rigB));
+  EXPECT_EQ(referenceSize, DeferredReferences::loadedSize());
+
+  MFileIO::unloadReferenceByNode(referenceA, &status);
+  ASSERT_TRUE(status);
+  EXPECT_FALSE(DeferredReferences::isLoaded(rigA));
+  EXPECT_EQ(0u, DeferredReferences::loadedSize());
+
+  DeferredReferences::setEnabled(wasEnabled);
+  DeferredReferences::setMemoryBudget(previousBudget);
+  MFileIO::newFile(true);
+}
@@ -0,0 +1,217 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+
+#include "AL/usdmaya/PayloadStreamer.h"
+
+#include "pxr/usd/sdf/layer.h"
+#include "pxr/usd/sdf/payload.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/mesh.h"
+#include "pxr/usd/usdGeom/xform.h"
+
+using namespace AL::usdmaya;
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  constructs a stage (opened unloaded) containing the prims /world/a, /world/b and /world/c, each of which has
+///         a payload to the same asset
+/// \param  asset returns the stage holding the (anonymous) asset layer, which must be kept alive while the payloads
+///         are in use
+//----------------------------------------------------------------------------------------------------------------------
+UsdStageRefPtr constructStageWithPayloads(UsdStageRefPtr& asset)
+{
+  asset = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(asset, SdfPath("/asset"));
+  UsdGeomXform::Define(asset, SdfPath("/asset/geo"));
+
+  UsdStageRefPtr world = UsdStage::CreateInMemory();
+  for(const char* name : { "/world/a", "/world/b", "/world/c" })
+  {
+    UsdPrim prim = UsdGeomXform::Define(world, SdfPath(name)).GetPrim();
+    prim.SetPayload(SdfPayload(asset->GetRootLayer()->GetIdentifier(), SdfPath("/asset")));
+  }
+  return UsdStage::Open(world->GetRootLayer(), UsdStage::LoadNone);
+}
+
+const SdfPath a("/world/a");
+const SdfPath b("/world/b");
+const SdfPath c("/world/c");
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that without a budget every requested payload is loaded, in a single round
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_PayloadStreamer, unlimitedBudget)
+{
+  UsdStageRefPtr asset;
+  UsdStageRefPtr stage = constructStageWithPayloads(asset);
+  ASSERT_TRUE(stage->GetLoadSet().empty());
+
+  PayloadStreamer streamer;
+  streamer.setCostEstimator([](const UsdPrim&) { return size_t(100); });
+  streamer.setStage(stage);
+
+  // paths that are not payloads are ignored
+  PayloadStreamer::Priorities priorities = { {a, 0.0}, {b, 0.0}, {c, 0.0}, {SdfPath("/world"), 1.0} };
+  EXPECT_TRUE(streamer.update(priorities));
+  EXPECT_EQ(3u, stage->GetLoadSet().size());
+  EXPECT_TRUE(stage->GetPrimAtPath(SdfPath("/world/b/geo")));
+  EXPECT_EQ(300u, streamer.loadedCost());
+
+  // nothing left to do
+  EXPECT_FALSE(streamer.update(priorities));
+
+  // payloads unloaded by someone else are no longer counted
+  stage->Unload(b);
+  EXPECT_FALSE(streamer.update(PayloadStreamer::Priorities()));
+  EXPECT_EQ(200u, streamer.loadedCost());
+  EXPECT_EQ(0u, streamer.cost(b));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that payloads are loaded in priority order within the budget, and the least recently used are unloaded
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_PayloadStreamer, budget)
+{
+  UsdStageRefPtr asset;
+  UsdStageRefPtr stage = constructStageWithPayloads(asset);
+
+  PayloadStreamer streamer;
+  streamer.setCostEstimator([](const UsdPrim&) { return size_t(100); });
+  streamer.setBudget(250);
+  streamer.setStage(stage);
+
+  // with nothing loaded there is nothing to predict the cost from, so only the highest priority payload is loaded
+  PayloadStreamer::Priorities priorities = { {c, 1.0}, {b, 2.0}, {a, 3.0} };
+  EXPECT_TRUE(streamer.update(priorities));
+  EXPECT_EQ(SdfPathSet({a}), stage->GetLoadSet());
+
+  // after which the payloads are predicted to cost 100 each, so one more fits
+  EXPECT_TRUE(streamer.update(priorities));
+  EXPECT_EQ(SdfPathSet({a, b}), stage->GetLoadSet());
+  EXPECT_FALSE(streamer.update(priorities));
+  EXPECT_EQ(200u, streamer.loadedCost());
+
+  // raising the priority of c unloads b, which is now the least important payload
+  priorities = { {c, 5.0}, {b, 2.0}, {a, 3.0} };
+  EXPECT_TRUE(streamer.update(priorities));
+  EXPECT_EQ(SdfPathSet({a, c}), stage->GetLoadSet());
+
+  // lowering the budget unloads the payload that was least recently requested
+  streamer.setBudget(150);
+  EXPECT_TRUE(streamer.update({ {a, 1.0} }));
+  EXPECT_EQ(SdfPathSet({a}), stage->GetLoadSet());
+  EXPECT_EQ(100u, streamer.loadedCost());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that payloads nested within another payload are counted (and streamed) as part of the outermost payload
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_PayloadStreamer, nestedPayloads)
+{
+  UsdStageRefPtr inner = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(inner, SdfPath("/inner"));
+
+  UsdStageRefPtr asset = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(asset, SdfPath("/asset"));
+  UsdGeomXform::Define(asset, SdfPath("/asset/nested")).GetPrim().SetPayload(
+      SdfPayload(inner->GetRootLayer()->GetIdentifier(), SdfPath("/inner")));
+
+  UsdStageRefPtr world = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(world, a).GetPrim().SetPayload(SdfPayload(asset->GetRootLayer()->GetIdentifier(), SdfPath("/asset")));
+  UsdStageRefPtr stage = UsdStage::Open(world->GetRootLayer(), UsdStage::LoadNone);
+
+  PayloadStreamer streamer;
+  streamer.setCostEstimator([](const UsdPrim&) { return size_t(100); });
+  streamer.setBudget(1000);
+  streamer.setStage(stage);
+
+  // the nested payload is loaded along with its parent, and is not counted separately
+  const SdfPath nested("/world/a/nested");
+  EXPECT_TRUE(streamer.update({ {a, 1.0}, {nested, 2.0} }));
+  EXPECT_TRUE(stage->GetPrimAtPath(nested).IsLoaded());
+  EXPECT_EQ(100u, streamer.loadedCost());
+  EXPECT_EQ(0u, streamer.cost(nested));
+  EXPECT_FALSE(streamer.update({ {a, 1.0}, {nested, 2.0} }));
+
+  // the same applies to nested payloads that were loaded by someone else
+  PayloadStreamer other;
+  other.setCostEstimator([](const UsdPrim&) { return size_t(100); });
+  other.setStage(stage);
+  EXPECT_EQ(100u, other.loadedCost());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that the default cost estimate includes the default mesh data, but not time samples
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_PayloadStreamer, estimateCost)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(stage, SdfPath("/empty"));
+  UsdGeomMesh::Define(stage, SdfPath("/empty/mesh"));
+  const size_t emptyCost = PayloadStreamer::estimateCost(stage->GetPrimAtPath(SdfPath("/empty")));
+
+  UsdGeomXform::Define(stage, SdfPath("/static"));
+  UsdGeomMesh mesh = UsdGeomMesh::Define(stage, SdfPath("/static/mesh"));
+  mesh.GetPointsAttr().Set(VtArray<GfVec3f>(4, GfVec3f(0.0f)));
+  mesh.GetFaceVertexIndicesAttr().Set(VtArray<int>(6, 0));
+  EXPECT_EQ(emptyCost + 4 * sizeof(GfVec3f) + 6 * sizeof(int),
+            PayloadStreamer::estimateCost(stage->GetPrimAtPath(SdfPath("/static"))));
+
+  UsdGeomXform::Define(stage, SdfPath("/animated"));
+  mesh = UsdGeomMesh::Define(stage, SdfPath("/animated/mesh"));
+  mesh.GetPointsAttr().Set(VtArray<GfVec3f>(4, GfVec3f(0.0f)), UsdTimeCode(1.0));
+  EXPECT_EQ(emptyCost, PayloadStreamer::estimateCost(stage->GetPrimAtPath(SdfPath("/animated"))));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that with payloads of mixed costs, repeated rounds settle on a load set within the budget (a payload
+///         unloaded for being too large must not be loaded again because the average cost suggests it will fit)
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_PayloadStreamer, mixedCostsConverge)
+{
+  UsdStageRefPtr asset;
+  UsdStageRefPtr stage = constructStageWithPayloads(asset);
+
+  PayloadStreamer streamer;
+  streamer.setCostEstimator([](const UsdPrim& prim) { return prim.GetPath() == c ? size_t(90) : size_t(10); });
+  streamer.setBudget(100);
+  streamer.setStage(stage);
+
+  const PayloadStreamer::Priorities priorities = { {a, 3.0}, {b, 2.0}, {c, 1.0} };
+  int rounds = 0;
+  while(streamer.update(priorities))
+  {
+    ASSERT_LT(++rounds, 10);
+  }
+  EXPECT_EQ(SdfPathSet({a, b}), stage->GetLoadSet());
+  EXPECT_EQ(20u, streamer.loadedCost());
+
+  // and stays there
+  for(int i = 0; i < 3; ++i)
+  {
+    EXPECT_FALSE(streamer.update(priorities));
+    EXPECT_EQ(SdfPathSet({a, b}), stage->GetLoadSet());
+  }
+
+  // a payload that has been measured is loaded as soon as there is room for it
+  streamer.setBudget(110);
+  EXPECT_TRUE(streamer.update(priorities));
+  EXPECT_EQ(SdfPathSet({a, b, c}), stage->GetLoadSet());
+  EXPECT_EQ(110u, streamer.loadedCost());
+  EXPECT_FALSE(streamer.update(priorities));
+}
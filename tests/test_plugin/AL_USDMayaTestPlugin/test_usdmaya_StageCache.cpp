@@ -0,0 +1,98 @@
+//
+// Copyright 2017 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.//
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+
+#include "AL/usdmaya/StageCache.h"
+
+#include "pxr/usd/sdf/layer.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usd/stageCacheContext.h"
+#include "pxr/usd/usdGeom/xform.h"
+
+using namespace AL::usdmaya;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that the layers of the cached stages are kept alive across a scene change when a budget is set
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_StageCache, layerCacheRetainsLayers)
+{
+  const std::string filePath = "/tmp/AL_USDMayaTests_layerCache.usda";
+  {
+    UsdStageRefPtr stage = UsdStage::CreateNew(filePath);
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    stage->Save();
+  }
+
+  const size_t previousBudget = StageCache::layerCacheBudget();
+  StageCache::clearLayerCache();
+  StageCache::setLayerCacheBudget(size_t(1) << 30);
+  {
+    UsdStageCacheContext ctx(StageCache::Get());
+    UsdStageRefPtr stage = UsdStage::Open(filePath);
+    ASSERT_TRUE(stage);
+  }
+
+  StageCache::onSceneChange();
+  EXPECT_TRUE(StageCache::Get().GetAllStages().empty());
+  EXPECT_TRUE(StageCache::layerCacheSize() > 0);
+  EXPECT_TRUE(SdfLayer::Find(filePath));
+
+  // a budget of zero should release the retained layers
+  StageCache::setLayerCacheBudget(0);
+  EXPECT_EQ(0u, StageCache::layerCacheSize());
+  EXPECT_FALSE(SdfLayer::Find(filePath));
+
+  StageCache::setLayerCacheBudget(previousBudget);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Test that a layer modified on disk while its stage was open is not retained with stale contents
+//----------------------------------------------------------------------------------------------------------------------
+TEST(usdmaya_StageCache, layerCacheReloadsModifiedLayers)
+{
+  const std::string filePath = "/tmp/AL_USDMayaTests_layerCacheModified.usda";
+  {
+    UsdStageRefPtr stage = UsdStage::CreateNew(filePath);
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    stage->Save();
+  }
+
+  const size_t previousBudget = StageCache::layerCacheBudget();
+  StageCache::clearLayerCache();
+  StageCache::setLayerCacheBudget(size_t(1) << 30);
+  {
+    UsdStageCacheContext ctx(StageCache::Get());
+    UsdStageRefPtr stage = UsdStage::Open(filePath);
+    ASSERT_TRUE(stage);
+  }
+
+  // modify the file behind the back of the open layer
+  {
+    SdfLayerRefPtr modified = SdfLayer::CreateAnonymous(".usda");
+    UsdStageRefPtr stage = UsdStage::Open(modified);
+    UsdGeomXform::Define(stage, SdfPath("/modified"));
+    ASSERT_TRUE(modified->Export(filePath));
+  }
+
+  StageCache::onSceneChange();
+  SdfLayerHandle retained = SdfLayer::Find(filePath);
+  ASSERT_TRUE(retained);
+  EXPECT_TRUE(retained->GetPrimAtPath(SdfPath("/modified")));
+  EXPECT_FALSE(retained->GetPrimAtPath(SdfPath("/root")));
+
+  StageCache::clearLayerCache();
+  StageCache::setLayerCacheBudget(previousBudget);
+}
@@ -23,7 +23,11 @@
 #include "maya/MFnTransform.h"
 #include "maya/MFnCamera.h"
 #include "maya/MFileIO.h"
+#include "maya/MFnReference.h"
+#include "maya/MDagModifier.h"
 #include "maya/MItDag.h"
+#include "maya/MObjectHandle.h"
+#include "AL/usdmaya/DeferredReferences.h"
 #include "AL/usdmaya/nodes/Transform.h"
 #include "AL/usdmaya/fileio/translators/DgNodeTranslator.h"
 #include "AL/usd/schemas/MayaReference.h"
@@ -32,6 +36,8 @@ IGNORE_USD_WARNINGS_PUSH
 #include <pxr/usd/usd/attribute.h>
 IGNORE_USD_WARNINGS_POP
 
+#include <unordered_map>
+
 #if 0 || AL_ENABLE_TRACE
 # define Trace(X) std::cout << X << std::endl;
 #else
@@ -66,6 +72,13 @@ MStatus MayaReference::import(const UsdPrim& prim, MObject& parent)
   return status;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void MayaReference::importBatch(const std::vector<UsdPrim>& prims, std::vector<MObject>& parents, std::vector<MStatus>& results)
+{
+  Trace("MayaReferenceLogic::importBatch");
+  m_mayaReferenceLogic.LoadMayaReferences(prims, parents, results);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 MStatus MayaReference::tearDown(const SdfPath& prim)
 {
@@ -74,6 +87,7 @@ MStatus MayaReference::tearDown(const SdfPath& prim)
   MObjectHandle handle;
   context()->getTransform(prim, handle);
   mayaObject = handle.object();
+  DeferredReferences::untrack(mayaObject);
   m_mayaReferenceLogic.UnloadMayaReference(mayaObject);
   return MS::kSuccess;
 }
@@ -161,7 +175,15 @@ MStatus MayaReferenceLogic::update(const UsdPrim& prim, MObject parent) const
             }
           }
           
-          // modify active status
+          // modify active status (a deferred reference is only loaded when it is next needed)
+          if(DeferredReferences::isTracked(parent))
+          {
+            if(!prim.IsActive())
+            {
+              DeferredReferences::unload(parent);
+            }
+          }
+          else
           if(!prim.IsActive())
           {
             MString s = MFileIO::unloadReferenceByNode(temp, &status);
@@ -178,124 +200,244 @@ MStatus MayaReferenceLogic::update(const UsdPrim& prim, MObject parent) const
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-MStatus MayaReferenceLogic::LoadMayaReference(const UsdPrim& prim, MObject& parent) const
+bool MayaReferenceLogic::resolveReference(const UsdPrim& prim, MString& referencePath, MString& rigNamespace) const
 {
-  Trace("MayaReferenceLogic::LoadMayaReference");
-  MFnDagNode fn;
   // Check to see if we have a valid Maya reference attribute
   UsdAttribute mayaReferenceAttribute = prim.GetAttribute(m_referenceName);
 
   SdfAssetPath mayaReferenceAssetPath;
   mayaReferenceAttribute.Get(&mayaReferenceAssetPath);
-  MString mayaReferencePath(mayaReferenceAssetPath.GetResolvedPath().c_str());
+  referencePath = mayaReferenceAssetPath.GetResolvedPath().c_str();
 
   //The resolved path is empty if the maya reference is a full path.
-  if(!mayaReferencePath.length())
+  if(!referencePath.length())
   {
-    mayaReferencePath = mayaReferenceAssetPath.GetAssetPath().c_str();
+    referencePath = mayaReferenceAssetPath.GetAssetPath().c_str();
   }
 
   //If the path is still empty return, there is no reference to import
-  if(!mayaReferencePath.length())
+  if(!referencePath.length())
   {
-    return MS::kFailure;
+    return false;
   }
 
-  // Load file reference
-  std::string rigNamespace;
+  std::string ns;
   if(UsdAttribute rigNamespaceAttribute = prim.GetAttribute(m_namespaceName))
   {
-    rigNamespaceAttribute.Get<std::string>(&rigNamespace);
+    rigNamespaceAttribute.Get<std::string>(&ns);
   }
+  rigNamespace = MString(ns.c_str(), ns.size());
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus MayaReferenceLogic::LoadMayaReference(const UsdPrim& prim, MObject& parent) const
+{
+  Trace("MayaReferenceLogic::LoadMayaReference");
+  std::vector<UsdPrim> prims(1, prim);
+  std::vector<MObject> parents(1, parent);
+  std::vector<MStatus> results;
+  LoadMayaReferences(prims, parents, results);
+  return results[0];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MayaReferenceLogic::LoadMayaReferences(
+    const std::vector<UsdPrim>& prims,
+    std::vector<MObject>& parents,
+    std::vector<MStatus>& results) const
+{
+  Trace("MayaReferenceLogic::LoadMayaReferences");
+  results.assign(prims.size(), MStatus(MS::kFailure));
+
+  struct PendingReference
+  {
+    size_t index;
+    MObject reference;
+    MObject tempGroup;
+    MString referenceName;
+  };
+  std::vector<PendingReference> pending;
+  pending.reserve(prims.size());
+
+  // a prim may be handed to us more than once, in which case it shares the result of the first occurrence.
+  std::unordered_map<SdfPath, size_t, SdfPath::Hash> firstOccurrence;
+  std::vector<std::pair<size_t, size_t> > duplicates;
+
+  // Create all of the references unloaded, each into its own temp-group.
+  for(size_t i = 0, n = prims.size(); i < n; ++i)
+  {
+    auto inserted = firstOccurrence.emplace(prims[i].GetPath(), i);
+    if(!inserted.second)
+    {
+      duplicates.emplace_back(i, inserted.first->second);
+      continue;
+    }
+
+    MString mayaReferencePath, rigNamespace;
+    if(!resolveReference(prims[i], mayaReferencePath, rigNamespace))
+    {
+      continue;
+    }
+
+    MString tempNodeForReference = MString("__temp_reference_group_") + rigNamespace;
+    MStringArray createdNodes;
+    MString referenceCommand = MString("file"
+                                       " -reference"
+                                       " -returnNewNodes"
+                                       " -groupReference"
+                                       " -deferReference true"
+                                       " -mergeNamespacesOnClash false"
+                                       " -ignoreVersion"
+                                       " -options \"v=0;\"") +
+                               MString(" -groupName \"") + tempNodeForReference +
+                               MString("\" -namespace \"") + rigNamespace +
+                               MString("\" \"") + mayaReferencePath + MString("\"");
+    if(!MGlobal::executeCommand(referenceCommand, createdNodes))
+    {
+      MGlobal::displayError(MString("failed to create maya reference: ") + referenceCommand);
+      continue;
+    }
+    if(createdNodes.length() != 2)
+    {
+      MGlobal::displayError(MString("Expected to get exactly 2 results from the reference command: ") + referenceCommand);
+      continue;
+    }
 
-  //Create a temp-group which will be used to import the reference contents into.
-  MString rigNamespaceM(rigNamespace.c_str(), rigNamespace.size());
-  MString tempNodeForReference = MString("__temp_reference_group_") + rigNamespaceM;
-
-  // Create unloaded reference
-  MStringArray createdNodes;
-  MString referenceCommand = MString("file"
-                                     " -reference"
-                                     " -returnNewNodes"
-                                     " -groupReference"
-                                     " -deferReference true"
-                                     " -mergeNamespacesOnClash false"
-                                     " -ignoreVersion"
-                                     " -options \"v=0;\"") +
-                             MString(" -groupName \"") + tempNodeForReference +
-                             MString("\" -namespace \"") + rigNamespaceM +
-                             MString("\" \"") + mayaReferencePath + MString("\"");
-  MStatus status = MGlobal::executeCommand(referenceCommand, createdNodes);
-  AL_MAYA_CHECK_ERROR(status, MString("failed to create maya reference: ") + referenceCommand);
-  if(createdNodes.length() != 2){
-    MGlobal::displayError(MString("Expected to get exactly 2 results from the reference command: ") + referenceCommand);
-    return MS::kFailure;
+    PendingReference ref;
+    ref.index = i;
+    ref.referenceName = createdNodes[0];
+    MSelectionList selectionList;
+    selectionList.add(createdNodes[0]);
+    selectionList.add(createdNodes[1]);
+    selectionList.getDependNode(0, ref.reference);
+    selectionList.getDependNode(1, ref.tempGroup);
+    pending.push_back(ref);
   }
-  // Retrieve created nodes
-  MString refNode = createdNodes[0];
-  tempNodeForReference = createdNodes[1];
-
-  MSelectionList selectionList;
-  selectionList.add(refNode);
-  selectionList.add(tempNodeForReference);
-
-  MObject referenceObject;
-  MObject tempReferenceGroupObject;
-  selectionList.getDependNode(0, referenceObject);
-  selectionList.getDependNode(1, tempReferenceGroupObject);
-
-  // Now load the reference to properly trigger the kAfterReferenceLoad callback
-  referenceCommand = MString("file -loadReference \"") + refNode + MString("\"");
-  status = MGlobal::executeCommand(referenceCommand);
-  AL_MAYA_CHECK_ERROR(status, MString("failed to load reference: ") + referenceCommand);
-
-  //Iterate through the group which houses all the items brought in by the reference.
-  MFnDagNode tempReferenceGroupDag(tempReferenceGroupObject);
-  
-  MDagPath path;
-  MFnDagNode parentDag(parent, &status);
-  AL_MAYA_CHECK_ERROR(status, "failed to attach function set to parent transform for reference.");
-  parentDag.getPath(path);
 
-  //Loop through the children reparenting to the correct parent node
-  while(tempReferenceGroupDag.childCount(&status))
+  // Now load all of the references in a single MEL evaluation (which still triggers the kAfterReferenceLoad callback
+  // for each of them). Each load is wrapped in a catch, so that one failure does not stop the remaining references
+  // from loading, and each one is checked afterwards. When deferred loading is enabled, the references are left
+  // unloaded until they are needed.
+  const bool deferred = DeferredReferences::enabled();
+  if(!pending.empty() && !deferred)
   {
-    MObject child = tempReferenceGroupDag.child(0, &status);
-    AL_MAYA_CHECK_ERROR(status, "Failed to locate child on temp transform node");
-    MDagPath p;
-    MFnDagNode a(child);
-    a.getPath(p);
-    parentDag.addChild(child, MFnDagNode::kNextPos, false);//, MFnDagNode::kNextPos, /*keepExistingParents=*/false);
-    AL_MAYA_CHECK_ERROR(status, "Failed to add child to prim path node");
+    MString loadCommand;
+    for(const PendingReference& ref : pending)
+    {
+      loadCommand += MString("catch(`file -loadReference \"") + ref.referenceName + MString("\"`);\n");
+    }
+    MGlobal::executeCommand(loadCommand);
   }
 
-  // Connect parent node message to reference node associatedNode
+  // A reference that could not be loaded (or attached to its prim) is removed along with its temp-group, so that a
+  // failed import does not leave anything behind in the scene.
+  auto discard = [](const PendingReference& ref)
+  {
+    MObjectHandle tempGroup(ref.tempGroup);
+    if(!MGlobal::executeCommand(MString("file -removeReference -referenceNode \"") + ref.referenceName + MString("\"")))
+    {
+      MGlobal::displayError(MString("failed to remove maya reference: ") + ref.referenceName);
+    }
+    if(tempGroup.isValid())
+    {
+      MDGModifier modifier;
+      modifier.deleteNode(tempGroup.object());
+      modifier.doIt();
+    }
+  };
+
+  // Reparent the contents of every temp-group, connect the parent message plugs to the reference nodes, and delete the
+  // temp-groups, all through the one modifier.
+  MDagModifier modifier;
+  std::vector<const PendingReference*> completed;
+  completed.reserve(pending.size());
+  for(const PendingReference& ref : pending)
+  {
+    MStatus status;
+    MFnReference fnReference(ref.reference, &status);
+    if(!status || (!deferred && !fnReference.isLoaded()))
+    {
+      MGlobal::displayError(MString("failed to load reference: ") + ref.referenceName);
+      discard(ref);
+      continue;
+    }
+
+    MObject& parent = parents[ref.index];
+    MFnDagNode parentDag(parent, &status);
+    if(!status)
+    {
+      MGlobal::displayError("failed to attach function set to parent transform for reference.");
+      discard(ref);
+      continue;
+    }
+
+    if(deferred)
+    {
+      // An unloaded reference has nothing to reparent yet, so the group is kept beneath the prim transform, and the
+      // contents of the reference will be placed within it whenever it is loaded.
+      status = modifier.reparentNode(ref.tempGroup, parent);
+      AL_MAYA_CHECK_ERROR2(status, "Failed to add reference group to prim path node");
+      modifier.renameNode(ref.tempGroup, "mayaReference");
+    }
+    else
+    {
+      //Loop through the children reparenting to the correct parent node
+      MFnDagNode tempReferenceGroupDag(ref.tempGroup);
+      for(uint32_t c = 0, nc = tempReferenceGroupDag.childCount(); c < nc; ++c)
+      {
+        status = modifier.reparentNode(tempReferenceGroupDag.child(c), parent);
+        AL_MAYA_CHECK_ERROR2(status, "Failed to add child to prim path node");
+      }
+    }
 
-  MFnDependencyNode refDependNode(referenceObject);
+    MPlug srcPlug = parentDag.findPlug("message");
+    // This message attribute is used to connect specific nodes that may be associated with this reference (i.e. group,
+    // locator, annotation). Use of this connection indicates that the associated nodes have the same lifespan as the
+    // reference, and will be deleted along with the reference if it is removed.
+    MPlug destArrayPlug = fnReference.findPlug("associatedNode");
+    MPlug destPlug = destArrayPlug.elementByLogicalIndex(destArrayPlug.numElements());
+    if(!srcPlug.isNull() && !destPlug.isNull())
+    {
+      status = modifier.connect(srcPlug, destPlug);
+      AL_MAYA_CHECK_ERROR2(status, MString("failed to connect maya reference plug: ") + status.errorString());
+    }
 
-  MDGModifier dgMod;
-  MPlug srcPlug = parentDag.findPlug("message");
-  // This message attribute is used to connect specific nodes that may be associated with this reference (i.e. group,
-  // locator, annotation). Use of this connection indicates that the associated nodes have the same lifespan as the
-  // reference, and will be deleted along with the reference if it is removed.
-  MPlug destArrayPlug = refDependNode.findPlug("associatedNode");
+    //Delete the temporary node once its children have been moved
+    if(!deferred)
+    {
+      modifier.deleteNode(ref.tempGroup);
+    }
+    completed.push_back(&ref);
+  }
 
-  // make sure we- resize the array before making any connections
-  uint32_t len = destArrayPlug.numElements();
-  destArrayPlug.setNumElements(len + 1);
-  MPlug destPlug = destArrayPlug.elementByLogicalIndex(len);
-  if (!srcPlug.isNull() && !destPlug.isNull())
+  if(!completed.empty())
   {
-    MStatus status = dgMod.connect(srcPlug, destPlug);
-    AL_MAYA_CHECK_ERROR(status, MString("failed to connect maya reference plug: ") + status.errorString());
-    status = dgMod.doIt();
-    AL_MAYA_CHECK_ERROR(status, MString("failed to execute connect maya reference plug: ") + status.errorString());
+    MStatus status = modifier.doIt();
+    if(!status)
+    {
+      MGlobal::displayError(MString("failed to reparent maya references: ") + status.errorString());
+      modifier.undoIt();
+      for(const PendingReference* ref : completed)
+      {
+        discard(*ref);
+      }
+      return;
+    }
+    for(const PendingReference* ref : completed)
+    {
+      if(deferred)
+      {
+        DeferredReferences::track(parents[ref->index], ref->reference);
+      }
+      results[ref->index] = MS::kSuccess;
+    }
   }
 
-  //Delete the temporary node
-  MGlobal::deleteNode(tempReferenceGroupObject);
-
-  return MS::kSuccess;
+  for(const auto& duplicate : duplicates)
+  {
+    results[duplicate.first] = results[duplicate.second];
+  }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
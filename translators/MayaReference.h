@@ -22,6 +22,8 @@ IGNORE_USD_WARNINGS_PUSH
 #include "pxr/usd/usd/stage.h"
 IGNORE_USD_WARNINGS_POP
 
+#include <vector>
+
 namespace AL {
 namespace usdmaya {
 namespace fileio {
@@ -34,10 +36,20 @@ class MayaReferenceLogic
 {
 public:
   MStatus LoadMayaReference(const UsdPrim& prim, MObject& parent) const;
+
+  /// \brief  Loads the maya references for many prims in one pass. All references are first created unloaded, then
+  ///         loaded with a single MEL evaluation, and finally the referenced nodes of all prims are reparented (and
+  ///         the temporary groups deleted) through a single MDagModifier.
+  /// \param  prims the ALMayaReference prims to load
+  /// \param  parents the transform of each prim, under which the referenced nodes will be parented
+  /// \param  results returns the load status of each prim
+  void LoadMayaReferences(const std::vector<UsdPrim>& prims, std::vector<MObject>& parents, std::vector<MStatus>& results) const;
+
   MStatus UnloadMayaReference(MObject& parent) const;
   MStatus update(const UsdPrim& prim, MObject parent) const;
 
 private:
+  bool resolveReference(const UsdPrim& prim, MString& referencePath, MString& rigNamespace) const;
   static const TfToken m_namespaceName;
   static const TfToken m_referenceName;
 };
@@ -53,6 +65,9 @@ public:
 
   MStatus initialize() override;
   MStatus import(const UsdPrim& prim, MObject& parent) override;
+  void importBatch(const std::vector<UsdPrim>& prims, std::vector<MObject>& parents, std::vector<MStatus>& results) override;
+  bool supportsBatchImport() const override
+    { return true; }
   MStatus tearDown(const SdfPath& path) override;
   MStatus update(const UsdPrim& path) override;
   bool supportsUpdate() const override 